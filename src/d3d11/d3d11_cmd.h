@@ -2,6 +2,10 @@
 
 #include "d3d11_include.h"
 
+#include "../dxvk/dxvk_buffer.h"
+#include "../dxvk/dxvk_data.h"
+#include "../dxvk/dxvk_image.h"
+
 namespace dxvk {
 
   /**
@@ -13,6 +17,10 @@ namespace dxvk {
   enum class D3D11CmdType {
     DrawIndirect,
     DrawIndirectIndexed,
+    BindConstantBuffers,
+    BindShaderResources,
+    UpdateBuffers,
+    UpdateImages,
   };
 
 
@@ -40,4 +48,73 @@ namespace dxvk {
     uint32_t            stride;
   };
 
-}
\ No newline at end of file
+
+
+  /**
+   * \brief Constant buffer binding command data
+   * 
+   * Stores buffer slices for a range of
+   * consecutive constant buffer slots.
+   */
+  struct D3D11CmdBindConstantBuffersData : public D3D11CmdData {
+    constexpr static uint32_t MaxCount = 16;
+
+    uint32_t            slot;
+    uint32_t            count;
+    std::array<DxvkBufferSlice, MaxCount> slices;
+  };
+
+
+  /**
+   * \brief Shader resource binding command data
+   * 
+   * Stores views for a range of consecutive
+   * shader resource slots. Either view may
+   * be \c nullptr.
+   */
+  struct D3D11CmdBindShaderResourcesData : public D3D11CmdData {
+    constexpr static uint32_t MaxCount = 16;
+
+    uint32_t            slot;
+    uint32_t            count;
+    std::array<Rc<DxvkImageView>,  MaxCount> imageViews;
+    std::array<Rc<DxvkBufferView>, MaxCount> bufferViews;
+  };
+
+
+
+  /**
+   * \brief Buffer update command data
+   * 
+   * Stores destination buffer slices and the
+   * corresponding source data for a batch of
+   * small buffer updates.
+   */
+  struct D3D11CmdUpdateBuffersData : public D3D11CmdData {
+    constexpr static uint32_t MaxCount = 16;
+
+    uint32_t            count;
+    std::array<DxvkBufferSlice, MaxCount> dstSlices;
+    std::array<DxvkDataSlice,   MaxCount> srcSlices;
+  };
+
+
+  /**
+   * \brief Image update command data
+   * 
+   * Stores destination image regions and the
+   * corresponding staging buffer slices for a
+   * batch of color image updates.
+   */
+  struct D3D11CmdUpdateImagesData : public D3D11CmdData {
+    constexpr static uint32_t MaxCount = 16;
+
+    uint32_t            count;
+    std::array<Rc<DxvkImage>,            MaxCount> dstImages;
+    std::array<VkImageSubresourceLayers, MaxCount> dstLayers;
+    std::array<VkOffset3D,               MaxCount> dstOffsets;
+    std::array<VkExtent3D,               MaxCount> dstExtents;
+    std::array<DxvkBufferSlice,          MaxCount> srcSlices;
+  };
+
+}
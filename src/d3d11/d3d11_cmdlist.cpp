@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "d3d11_cmdlist.h"
 #include "d3d11_device.h"
 #include "d3d11_buffer.h"
@@ -51,6 +53,42 @@ namespace dxvk {
   }
 
 
+  void D3D11CommandList::Finalize() {
+    if (m_chunks.size() > 1) {
+      DxvkCsChunkRef chunk = m_parent->AllocCsChunk(DxvkCsChunkFlags());
+
+      auto cmd = [
+        cChunks = std::move(m_chunks)
+      ] (DxvkContext* ctx) {
+        for (const auto& entry : cChunks)
+          entry->executeAll(ctx);
+      };
+
+      chunk->push(cmd);
+
+      m_chunks.clear();
+      m_chunks.push_back(std::move(chunk));
+    }
+
+    // Mapping the same resource multiple times is common,
+    // but we only need to track each resource once
+    std::sort(m_resources.begin(), m_resources.end(),
+      [] (const D3D11ResourceRef& a, const D3D11ResourceRef& b) {
+        if (a.Get() != b.Get())
+          return a.Get() < b.Get();
+        return a.GetSubresource() < b.GetSubresource();
+      });
+
+    auto end = std::unique(m_resources.begin(), m_resources.end(),
+      [] (const D3D11ResourceRef& a, const D3D11ResourceRef& b) {
+        return a.Get() == b.Get()
+            && a.GetSubresource() == b.GetSubresource();
+      });
+
+    m_resources.erase(end, m_resources.end());
+  }
+
+
   void D3D11CommandList::EmitToCommandList(ID3D11CommandList* pCommandList) {
     auto cmdList = static_cast<D3D11CommandList*>(pCommandList);
     
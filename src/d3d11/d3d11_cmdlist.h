@@ -26,6 +26,17 @@ namespace dxvk {
     void AddQuery(
             D3D11Query*         pQuery);
     
+    /**
+     * \brief Finalizes command list
+     *
+     * Called once recording is complete. Wraps all chunks
+     * into a single chunk that plays them back, so that
+     * executing the command list only has to submit one
+     * chunk reference, and removes duplicate entries from
+     * the list of tracked resources.
+     */
+    void Finalize();
+
     void EmitToCommandList(
             ID3D11CommandList*  pCommandList);
     
@@ -22,7 +22,8 @@ namespace dxvk {
     m_annotation(this),
     m_csFlags   (CsFlags),
     m_csChunk   (AllocCsChunk()),
-    m_cmdData   (nullptr) {
+    m_cmdData   (nullptr),
+    m_redundantBindings(0) {
 
   }
   
@@ -1142,6 +1143,7 @@ namespace dxvk {
   
   void STDMETHODCALLTYPE D3D11DeviceContext::DrawAuto() {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
 
     D3D11Buffer* buffer = m_state.ia.vertexBuffers[0].buffer.ptr();
 
@@ -1166,6 +1168,7 @@ namespace dxvk {
           UINT            VertexCount,
           UINT            StartVertexLocation) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
 
     EmitCs([=] (DxvkContext* ctx) {
       ctx->draw(
@@ -1180,6 +1183,7 @@ namespace dxvk {
           UINT            StartIndexLocation,
           INT             BaseVertexLocation) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->drawIndexed(
@@ -1196,6 +1200,7 @@ namespace dxvk {
           UINT            StartVertexLocation,
           UINT            StartInstanceLocation) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->draw(
@@ -1214,6 +1219,7 @@ namespace dxvk {
           INT             BaseVertexLocation,
           UINT            StartInstanceLocation) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->drawIndexed(
@@ -1230,6 +1236,7 @@ namespace dxvk {
           ID3D11Buffer*   pBufferForArgs,
           UINT            AlignedByteOffsetForArgs) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
     SetDrawBuffers(pBufferForArgs, nullptr);
 
     if (!ValidateDrawBufferSize(pBufferForArgs, AlignedByteOffsetForArgs, sizeof(VkDrawIndexedIndirectCommand)))
@@ -1264,6 +1271,7 @@ namespace dxvk {
           ID3D11Buffer*   pBufferForArgs,
           UINT            AlignedByteOffsetForArgs) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
     SetDrawBuffers(pBufferForArgs, nullptr);
 
     if (!ValidateDrawBufferSize(pBufferForArgs, AlignedByteOffsetForArgs, sizeof(VkDrawIndirectCommand)))
@@ -1299,6 +1307,7 @@ namespace dxvk {
           UINT            ThreadGroupCountY,
           UINT            ThreadGroupCountZ) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->dispatch(
@@ -1313,6 +1322,7 @@ namespace dxvk {
           ID3D11Buffer*   pBufferForArgs,
           UINT            AlignedByteOffsetForArgs) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Draw);
     SetDrawBuffers(pBufferForArgs, nullptr);
     
     if (!ValidateDrawBufferSize(pBufferForArgs, AlignedByteOffsetForArgs, sizeof(VkDispatchIndirectCommand)))
@@ -1327,6 +1337,7 @@ namespace dxvk {
   
   void STDMETHODCALLTYPE D3D11DeviceContext::IASetInputLayout(ID3D11InputLayout* pInputLayout) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
     
     auto inputLayout = static_cast<D3D11InputLayout*>(pInputLayout);
     
@@ -1349,6 +1360,7 @@ namespace dxvk {
   
   void STDMETHODCALLTYPE D3D11DeviceContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
     
     if (m_state.ia.primitiveTopology != Topology) {
       m_state.ia.primitiveTopology = Topology;
@@ -1364,6 +1376,7 @@ namespace dxvk {
     const UINT*                             pStrides,
     const UINT*                             pOffsets) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
     
     for (uint32_t i = 0; i < NumBuffers; i++) {
       auto newBuffer = static_cast<D3D11Buffer*>(ppVertexBuffers[i]);
@@ -1390,6 +1403,7 @@ namespace dxvk {
           DXGI_FORMAT                       Format,
           UINT                              Offset) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
     
     auto newBuffer = static_cast<D3D11Buffer*>(pIndexBuffer);
     bool needsUpdate = m_state.ia.indexBuffer.buffer != newBuffer;
@@ -2263,6 +2277,7 @@ namespace dxvk {
           ID3D11UnorderedAccessView* const* ppUnorderedAccessViews,
     const UINT*                             pUAVInitialCounts) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (TestRtvUavHazards(0, nullptr, NumUAVs, ppUnorderedAccessViews))
       return;
@@ -2413,6 +2428,7 @@ namespace dxvk {
           ID3D11UnorderedAccessView* const* ppUnorderedAccessViews,
     const UINT*                             pUAVInitialCounts) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (TestRtvUavHazards(NumRTVs, ppRenderTargetViews, NumUAVs, ppUnorderedAccessViews))
       return;
@@ -2494,6 +2510,7 @@ namespace dxvk {
     const FLOAT                             BlendFactor[4],
           UINT                              SampleMask) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
     
     auto blendState = static_cast<D3D11BlendState*>(pBlendState);
     
@@ -2518,6 +2535,7 @@ namespace dxvk {
           ID3D11DepthStencilState*          pDepthStencilState,
           UINT                              StencilRef) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
     
     auto depthStencilState = static_cast<D3D11DepthStencilState*>(pDepthStencilState);
     
@@ -2609,6 +2627,7 @@ namespace dxvk {
   
   void STDMETHODCALLTYPE D3D11DeviceContext::RSSetState(ID3D11RasterizerState* pRasterizerState) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
     
     auto rasterizerState = static_cast<D3D11RasterizerState*>(pRasterizerState);
     
@@ -2638,6 +2657,7 @@ namespace dxvk {
           UINT                              NumViewports,
     const D3D11_VIEWPORT*                   pViewports) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(NumViewports > m_state.rs.viewports.size()))
       return;
@@ -2667,6 +2687,7 @@ namespace dxvk {
           UINT                              NumRects,
     const D3D11_RECT*                       pRects) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(NumRects > m_state.rs.scissors.size()))
       return;
@@ -3124,6 +3145,8 @@ namespace dxvk {
   template<DxbcProgramType ShaderStage>
   void D3D11DeviceContext::BindShader(
     const D3D11CommonShader*    pShaderModule) {
+    DXVK_API_TIMER(m_apiTimers, Shaders);
+
     // Bind the shader and the ICB at once
     EmitCs([
       cSlice  = pShaderModule           != nullptr
@@ -3262,12 +3285,28 @@ namespace dxvk {
           D3D11Buffer*                      pBuffer,
           UINT                              Offset,
           UINT                              Length) {
-    EmitCs([
-      cSlotId      = Slot,
-      cBufferSlice = Length ? pBuffer->GetBufferSlice(16 * Offset, 16 * Length) : DxvkBufferSlice()
-    ] (DxvkContext* ctx) {
-      ctx->bindResourceBuffer(cSlotId, cBufferSlice);
-    });
+    // Consecutive slots are usually bound in one go, so
+    // append to the previous command if possible in order
+    // to reduce the number of commands sent to the CS thread
+    auto cmdData = static_cast<D3D11CmdBindConstantBuffersData*>(m_cmdData);
+
+    if (!cmdData || cmdData->type != D3D11CmdType::BindConstantBuffers
+     || cmdData->slot + cmdData->count != Slot
+     || cmdData->count == D3D11CmdBindConstantBuffersData::MaxCount) {
+      cmdData = EmitCsCmd<D3D11CmdBindConstantBuffersData>(
+        [] (DxvkContext* ctx, const D3D11CmdBindConstantBuffersData* data) {
+          for (uint32_t i = 0; i < data->count; i++)
+            ctx->bindResourceBuffer(data->slot + i, data->slices[i]);
+        });
+
+      cmdData->type  = D3D11CmdType::BindConstantBuffers;
+      cmdData->slot  = Slot;
+      cmdData->count = 0;
+    }
+
+    cmdData->slices[cmdData->count++] = Length
+      ? pBuffer->GetBufferSlice(16 * Offset, 16 * Length)
+      : DxvkBufferSlice();
   }
   
   
@@ -3286,13 +3325,28 @@ namespace dxvk {
   void D3D11DeviceContext::BindShaderResource(
           UINT                              Slot,
           D3D11ShaderResourceView*          pResource) {
-    EmitCs([
-      cSlotId     = Slot,
-      cImageView  = pResource != nullptr ? pResource->GetImageView()  : nullptr,
-      cBufferView = pResource != nullptr ? pResource->GetBufferView() : nullptr
-    ] (DxvkContext* ctx) {
-      ctx->bindResourceView(cSlotId, cImageView, cBufferView);
-    });
+    auto cmdData = static_cast<D3D11CmdBindShaderResourcesData*>(m_cmdData);
+
+    if (!cmdData || cmdData->type != D3D11CmdType::BindShaderResources
+     || cmdData->slot + cmdData->count != Slot
+     || cmdData->count == D3D11CmdBindShaderResourcesData::MaxCount) {
+      cmdData = EmitCsCmd<D3D11CmdBindShaderResourcesData>(
+        [] (DxvkContext* ctx, const D3D11CmdBindShaderResourcesData* data) {
+          for (uint32_t i = 0; i < data->count; i++)
+            ctx->bindResourceView(data->slot + i, data->imageViews[i], data->bufferViews[i]);
+        });
+
+      cmdData->type  = D3D11CmdType::BindShaderResources;
+      cmdData->slot  = Slot;
+      cmdData->count = 0;
+    }
+
+    uint32_t index = cmdData->count++;
+
+    if (pResource != nullptr) {
+      cmdData->imageViews [index] = pResource->GetImageView();
+      cmdData->bufferViews[index] = pResource->GetBufferView();
+    }
   }
   
   
@@ -3654,16 +3708,32 @@ namespace dxvk {
       DxvkDataSlice dataSlice = AllocUpdateBufferSlice(Length);
       std::memcpy(dataSlice.ptr(), pSrcData, Length);
 
-      EmitCs([
-        cDataBuffer   = std::move(dataSlice),
-        cBufferSlice  = std::move(bufferSlice)
-      ] (DxvkContext* ctx) {
-        ctx->updateBuffer(
-          cBufferSlice.buffer(),
-          cBufferSlice.offset(),
-          cBufferSlice.length(),
-          cDataBuffer.ptr());
-      });
+      // Applications often update several buffers in a row,
+      // so append to the previous update command if possible.
+      auto cmdData = static_cast<D3D11CmdUpdateBuffersData*>(m_cmdData);
+
+      if (!cmdData || cmdData->type != D3D11CmdType::UpdateBuffers
+       || cmdData->count == D3D11CmdUpdateBuffersData::MaxCount) {
+        cmdData = EmitCsCmd<D3D11CmdUpdateBuffersData>(
+          [] (DxvkContext* ctx, const D3D11CmdUpdateBuffersData* data) {
+            for (uint32_t i = 0; i < data->count; i++) {
+              const auto& dstSlice = data->dstSlices[i];
+
+              ctx->updateBuffer(
+                dstSlice.buffer(),
+                dstSlice.offset(),
+                dstSlice.length(),
+                data->srcSlices[i].ptr());
+            }
+          });
+
+        cmdData->type  = D3D11CmdType::UpdateBuffers;
+        cmdData->count = 0;
+      }
+
+      uint32_t index = cmdData->count++;
+      cmdData->dstSlices[index] = std::move(bufferSlice);
+      cmdData->srcSlices[index] = std::move(dataSlice);
     } else {
       // Otherwise, to avoid large data copies on the CS thread,
       // write directly to a staging buffer and dispatch a copy
@@ -3752,30 +3822,53 @@ namespace dxvk {
     uint32_t dstSubresource = D3D11CalcSubresource(pDstSubresource->mipLevel,
       pDstSubresource->arrayLayer, pDstTexture->Desc()->MipLevels);
 
-    if (dstIsImage) {
+    VkImageSubresourceLayers dstLayers = vk::makeSubresourceLayers(*pDstSubresource);
+
+    if (dstIsImage && dstLayers.aspectMask != (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
+      // Texture uploads tend to come in bursts as well, so
+      // append to the previous update command if possible.
+      auto cmdData = static_cast<D3D11CmdUpdateImagesData*>(m_cmdData);
+
+      if (!cmdData || cmdData->type != D3D11CmdType::UpdateImages
+       || cmdData->count == D3D11CmdUpdateImagesData::MaxCount) {
+        cmdData = EmitCsCmd<D3D11CmdUpdateImagesData>(
+          [] (DxvkContext* ctx, const D3D11CmdUpdateImagesData* data) {
+            for (uint32_t i = 0; i < data->count; i++) {
+              const auto& srcSlice = data->srcSlices[i];
+
+              ctx->copyBufferToImage(data->dstImages[i],
+                data->dstLayers[i], data->dstOffsets[i], data->dstExtents[i],
+                srcSlice.buffer(), srcSlice.offset(), 0, 0);
+            }
+          });
+
+        cmdData->type  = D3D11CmdType::UpdateImages;
+        cmdData->count = 0;
+      }
+
+      uint32_t index = cmdData->count++;
+      cmdData->dstImages[index]  = pDstTexture->GetImage();
+      cmdData->dstLayers[index]  = dstLayers;
+      cmdData->dstOffsets[index] = DstOffset;
+      cmdData->dstExtents[index] = DstExtent;
+      cmdData->srcSlices[index]  = std::move(StagingBuffer);
+    } else if (dstIsImage) {
       EmitCs([
         cDstImage         = pDstTexture->GetImage(),
-        cDstLayers        = vk::makeSubresourceLayers(*pDstSubresource),
+        cDstLayers        = dstLayers,
         cDstOffset        = DstOffset,
         cDstExtent        = DstExtent,
         cStagingSlice     = std::move(StagingBuffer),
         cPackedFormat     = pDstTexture->GetPackedFormat()
       ] (DxvkContext* ctx) {
-        if (cDstLayers.aspectMask != (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
-          ctx->copyBufferToImage(cDstImage,
-            cDstLayers, cDstOffset, cDstExtent,
-            cStagingSlice.buffer(),
-            cStagingSlice.offset(), 0, 0);
-        } else {
-          ctx->copyPackedBufferToDepthStencilImage(cDstImage, cDstLayers,
-            VkOffset2D { cDstOffset.x,     cDstOffset.y      },
-            VkExtent2D { cDstExtent.width, cDstExtent.height },
-            cStagingSlice.buffer(),
-            cStagingSlice.offset(),
-            VkOffset2D { 0, 0 },
-            VkExtent2D { cDstExtent.width, cDstExtent.height },
-            cPackedFormat);
-        }
+        ctx->copyPackedBufferToDepthStencilImage(cDstImage, cDstLayers,
+          VkOffset2D { cDstOffset.x,     cDstOffset.y      },
+          VkExtent2D { cDstExtent.width, cDstExtent.height },
+          cStagingSlice.buffer(),
+          cStagingSlice.offset(),
+          VkOffset2D { 0, 0 },
+          VkExtent2D { cDstExtent.width, cDstExtent.height },
+          cPackedFormat);
       });
     } else {
       // If the destination image is backed only by a buffer, we need to use
@@ -3858,6 +3951,8 @@ namespace dxvk {
           UINT                              StartSlot,
           UINT                              NumBuffers,
           ID3D11Buffer* const*              ppConstantBuffers) {
+    DXVK_API_TIMER(m_apiTimers, Constants);
+
     uint32_t slotId = computeConstantBufferBinding(ShaderStage, StartSlot);
     
     for (uint32_t i = 0; i < NumBuffers; i++) {
@@ -3876,6 +3971,8 @@ namespace dxvk {
         Bindings[StartSlot + i].constantBound  = constantCount;
         
         BindConstantBuffer(slotId + i, newBuffer, 0, constantCount);
+      } else {
+        m_redundantBindings += 1;
       }
     }
   }
@@ -3889,6 +3986,8 @@ namespace dxvk {
           ID3D11Buffer* const*              ppConstantBuffers,
     const UINT*                             pFirstConstant,
     const UINT*                             pNumConstants) {
+    DXVK_API_TIMER(m_apiTimers, Constants);
+
     uint32_t slotId = computeConstantBufferBinding(ShaderStage, StartSlot);
     
     for (uint32_t i = 0; i < NumBuffers; i++) {
@@ -3936,6 +4035,8 @@ namespace dxvk {
         Bindings[StartSlot + i].constantBound  = constantBound;
         
         BindConstantBuffer(slotId + i, newBuffer, constantOffset, constantBound);
+      } else {
+        m_redundantBindings += 1;
       }
     }
   }
@@ -3947,6 +4048,8 @@ namespace dxvk {
           UINT                              StartSlot,
           UINT                              NumSamplers,
           ID3D11SamplerState* const*        ppSamplers) {
+    DXVK_API_TIMER(m_apiTimers, State);
+
     uint32_t slotId = computeSamplerBinding(ShaderStage, StartSlot);
     
     for (uint32_t i = 0; i < NumSamplers; i++) {
@@ -3955,6 +4058,8 @@ namespace dxvk {
       if (Bindings[StartSlot + i] != sampler) {
         Bindings[StartSlot + i] = sampler;
         BindSampler(slotId + i, sampler);
+      } else {
+        m_redundantBindings += 1;
       }
     }
   }
@@ -3966,6 +4071,8 @@ namespace dxvk {
           UINT                              StartSlot,
           UINT                              NumResources,
           ID3D11ShaderResourceView* const*  ppResources) {
+    DXVK_API_TIMER(m_apiTimers, State);
+
     uint32_t slotId = computeSrvBinding(ShaderStage, StartSlot);
     
     for (uint32_t i = 0; i < NumResources; i++) {
@@ -3984,6 +4091,8 @@ namespace dxvk {
 
         Bindings.views[StartSlot + i] = resView;
         BindShaderResource(slotId + i, resView);
+      } else {
+        m_redundantBindings += 1;
       }
     }
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../dxvk/dxvk_adapter.h"
+#include "../dxvk/dxvk_api_timers.h"
 #include "../dxvk/dxvk_cs.h"
 #include "../dxvk/dxvk_device.h"
 #include "../dxvk/dxvk_staging.h"
@@ -690,6 +691,10 @@ namespace dxvk {
       return m_multithread.AcquireLock();
     }
 
+    DxvkApiTimers& GetApiTimers() {
+      return m_apiTimers;
+    }
+
   protected:
     
     D3D11DeviceContextExt       m_contextExt;
@@ -698,6 +703,8 @@ namespace dxvk {
     Rc<DxvkDevice>              m_device;
     Rc<DxvkDataBuffer>          m_updateBuffer;
 
+    DxvkApiTimers               m_apiTimers;
+
     DxvkStagingBuffer           m_staging;
    
     //has to be declared after m_device, as compiler initialize in order of declaration in the class
@@ -708,6 +715,8 @@ namespace dxvk {
     
     D3D11ContextState           m_state;
     D3D11CmdData*               m_cmdData;
+
+    uint64_t                    m_redundantBindings;
     
     void ApplyInputLayout();
     
@@ -805,6 +814,7 @@ namespace dxvk {
             UINT                              SrcDepthPitch,
             UINT                              CopyFlags) {
       D3D10DeviceLock lock = pContext->LockContext();
+      DXVK_API_TIMER(pContext->m_apiTimers, Resources);
 
       if (!pDstResource)
         return;
@@ -1064,6 +1074,15 @@ namespace dxvk {
       return data;
     }
     
+    void FlushStatCounters() {
+      m_apiTimers.flush(m_device.ptr());
+
+      if (m_redundantBindings) {
+        m_device->addStatCtr(DxvkStatCounter::ApiRedundantBindings, m_redundantBindings);
+        m_redundantBindings = 0;
+      }
+    }
+
     void FlushCsChunk() {
       if (likely(!m_csChunk->empty())) {
         EmitCsChunk(std::move(m_csChunk));
@@ -161,9 +161,12 @@ namespace dxvk {
           BOOL                RestoreDeferredContextState,
           ID3D11CommandList   **ppCommandList) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Submit);
 
     FinalizeQueries();
     FlushCsChunk();
+
+    m_commandList->Finalize();
     
     if (ppCommandList != nullptr)
       *ppCommandList = m_commandList.ref();
@@ -176,6 +179,8 @@ namespace dxvk {
     
     m_mappedResources.clear();
     ResetStagingBuffer();
+
+    FlushStatCounters();
     return S_OK;
   }
   
@@ -187,6 +192,7 @@ namespace dxvk {
           UINT                        MapFlags,
           D3D11_MAPPED_SUBRESOURCE*   pMappedResource) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     if (unlikely(!pResource || !pMappedResource))
       return E_INVALIDARG;
@@ -171,6 +171,7 @@ namespace dxvk {
       SignalEvent(hEvent);
     
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Submit);
     
     if (m_csIsBusy || !m_csChunk->empty()) {
       // Add commands to flush the threaded
@@ -185,6 +186,8 @@ namespace dxvk {
       m_lastFlush = dxvk::high_resolution_clock::now();
       m_csIsBusy  = false;
     }
+
+    FlushStatCounters();
   }
   
   
@@ -277,6 +280,7 @@ namespace dxvk {
           UINT                        MapFlags,
           D3D11_MAPPED_SUBRESOURCE*   pMappedResource) {
     D3D10DeviceLock lock = LockContext();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     if (unlikely(!pResource))
       return E_INVALIDARG;
@@ -621,6 +625,8 @@ namespace dxvk {
   void D3D11ImmediateContext::UnmapImage(
           D3D11CommonTexture*         pResource,
           UINT                        Subresource) {
+    DXVK_API_TIMER(m_apiTimers, Resources);
+
     D3D11_MAP mapType = pResource->GetMapType(Subresource);
     pResource->SetMapType(Subresource, D3D11_MAP(~0u));
 
@@ -9,7 +9,8 @@ namespace dxvk {
           D3D11Device*                pParent)
   : m_parent(pParent),
     m_device(pParent->GetDXVKDevice()),
-    m_context(m_device->createContext()) {
+    m_context(m_device->createContext()),
+    m_stagingBuffer(m_device, StagingBufferSize) {
     m_context->beginRecording(
       m_device->createCommandList());
   }
@@ -69,25 +70,36 @@ namespace dxvk {
   void D3D11Initializer::InitDeviceLocalBuffer(
           D3D11Buffer*                pBuffer,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
-
     DxvkBufferSlice bufferSlice = pBuffer->GetBufferSlice();
 
     if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
+      // Copy the data before locking the context so that
+      // multiple threads can upload resources in parallel
+      DxvkBufferSlice stagingSlice = AllocStagingBuffer(bufferSlice.length());
+
+      std::memcpy(
+        stagingSlice.mapPtr(0),
+        pInitialData->pSysMem,
+        bufferSlice.length());
+
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
       m_transferMemory   += bufferSlice.length();
       m_transferCommands += 1;
       
       m_context->uploadBuffer(
         bufferSlice.buffer(),
-        pInitialData->pSysMem);
+        stagingSlice);
+
+      FlushImplicit();
     } else {
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
       m_transferCommands += 1;
 
       m_context->initBuffer(
         bufferSlice.buffer());
-    }
 
-    FlushImplicit();
+      FlushImplicit();
+    }
   }
 
 
@@ -115,8 +127,6 @@ namespace dxvk {
   void D3D11Initializer::InitDeviceLocalTexture(
           D3D11CommonTexture*         pTexture,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
-    
     Rc<DxvkImage> image = pTexture->GetImage();
 
     auto mapMode = pTexture->GetMapMode();
@@ -126,6 +136,15 @@ namespace dxvk {
     auto formatInfo = lookupFormatInfo(packedFormat);
 
     if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
+      // Depth-stencil data needs to be converted on the GPU,
+      // everything else is packed into staging memory before
+      // taking the lock so that only command recording is
+      // serialized between threads creating resources.
+      bool isDepthStencil = formatInfo->aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
+
+      small_vector<DxvkBufferSlice, 16> stagingSlices;
+      stagingSlices.resize(desc->ArraySize * desc->MipLevels);
+
       // pInitialData is an array that stores an entry for
       // every single subresource. Since we will define all
       // subresources, this counts as initialization.
@@ -134,10 +153,38 @@ namespace dxvk {
           const uint32_t id = D3D11CalcSubresource(
             level, layer, desc->MipLevels);
 
-          VkOffset3D mipLevelOffset = { 0, 0, 0 };
           VkExtent3D mipLevelExtent = pTexture->MipLevelExtent(level);
 
-          if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING) {
+          if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING && !isDepthStencil) {
+            VkExtent3D imageExtent = image->mipLevelExtent(level);
+
+            stagingSlices[id] = AllocStagingBuffer(
+              util::computeImageDataSize(image->info().format, imageExtent));
+
+            util::packImageData(stagingSlices[id].mapPtr(0),
+              pInitialData[id].pSysMem, pInitialData[id].SysMemPitch, pInitialData[id].SysMemSlicePitch,
+              0, 0, image->info().type, imageExtent, 1, image->formatInfo(), formatInfo->aspectMask);
+          }
+
+          if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_NONE) {
+            util::packImageData(pTexture->GetMappedBuffer(id)->mapPtr(0),
+              pInitialData[id].pSysMem, pInitialData[id].SysMemPitch, pInitialData[id].SysMemSlicePitch,
+              0, 0, pTexture->GetVkImageType(), mipLevelExtent, 1, formatInfo, formatInfo->aspectMask);
+          }
+        }
+      }
+
+      if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING) {
+        std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+        for (uint32_t layer = 0; layer < desc->ArraySize; layer++) {
+          for (uint32_t level = 0; level < desc->MipLevels; level++) {
+            const uint32_t id = D3D11CalcSubresource(
+              level, layer, desc->MipLevels);
+
+            VkOffset3D mipLevelOffset = { 0, 0, 0 };
+            VkExtent3D mipLevelExtent = pTexture->MipLevelExtent(level);
+
             m_transferCommands += 1;
             m_transferMemory   += pTexture->GetSubresourceLayout(formatInfo->aspectMask, id).Size;
             
@@ -147,12 +194,10 @@ namespace dxvk {
             subresourceLayers.baseArrayLayer = layer;
             subresourceLayers.layerCount     = 1;
             
-            if (formatInfo->aspectMask != (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
+            if (!isDepthStencil) {
               m_context->uploadImage(
                 image, subresourceLayers,
-                pInitialData[id].pSysMem,
-                pInitialData[id].SysMemPitch,
-                pInitialData[id].SysMemSlicePitch);
+                stagingSlices[id]);
             } else {
               m_context->updateDepthStencilImage(
                 image, subresourceLayers,
@@ -164,16 +209,20 @@ namespace dxvk {
                 packedFormat);
             }
           }
-
-          if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_NONE) {
-            util::packImageData(pTexture->GetMappedBuffer(id)->mapPtr(0),
-              pInitialData[id].pSysMem, pInitialData[id].SysMemPitch, pInitialData[id].SysMemSlicePitch,
-              0, 0, pTexture->GetVkImageType(), mipLevelExtent, 1, formatInfo, formatInfo->aspectMask);
-          }
         }
+
+        FlushImplicit();
       }
     } else {
+      if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_NONE) {
+        for (uint32_t i = 0; i < pTexture->CountSubresources(); i++) {
+          auto buffer = pTexture->GetMappedBuffer(i);
+          std::memset(buffer->mapPtr(0), 0, buffer->info().size);
+        }
+      }
+
       if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING) {
+        std::lock_guard<dxvk::mutex> lock(m_mutex);
         m_transferCommands += 1;
         
         // While the Microsoft docs state that resource contents are
@@ -187,17 +236,10 @@ namespace dxvk {
         subresources.layerCount     = desc->ArraySize;
 
         m_context->initImage(image, subresources, VK_IMAGE_LAYOUT_UNDEFINED);
-      }
 
-      if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_NONE) {
-        for (uint32_t i = 0; i < pTexture->CountSubresources(); i++) {
-          auto buffer = pTexture->GetMappedBuffer(i);
-          std::memset(buffer->mapPtr(0), 0, buffer->info().size);
-        }
+        FlushImplicit();
       }
     }
-
-    FlushImplicit();
   }
 
 
@@ -265,6 +307,16 @@ namespace dxvk {
     
     m_transferCommands = 0;
     m_transferMemory   = 0;
+
+    std::lock_guard<dxvk::mutex> lock(m_stagingMutex);
+    m_stagingBuffer.reset();
+  }
+
+
+  DxvkBufferSlice D3D11Initializer::AllocStagingBuffer(
+          VkDeviceSize                Size) {
+    std::lock_guard<dxvk::mutex> lock(m_stagingMutex);
+    return m_stagingBuffer.alloc(CACHE_LINE_SIZE, Size);
   }
 
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "d3d11_buffer.h"
 #include "d3d11_texture.h"
 
+#include "../dxvk/dxvk_staging.h"
+
 namespace dxvk {
 
   class D3D11Device;
@@ -14,10 +16,16 @@ namespace dxvk {
    * initialization. This includes initialization
    * with application-defined data, as well as
    * zero-initialization for buffers and images.
+   * 
+   * Initial data is written to staging memory by
+   * the creating thread before the upload command
+   * gets recorded, so that concurrent resource
+   * creation only serializes on command recording.
    */
   class D3D11Initializer {
     constexpr static size_t MaxTransferMemory    = 32 * 1024 * 1024;
     constexpr static size_t MaxTransferCommands  = 512;
+    constexpr static size_t StagingBufferSize    = 4 * 1024 * 1024;
   public:
 
     D3D11Initializer(
@@ -49,6 +57,12 @@ namespace dxvk {
     size_t            m_transferCommands  = 0;
     size_t            m_transferMemory    = 0;
 
+    dxvk::mutex       m_stagingMutex;
+    DxvkStagingBuffer m_stagingBuffer;
+
+    DxvkBufferSlice AllocStagingBuffer(
+            VkDeviceSize                Size);
+
     void InitDeviceLocalBuffer(
             D3D11Buffer*                pBuffer,
       const D3D11_SUBRESOURCE_DATA*     pInitialData);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <unordered_map>
 
 #include "d3d11_blend.h"
@@ -38,10 +39,16 @@ namespace dxvk {
    * an object with the same description already exists
    * and returns it if that is the case. This class
    * implements that behaviour.
+   *
+   * Objects are distributed across multiple independently
+   * locked buckets based on their hash, so that threads
+   * creating different state objects rarely contend.
    */
   template<typename T>
   class D3D11StateObjectSet {
     using DescType = typename T::DescType;
+
+    constexpr static size_t BucketCount = 16;
   public:
     
     /**
@@ -54,14 +61,17 @@ namespace dxvk {
      * \returns Pointer to the state object
      */
     T* Create(D3D11Device* device, const DescType& desc) {
-      std::lock_guard<dxvk::mutex> lock(m_mutex);
+      size_t hash = D3D11StateDescHash()(desc);
+
+      Bucket& bucket = m_buckets[(hash ^ (hash >> 16)) % BucketCount];
+      std::lock_guard<dxvk::mutex> lock(bucket.mutex);
       
-      auto entry = m_objects.find(desc);
+      auto entry = bucket.objects.find(desc);
       
-      if (entry != m_objects.end())
+      if (entry != bucket.objects.end())
         return ref(&entry->second);
       
-      auto result = m_objects.emplace(
+      auto result = bucket.objects.emplace(
         std::piecewise_construct,
         std::tuple(desc),
         std::tuple(device, desc));
@@ -69,10 +79,14 @@ namespace dxvk {
     }
     
   private:
-    
-    dxvk::mutex                                m_mutex;
-    std::unordered_map<DescType, T,
-      D3D11StateDescHash, D3D11StateDescEqual> m_objects;
+
+    struct alignas(CACHE_LINE_SIZE) Bucket {
+      dxvk::mutex                                mutex;
+      std::unordered_map<DescType, T,
+        D3D11StateDescHash, D3D11StateDescEqual> objects;
+    };
+
+    std::array<Bucket, BucketCount> m_buckets;
     
   };
   
@@ -256,11 +256,15 @@ namespace dxvk {
 
 
   HRESULT D3D11SwapChain::PresentImage(UINT SyncInterval) {
+    DxvkTraceScope trace(m_device->tracer(), "Present", "api");
+
     Com<ID3D11DeviceContext> deviceContext = nullptr;
     m_parent->GetImmediateContext(&deviceContext);
 
-    // Flush pending rendering commands before
     auto immediateContext = static_cast<D3D11ImmediateContext*>(deviceContext.ptr());
+    DXVK_API_TIMER(immediateContext->GetApiTimers(), Present);
+
+    // Flush pending rendering commands before
     immediateContext->Flush();
 
     // Bump our frame id.
@@ -31,6 +31,7 @@ namespace dxvk {
     }
 
     if (m_desc.Pool != D3DPOOL_DEFAULT) {
+      m_uploadBoxes.resize(CountSubresources());
       SetAllNeedUpload();
       if (pSharedHandle) {
         throw DxvkError("D3D9: Incompatible pool type for texture sharing.");
@@ -182,7 +183,7 @@ namespace dxvk {
 
   void* D3D9CommonTexture::GetData(UINT Subresource) {
     if (unlikely(m_buffer != nullptr))
-      return m_buffer->mapPtr(m_memoryOffset[Subresource]);
+      return reinterpret_cast<uint8_t*>(m_mappedSlice.mapPtr) + m_memoryOffset[Subresource];
 
     m_data.Map();
     uint8_t* ptr = reinterpret_cast<uint8_t*>(m_data.Ptr());
@@ -195,6 +196,49 @@ namespace dxvk {
     if (likely(m_buffer != nullptr))
       return;
 
+    m_buffer = CreateMappingBuffer();
+    m_mappedSlice = m_buffer->getSliceHandle();
+
+    if (Initialize) {
+      if (m_data) {
+        m_data.Map();
+        std::memcpy(m_buffer->mapPtr(0), m_data.Ptr(), m_totalSize);
+      } else {
+        std::memset(m_buffer->mapPtr(0), 0, m_totalSize);
+      }
+    }
+    m_data = {};
+  }
+
+
+  Rc<DxvkBuffer> D3D9CommonTexture::AllocReadbackBuffer() {
+    if (m_readbackBuffers.empty())
+      return CreateMappingBuffer();
+
+    Rc<DxvkBuffer> buffer = std::move(m_readbackBuffers.back());
+    m_readbackBuffers.pop_back();
+    return buffer;
+  }
+
+
+  void D3D9CommonTexture::CompleteReadbacks(size_t Count) {
+    if (m_buffer != nullptr)
+      m_readbackBuffers.push_back(std::move(m_buffer));
+
+    for (size_t i = 0; i < Count - 1; i++)
+      m_readbackBuffers.push_back(std::move(m_pendingReadbacks[i].buffer));
+
+    m_buffer = std::move(m_pendingReadbacks[Count - 1].buffer);
+    m_mappedSlice = m_buffer->getSliceHandle();
+    m_data = {};
+
+    m_pendingReadbacks.erase(
+      m_pendingReadbacks.begin(),
+      m_pendingReadbacks.begin() + Count);
+  }
+
+
+  Rc<DxvkBuffer> D3D9CommonTexture::CreateMappingBuffer() const {
     DxvkBufferCreateInfo info;
     info.size   = m_totalSize;
     info.usage  = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
@@ -216,17 +260,43 @@ namespace dxvk {
                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
                                   | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
 
-    m_buffer = m_device->GetDXVKDevice()->createBuffer(info, memType);
+    return m_device->GetDXVKDevice()->createBuffer(info, memType);
+  }
 
-    if (Initialize) {
-      if (m_data) {
-        m_data.Map();
-        std::memcpy(m_buffer->mapPtr(0), m_data.Ptr(), m_totalSize);
-      } else {
-        std::memset(m_buffer->mapPtr(0), 0, m_totalSize);
-      }
-    }
-    m_data = {};
+
+  bool D3D9CommonTexture::SupportsMapSliceDiscard() const {
+    if (!IsDynamic() || CountSubresources() != 1)
+      return false;
+
+    if (m_mapMode != D3D9_COMMON_TEXTURE_MAP_MODE_BACKED || m_image == nullptr)
+      return false;
+
+    if (m_image->info().sampleCount != VK_SAMPLE_COUNT_1_BIT)
+      return false;
+
+    // Converted and planar formats are not uploaded
+    // with a plain buffer to image copy
+    if (!m_mapping.IsValid() || m_mapping.ConversionFormatInfo.FormatType != D3D9ConversionFormat_None)
+      return false;
+
+    const DxvkFormatInfo* formatInfo = lookupFormatInfo(m_mapping.FormatColor);
+
+    return formatInfo->aspectMask == VK_IMAGE_ASPECT_COLOR_BIT
+        && !formatInfo->flags.test(DxvkFormatFlag::MultiPlane);
+  }
+
+
+  DxvkBufferSliceHandle D3D9CommonTexture::DiscardMapSlice(bool Preserve) {
+    DxvkBufferSliceHandle slice = m_buffer->allocSlice();
+
+    // The previous slice cannot be reused before the
+    // buffer is invalidated, so it is safe to read
+    if (Preserve)
+      std::memcpy(slice.mapPtr, m_mappedSlice.mapPtr, m_totalSize);
+
+    m_mappedSlice   = slice;
+    m_mapSliceInUse = false;
+    return slice;
   }
 
 
@@ -638,6 +708,110 @@ namespace dxvk {
   }
 
 
+  static bool BoxContains(const D3DBOX& Outer, const D3DBOX& Inner) {
+    return Outer.Left  <= Inner.Left  && Outer.Right  >= Inner.Right
+        && Outer.Top   <= Inner.Top   && Outer.Bottom >= Inner.Bottom
+        && Outer.Front <= Inner.Front && Outer.Back   >= Inner.Back;
+  }
+
+
+  static D3DBOX BoxUnion(const D3DBOX& A, const D3DBOX& B) {
+    return D3DBOX {
+      std::min(A.Left,  B.Left),  std::min(A.Top,    B.Top),
+      std::max(A.Right, B.Right), std::max(A.Bottom, B.Bottom),
+      std::min(A.Front, B.Front), std::max(A.Back,   B.Back) };
+  }
+
+
+  static uint64_t BoxVolume(const D3DBOX& Box) {
+    return uint64_t(Box.Right - Box.Left)
+         * uint64_t(Box.Bottom - Box.Top)
+         * uint64_t(Box.Back - Box.Front);
+  }
+
+
+  void D3D9CommonTexture::AddUploadBox(UINT Subresource, const D3DBOX* pBox) {
+    if (unlikely(Subresource >= m_uploadBoxes.size()))
+      return;
+
+    VkExtent3D extent = GetExtentMip(Subresource);
+    D3DBOX box = { 0, 0, extent.width, extent.height, 0, extent.depth };
+
+    if (pBox) {
+      box.Left   = std::min(pBox->Left,   extent.width);
+      box.Top    = std::min(pBox->Top,    extent.height);
+      box.Front  = std::min(pBox->Front,  extent.depth);
+      box.Right  = std::min(pBox->Right,  extent.width);
+      box.Bottom = std::min(pBox->Bottom, extent.height);
+      box.Back   = std::min(pBox->Back,   extent.depth);
+
+      if (box.Left >= box.Right || box.Top >= box.Bottom || box.Front >= box.Back)
+        return;
+    }
+
+    D3D9UploadBoxes& list = m_uploadBoxes[Subresource];
+    m_needsUpload.set(Subresource, true);
+
+    // Drop boxes covered by the new one, and the
+    // new one if an existing box already covers it
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < list.count; i++) {
+      if (BoxContains(list.boxes[i], box))
+        return;
+
+      if (!BoxContains(box, list.boxes[i]))
+        list.boxes[count++] = list.boxes[i];
+    }
+
+    list.count = count;
+
+    if (list.count < D3D9UploadBoxes::MaxBoxes) {
+      list.boxes[list.count++] = box;
+      return;
+    }
+
+    // Merge with whichever box grows the least
+    uint32_t best       = 0;
+    uint64_t bestGrowth = ~0ull;
+
+    for (uint32_t i = 0; i < list.count; i++) {
+      uint64_t growth = BoxVolume(BoxUnion(list.boxes[i], box)) - BoxVolume(list.boxes[i]);
+
+      if (growth < bestGrowth) {
+        best       = i;
+        bestGrowth = growth;
+      }
+    }
+
+    list.boxes[best] = BoxUnion(list.boxes[best], box);
+  }
+
+
+  void D3D9CommonTexture::AddUploadBoxAllMips(UINT Face, const D3DBOX* pBox) {
+    for (uint32_t m = 0; m < ExposedMipLevels(); m++) {
+      if (!pBox) {
+        AddUploadBox(CalcSubresource(Face, m), nullptr);
+        continue;
+      }
+
+      // Round outwards so that partially
+      // covered texels get uploaded too
+      uint32_t roundUp = (1u << m) - 1u;
+
+      D3DBOX box;
+      box.Left   = pBox->Left  >> m;
+      box.Top    = pBox->Top   >> m;
+      box.Front  = pBox->Front >> m;
+      box.Right  = (std::min(pBox->Right,  m_desc.Width)  + roundUp) >> m;
+      box.Bottom = (std::min(pBox->Bottom, m_desc.Height) + roundUp) >> m;
+      box.Back   = (std::min(pBox->Back,   m_desc.Depth)  + roundUp) >> m;
+
+      AddUploadBox(CalcSubresource(Face, m), &box);
+    }
+  }
+
+
   void D3D9CommonTexture::PreLoadAll() {
     if (!IsManaged())
       return;
@@ -653,8 +827,7 @@ namespace dxvk {
       auto lock = m_device->LockDevice();
 
       if (NeedsUpload(Subresource)) {
-        m_device->FlushImage(this, Subresource);
-        SetNeedsUpload(Subresource, false);
+        m_device->UploadManagedSubresource(this, Subresource);
 
         if (!NeedsAnyUpload())
           m_device->MarkTextureUploaded(this);
@@ -67,6 +67,27 @@ namespace dxvk {
 
   using D3D9SubresourceBitset = bit::bitset<caps::MaxSubresources>;
 
+  /**
+   * \brief Dirty regions of a managed subresource
+   */
+  struct D3D9UploadBoxes {
+    constexpr static uint32_t MaxBoxes = 4;
+
+    uint32_t                      count = 0;
+    std::array<D3DBOX, MaxBoxes>  boxes;
+  };
+
+  /**
+   * \brief Asynchronous readback
+   *
+   * Buffer that a render target is being copied
+   * to, and the CS chunk that the copy was on.
+   */
+  struct D3D9PendingReadback {
+    Rc<DxvkBuffer>                buffer;
+    uint64_t                      seq;
+  };
+
   class D3D9CommonTexture {
 
   public:
@@ -234,10 +255,101 @@ namespace dxvk {
      * Destroys mapping and staging buffers for a given subresource
      */
     void DestroyBuffer() {
-      m_buffer = nullptr;
+      m_buffer        = nullptr;
+      m_mappedSlice   = DxvkBufferSliceHandle();
+      m_mapSliceInUse = false;
       MarkAllNeedReadback();
     }
 
+    /**
+     * \brief Checks whether the mapping buffer can be renamed
+     *
+     * Dynamic textures with a single subresource get a new
+     * slice of their mapping buffer instead of waiting for
+     * pending copies from it, which allows copying from the
+     * mapping buffer to the image without staging.
+     * \returns \c true if the mapping buffer can be renamed
+     */
+    bool SupportsMapSliceDiscard() const;
+
+    /**
+     * \brief Allocates a new slice for the mapping buffer
+     *
+     * The caller must invalidate the buffer with the
+     * returned slice on the CS thread.
+     * \param [in] Preserve Whether to copy the current contents
+     * \returns New mapping buffer slice
+     */
+    DxvkBufferSliceHandle DiscardMapSlice(bool Preserve);
+
+    /**
+     * \brief Checks whether the GPU may read the mapped slice
+     * \returns \c true if the slice was used for a copy
+     */
+    bool IsMapSliceInUse() const {
+      return m_mapSliceInUse;
+    }
+
+    void SetMapSliceInUse(bool InUse) {
+      m_mapSliceInUse = InUse;
+    }
+
+    /**
+     * \brief Checks whether asynchronous readbacks can be used
+     *
+     * Readbacks into system memory surfaces with a single
+     * subresource can go to a separate buffer each, so that
+     * the application can keep reading older data while
+     * newer copies are still in flight.
+     * \returns \c true if readbacks can be asynchronous
+     */
+    bool SupportsAsyncReadback() const {
+      return m_desc.Pool == D3DPOOL_SYSTEMMEM
+          && CountSubresources() == 1
+          && m_mapping.ConversionFormatInfo.FormatType == D3D9ConversionFormat_None;
+    }
+
+    /**
+     * \brief Allocates a buffer for an asynchronous readback
+     *
+     * Reuses a buffer of a previously completed
+     * readback if possible.
+     * \returns Readback buffer
+     */
+    Rc<DxvkBuffer> AllocReadbackBuffer();
+
+    /**
+     * \brief Adds an asynchronous readback
+     *
+     * \param [in] Buffer Buffer the image is copied to
+     * \param [in] Seq Sequence number of the copy
+     */
+    void AddPendingReadback(Rc<DxvkBuffer>&& Buffer, uint64_t Seq) {
+      m_pendingReadbacks.push_back({ std::move(Buffer), Seq });
+    }
+
+    /**
+     * \brief Queries asynchronous readbacks
+     * \returns Pending readbacks, oldest first
+     */
+    const std::vector<D3D9PendingReadback>& GetPendingReadbacks() const {
+      return m_pendingReadbacks;
+    }
+
+    bool HasPendingReadbacks() const {
+      return !m_pendingReadbacks.empty();
+    }
+
+    /**
+     * \brief Makes completed readbacks visible
+     *
+     * The buffer of the last completed readback becomes the
+     * mapping buffer. All older buffers, including the previous
+     * mapping buffer, are kept around for future readbacks.
+     * \param [in] Count Number of completed readbacks
+     */
+    void CompleteReadbacks(size_t Count);
+
     bool IsDynamic() const {
       return m_desc.Usage & D3DUSAGE_DYNAMIC;
     }
@@ -369,20 +481,67 @@ namespace dxvk {
     D3D9SubresourceBitset& GetUploadBitmask() { return m_needsUpload; }
 
     void SetAllNeedUpload() {
-      if (likely(!IsAutomaticMip())) {
-        m_needsUpload.setAll();
-      } else {
-        for (uint32_t a = 0; a < m_desc.ArraySize; a++) {
-          for (uint32_t m = 0; m < ExposedMipLevels(); m++) {
-            SetNeedsUpload(CalcSubresource(a, m), true);
-          }
+      for (uint32_t a = 0; a < m_desc.ArraySize; a++) {
+        for (uint32_t m = 0; m < ExposedMipLevels(); m++) {
+          AddUploadBox(CalcSubresource(a, m), nullptr);
         }
       }
     }
-    void SetNeedsUpload(UINT Subresource, bool upload) { m_needsUpload.set(Subresource, upload); }
+    void SetNeedsUpload(UINT Subresource, bool upload) {
+      if (upload)
+        AddUploadBox(Subresource, nullptr);
+      else
+        ClearUploadBoxes(Subresource);
+    }
     bool NeedsUpload(UINT Subresource) const { return m_needsUpload.get(Subresource); }
     bool NeedsAnyUpload() { return m_needsUpload.any(); }
-    void ClearNeedsUpload() { return m_needsUpload.clearAll();  }
+    void ClearNeedsUpload() {
+      for (auto& boxes : m_uploadBoxes)
+        boxes.count = 0;
+
+      m_needsUpload.clearAll();
+    }
+
+    /**
+     * \brief Marks a region of a subresource for upload
+     *
+     * Managed textures only upload the regions that were
+     * written since the last upload. A small number of
+     * boxes is tracked per subresource, further boxes
+     * get merged with the closest existing one.
+     * \param [in] Subresource Subresource index
+     * \param [in] pBox Region in mip level coordinates,
+     *    or \c nullptr to upload the entire subresource
+     */
+    void AddUploadBox(UINT Subresource, const D3DBOX* pBox);
+
+    /**
+     * \brief Marks a region of all mip levels for upload
+     *
+     * Used for dirty rects, which apply to
+     * every mip level of the given face.
+     * \param [in] Face Array layer or cube face
+     * \param [in] pBox Region in top-level mip
+     *    coordinates, or \c nullptr for everything
+     */
+    void AddUploadBoxAllMips(UINT Face, const D3DBOX* pBox);
+
+    /**
+     * \brief Retrieves regions to upload
+     *
+     * \param [in] Subresource Subresource index
+     * \returns Dirty regions of the subresource
+     */
+    const D3D9UploadBoxes& GetUploadBoxes(UINT Subresource) const {
+      return m_uploadBoxes[Subresource];
+    }
+
+    void ClearUploadBoxes(UINT Subresource) {
+      if (Subresource < m_uploadBoxes.size())
+        m_uploadBoxes[Subresource].count = 0;
+
+      m_needsUpload.set(Subresource, false);
+    }
 
     void SetNeedsMipGen(bool value) { m_needsMipGen = value; }
     bool NeedsMipGen() const { return m_needsMipGen; }
@@ -489,8 +648,13 @@ namespace dxvk {
     Rc<DxvkImage>                 m_image;
     Rc<DxvkImage>                 m_resolveImage;
     Rc<DxvkBuffer>                m_buffer;
+    DxvkBufferSliceHandle         m_mappedSlice = { };
+    bool                          m_mapSliceInUse = false;
     D3D9Memory                    m_data = { };
 
+    std::vector<D3D9PendingReadback> m_pendingReadbacks;
+    std::vector<Rc<DxvkBuffer>>   m_readbackBuffers;
+
     D3D9SubresourceArray<
       uint64_t>                   m_seqs = { };
 
@@ -519,6 +683,8 @@ namespace dxvk {
 
     D3D9SubresourceBitset         m_needsUpload = { };
 
+    std::vector<D3D9UploadBoxes>  m_uploadBoxes;
+
     DWORD                         m_exposedMipLevels = 0;
 
     bool                          m_needsMipGen = false;
@@ -531,6 +697,8 @@ namespace dxvk {
 
     Rc<DxvkImage> CreateResolveImage() const;
 
+    Rc<DxvkBuffer> CreateMappingBuffer() const;
+
     BOOL DetermineShadowState() const;
 
     BOOL DetermineFetch4Compatibility() const;
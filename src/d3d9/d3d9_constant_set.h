@@ -10,6 +10,7 @@
 #include "../util/util_math.h"
 #include "../util/util_vector.h"
 
+#include <algorithm>
 #include <cstdint>
 
 namespace dxvk {
@@ -44,11 +45,45 @@ namespace dxvk {
     D3D9ConstantBuffer        boolBuffer;
   };
 
+  /**
+   * \brief Dirty constant register range
+   *
+   * Tracks the registers that were changed since the
+   * last upload, so that updates that the currently
+   * bound shader does not read can be ignored.
+   */
+  struct D3D9ConstantRange {
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+
+    void add(uint32_t start, uint32_t count) {
+      if (lo >= hi) {
+        lo = start;
+        hi = start + count;
+      } else {
+        lo = std::min(lo, start);
+        hi = std::max(hi, start + count);
+      }
+    }
+
+    bool intersects(uint32_t count) const {
+      return lo < std::min(hi, count);
+    }
+
+    void clear() {
+      lo = 0;
+      hi = 0;
+    }
+  };
+
   struct D3D9ConstantSets {
     D3D9SwvpConstantBuffers   swvp;
     D3D9ConstantBuffer        buffer;
     DxsoShaderMetaInfo        meta  = {};
     bool                      dirty = true;
+    D3D9ConstantRange         dirtyFloats;
+    uint32_t                  lastUploadSize  = 0;
+    bool                      redundantUpdate = false;
   };
 
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "d3d9_spec_constants.h"
 #include "d3d9_names.h"
 #include "d3d9_format_helpers.h"
+#include "d3d9_format_convert_cpu.h"
 
 #include "../dxvk/dxvk_adapter.h"
 #include "../dxvk/dxvk_instance.h"
@@ -177,10 +178,16 @@ namespace dxvk {
     m_activeRTsWhichAreTextures = 0;
     m_alphaSwizzleRTs = 0;
     m_lastHazardsRT = 0;
+
+    m_ffModules.Initialize(this);
   }
 
 
   D3D9DeviceEx::~D3D9DeviceEx() {
+    // Fixed-function shaders may still be compiling
+    // in the background and access device state.
+    m_ffModules.StopPrecompile();
+
     // Avoids hanging when in this state, see comment
     // in DxvkDevice::~DxvkDevice.
     if (this_thread::isInModuleDetachment())
@@ -842,6 +849,7 @@ namespace dxvk {
           IDirect3DSurface9* pDestinationSurface,
     const POINT*             pDestPoint) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     D3D9Surface* src = static_cast<D3D9Surface*>(pSourceSurface);
     D3D9Surface* dst = static_cast<D3D9Surface*>(pDestinationSurface);
@@ -918,6 +926,7 @@ namespace dxvk {
           IDirect3DBaseTexture9* pSourceTexture,
           IDirect3DBaseTexture9* pDestinationTexture) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     if (!pDestinationTexture || !pSourceTexture)
       return D3DERR_INVALIDCALL;
@@ -1028,8 +1037,27 @@ namespace dxvk {
                        || dstTexExtent.width > srcTexExtent.width
                        || dstTexExtent.height > srcTexExtent.height;
 
-    dstTexInfo->CreateBuffer(clearDst);
-    DxvkBufferSlice dstBufferSlice      = dstTexInfo->GetBufferSlice(dst->GetSubresource());
+    // Copy to a separate buffer if the application is fine
+    // with reading older data, so that locking the surface
+    // does not need to wait for this copy to complete
+    const bool asyncReadback = m_d3d9Options.readbackLatency > 0
+                            && !clearDst && dstTexInfo->SupportsAsyncReadback();
+
+    DxvkBufferSlice dstBufferSlice;
+
+    if (asyncReadback) {
+      // Bound the number of copies in flight
+      uint32_t latency = uint32_t(m_d3d9Options.readbackLatency);
+
+      if (dstTexInfo->GetPendingReadbacks().size() > latency)
+        ResolveReadbacks(dstTexInfo, latency, 0);
+
+      dstBufferSlice = DxvkBufferSlice(dstTexInfo->AllocReadbackBuffer());
+    } else {
+      dstTexInfo->CreateBuffer(clearDst);
+      dstBufferSlice = dstTexInfo->GetBufferSlice(dst->GetSubresource());
+    }
+
     Rc<DxvkImage> srcImage              = srcTexInfo->GetImage();
     const DxvkFormatInfo* srcFormatInfo = lookupFormatInfo(srcImage->info().format);
 
@@ -1039,6 +1067,8 @@ namespace dxvk {
       srcSubresource.mipLevel,
       srcSubresource.arrayLayer, 1 };
 
+    Rc<DxvkBuffer> dstBuffer = dstBufferSlice.buffer();
+
     EmitCs([
       cBufferSlice  = std::move(dstBufferSlice),
       cImage        = srcImage,
@@ -1050,9 +1080,19 @@ namespace dxvk {
         cLevelExtent);
     });
 
-    dstTexInfo->SetNeedsReadback(dst->GetSubresource(), true);
     TrackTextureMappingBufferSequenceNumber(dstTexInfo, dst->GetSubresource());
 
+    if (asyncReadback) {
+      dstTexInfo->AddPendingReadback(std::move(dstBuffer),
+        dstTexInfo->GetMappingBufferSequenceNumber(dst->GetSubresource()));
+
+      // Get the copy to the GPU early so that it is
+      // more likely to be done by the time we lock
+      ConsiderFlush(GpuFlushType::ImplicitWeakHint);
+    } else {
+      dstTexInfo->SetNeedsReadback(dst->GetSubresource(), true);
+    }
+
     return D3D_OK;
   }
 
@@ -1372,6 +1412,7 @@ namespace dxvk {
           DWORD              RenderTargetIndex,
           IDirect3DSurface9* pRenderTarget) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely((pRenderTarget == nullptr && RenderTargetIndex == 0)))
       return D3DERR_INVALIDCALL;
@@ -1507,6 +1548,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetDepthStencilSurface(IDirect3DSurface9* pNewZStencil) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     D3D9Surface* ds = static_cast<D3D9Surface*>(pNewZStencil);
 
@@ -1795,6 +1837,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetViewport(const D3DVIEWPORT9* pViewport) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(ShouldRecord()))
       return m_recorder->SetViewport(pViewport);
@@ -1982,6 +2025,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetRenderState(D3DRENDERSTATETYPE State, DWORD Value) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     // D3D9 only allows reading for values 0 and 7-255 so we don't need to do anything but return OK
     if (unlikely(State > 255 || (State < D3DRS_ZENABLE && State != 0))) {
@@ -2520,6 +2564,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetScissorRect(const RECT* pRect) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(pRect == nullptr))
       return D3DERR_INVALIDCALL;
@@ -2587,6 +2632,7 @@ namespace dxvk {
           UINT             StartVertex,
           UINT             PrimitiveCount) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Draw);
 
     if (unlikely(m_state.vertexDecl == nullptr))
       return D3DERR_INVALIDCALL;
@@ -2637,6 +2683,7 @@ namespace dxvk {
           UINT             StartIndex,
           UINT             PrimitiveCount) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Draw);
 
     if (unlikely(m_state.vertexDecl == nullptr))
       return D3DERR_INVALIDCALL;
@@ -2659,6 +2706,9 @@ namespace dxvk {
 
     PrepareDraw(PrimitiveType, !dynamicSysmemVBOs, !dynamicSysmemIBO);
 
+    if (BatchIndexedDraw(PrimitiveType, indexCount, StartIndex, BaseVertexIndex))
+      return D3D_OK;
+
     EmitCs([this,
       cPrimType        = PrimitiveType,
       cPrimCount       = PrimitiveCount,
@@ -2686,6 +2736,7 @@ namespace dxvk {
     const void*            pVertexStreamZeroData,
           UINT             VertexStreamZeroStride) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Draw);
 
     if (unlikely(m_state.vertexDecl == nullptr))
       return D3DERR_INVALIDCALL;
@@ -2697,6 +2748,14 @@ namespace dxvk {
 
     uint32_t vertexCount = GetVertexCount(PrimitiveType, PrimitiveCount);
 
+    if (BatchUPDraw(PrimitiveType, vertexCount, pVertexStreamZeroData,
+        VertexStreamZeroStride, 0, nullptr, D3DFMT_UNKNOWN)) {
+      m_state.vertexBuffers[0].vertexBuffer = nullptr;
+      m_state.vertexBuffers[0].offset       = 0;
+      m_state.vertexBuffers[0].stride       = 0;
+      return D3D_OK;
+    }
+
     const uint32_t dataSize = GetUPDataSize(vertexCount, VertexStreamZeroStride);
     const uint32_t bufferSize = GetUPBufferSize(vertexCount, VertexStreamZeroStride);
 
@@ -2738,6 +2797,7 @@ namespace dxvk {
     const void*            pVertexStreamZeroData,
           UINT             VertexStreamZeroStride) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Draw);
 
     if (unlikely(m_state.vertexDecl == nullptr))
         return D3DERR_INVALIDCALL;
@@ -2749,6 +2809,16 @@ namespace dxvk {
 
     uint32_t vertexCount = GetVertexCount(PrimitiveType, PrimitiveCount);
 
+    if (GetInstanceCount() == 1 && BatchUPDraw(PrimitiveType, MinVertexIndex + NumVertices,
+        pVertexStreamZeroData, VertexStreamZeroStride, vertexCount, pIndexData, IndexDataFormat)) {
+      m_state.vertexBuffers[0].vertexBuffer = nullptr;
+      m_state.vertexBuffers[0].offset       = 0;
+      m_state.vertexBuffers[0].stride       = 0;
+
+      m_state.indices = nullptr;
+      return D3D_OK;
+    }
+
     const uint32_t vertexDataSize = GetUPDataSize(MinVertexIndex + NumVertices, VertexStreamZeroStride);
     const uint32_t vertexBufferSize = GetUPBufferSize(MinVertexIndex + NumVertices, VertexStreamZeroStride);
 
@@ -2803,9 +2873,6 @@ namespace dxvk {
           IDirect3DVertexBuffer9*      pDestBuffer,
           IDirect3DVertexDeclaration9* pVertexDecl,
           DWORD                        Flags) {
-    Logger::err("D3D9DeviceEx::ProcessVertices: SWVP emu unsupported: (geometry shaders)");
-    return D3D_OK;
-
     D3D9DeviceLock lock = LockDevice();
 
     if (unlikely(pDestBuffer == nullptr))
@@ -2820,23 +2887,12 @@ namespace dxvk {
         return D3DERR_INVALIDCALL;
     }
 
-    if (!SupportsSWVP()) {
-      static bool s_errorShown = false;
-
-      if (!std::exchange(s_errorShown, true))
-        Logger::err("D3D9DeviceEx::ProcessVertices: SWVP emu unsupported (vertexPipelineStoresAndAtomics)");
-
-      return D3D_OK;
-    }
-
     if (!VertexCount)
       return D3D_OK;
 
     D3D9CommonBuffer* dst  = static_cast<D3D9VertexBuffer*>(pDestBuffer)->GetCommonBuffer();
     D3D9VertexDecl*   decl = static_cast<D3D9VertexDecl*>  (pVertexDecl);
 
-    PrepareDraw(D3DPT_FORCE_DWORD, true, true);
-
     if (decl == nullptr) {
       DWORD FVF = dst->Desc()->FVF;
 
@@ -2850,67 +2906,15 @@ namespace dxvk {
         decl = iter->second.ptr();
     }
 
-    uint32_t offset = DestIndex * decl->GetSize(0);
-
-    auto slice = dst->GetBufferSlice<D3D9_COMMON_BUFFER_TYPE_REAL>();
-         slice = slice.subSlice(offset, slice.length() - offset);
-
-    EmitCs([this,
-      cDecl          = ref(decl),
-      cVertexCount   = VertexCount,
-      cStartIndex    = SrcStartIndex,
-      cInstanceCount = GetInstanceCount(),
-      cBufferSlice   = slice
-    ](DxvkContext* ctx) {
-      Rc<DxvkShader> shader = m_swvpEmulator.GetShaderModule(this, cDecl);
-
-      auto drawInfo = GenerateDrawInfo(D3DPT_POINTLIST, cVertexCount, cInstanceCount);
-
-      if (drawInfo.instanceCount != 1) {
-        drawInfo.instanceCount = 1;
-
-        Logger::warn("D3D9DeviceEx::ProcessVertices: instancing unsupported");
-      }
-
-      ApplyPrimitiveType(ctx, D3DPT_POINTLIST);
-
-      // Unbind the pixel shader, we aren't drawing
-      // to avoid val errors / UB.
-      ctx->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
+    HRESULT hr = ProcessVerticesCpu(SrcStartIndex, DestIndex, VertexCount, dst, decl, Flags);
 
-      ctx->bindShader(VK_SHADER_STAGE_GEOMETRY_BIT, shader);
-      ctx->bindResourceBuffer(getSWVPBufferSlot(), cBufferSlice);
-      ctx->draw(
-        drawInfo.vertexCount, drawInfo.instanceCount,
-        cStartIndex, 0);
-      ctx->bindResourceBuffer(getSWVPBufferSlot(), DxvkBufferSlice());
-      ctx->bindShader(VK_SHADER_STAGE_GEOMETRY_BIT, nullptr);
-    });
+    if (hr != D3DERR_NOTAVAILABLE)
+      return hr;
 
-    // We unbound the pixel shader before,
-    // let's make sure that gets rebound.
-    m_flags.set(D3D9DeviceFlag::DirtyFFPixelShader);
+    static bool s_unsupportedShown = false;
 
-    if (m_state.pixelShader != nullptr) {
-      BindShader<DxsoProgramTypes::PixelShader>(
-        GetCommonShader(m_state.pixelShader), GetPixelShaderPermutation());
-    }
-
-    if (dst->GetMapMode() == D3D9_COMMON_BUFFER_MAP_MODE_BUFFER) {
-      uint32_t copySize = VertexCount * decl->GetSize(0);
-
-      EmitCs([
-        cSrcBuffer = dst->GetBuffer<D3D9_COMMON_BUFFER_TYPE_REAL>(),
-        cDstBuffer = dst->GetBuffer<D3D9_COMMON_BUFFER_TYPE_MAPPING>(),
-        cOffset    = offset,
-        cCopySize  = copySize
-      ](DxvkContext* ctx) {
-        ctx->copyBuffer(cDstBuffer, cOffset, cSrcBuffer, cOffset, cCopySize);
-      });
-    }
-
-    dst->SetNeedsReadback(true);
-    TrackBufferMappingBufferSequenceNumber(dst);
+    if (!std::exchange(s_unsupportedShown, true))
+      Logger::err("D3D9DeviceEx::ProcessVertices: Vertex shader or fixed-function state unsupported");
 
     return D3D_OK;
   }
@@ -2944,6 +2948,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetVertexDeclaration(IDirect3DVertexDeclaration9* pDecl) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     D3D9VertexDecl* decl = static_cast<D3D9VertexDecl*>(pDecl);
 
@@ -2988,6 +2993,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetFVF(DWORD FVF) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (FVF == 0)
       return D3D_OK;
@@ -3055,6 +3061,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetVertexShader(IDirect3DVertexShader9* pShader) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Shaders);
 
     D3D9VertexShader* shader = static_cast<D3D9VertexShader*>(pShader);
 
@@ -3208,6 +3215,7 @@ namespace dxvk {
           UINT                    OffsetInBytes,
           UINT                    Stride) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(StreamNumber >= caps::MaxStreams))
       return D3DERR_INVALIDCALL;
@@ -3332,6 +3340,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetIndices(IDirect3DIndexBuffer9* pIndexData) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     D3D9IndexBuffer* buffer = static_cast<D3D9IndexBuffer*>(pIndexData);
 
@@ -3396,6 +3405,7 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D9DeviceEx::SetPixelShader(IDirect3DPixelShader9* pShader) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Shaders);
 
     D3D9PixelShader* shader = static_cast<D3D9PixelShader*>(pShader);
 
@@ -3934,6 +3944,7 @@ namespace dxvk {
     D3DSAMPLERSTATETYPE Type,
     DWORD               Value) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(ShouldRecord()))
       return m_recorder->SetStateSamplerState(StateSampler, Type, Value);
@@ -3982,6 +3993,7 @@ namespace dxvk {
 
   HRESULT D3D9DeviceEx::SetStateTexture(DWORD StateSampler, IDirect3DBaseTexture9* pTexture) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(ShouldRecord()))
       return m_recorder->SetStateTexture(StateSampler, pTexture);
@@ -4049,6 +4061,7 @@ namespace dxvk {
 
   HRESULT D3D9DeviceEx::SetStateTransform(uint32_t idx, const D3DMATRIX* pMatrix) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(ShouldRecord()))
       return m_recorder->SetStateTransform(idx, pMatrix);
@@ -4075,6 +4088,7 @@ namespace dxvk {
     Type = std::min(Type, D3D9TextureStageStateTypes(DXVK_TSS_COUNT - 1));
 
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, State);
 
     if (unlikely(ShouldRecord()))
       return m_recorder->SetStateTextureStageState(Stage, Type, Value);
@@ -4193,6 +4207,9 @@ namespace dxvk {
     // D3D10 level hardware supports this in D3D9 native.
     enabled.core.features.fullDrawIndexUint32 = VK_TRUE;
 
+    // Used to merge consecutive indexed draws
+    enabled.core.features.multiDrawIndirect = supported.core.features.multiDrawIndirect;
+
     // Enable depth bounds test if we support it.
     enabled.core.features.depthBounds = supported.core.features.depthBounds;
 
@@ -4221,7 +4238,16 @@ namespace dxvk {
 
 
   D3D9BufferSlice D3D9DeviceEx::AllocUPBuffer(VkDeviceSize size) {
-    constexpr VkDeviceSize UPBufferSize = 1 << 20;
+    // The pending batch relies on nothing else
+    // being allocated after its vertex data
+    if (unlikely(m_upBatch.drawCount))
+      FlushUPBatch();
+
+    // Flushing a draw batch allocates its arguments from this buffer,
+    // which may invalidate it. Do that now rather than when the caller
+    // emits commands referencing the slice we are about to return.
+    if (unlikely(m_drawBatch.drawCount))
+      FlushDrawBatch();
 
     if (unlikely(m_upBuffer == nullptr || size > UPBufferSize)) {
       VkMemoryPropertyFlags memoryFlags
@@ -4232,10 +4258,13 @@ namespace dxvk {
       DxvkBufferCreateInfo info;
       info.size   = std::max(UPBufferSize, size);
       info.usage  = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
-                  | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+                  | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+                  | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
       info.access = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
-                  | VK_ACCESS_INDEX_READ_BIT;
-      info.stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+                  | VK_ACCESS_INDEX_READ_BIT
+                  | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+      info.stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+                  | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
 
       Rc<DxvkBuffer> buffer = m_dxvkDevice->createBuffer(info, memoryFlags);
 
@@ -4276,6 +4305,266 @@ namespace dxvk {
   }
 
 
+  template <typename T>
+  static void RebaseUPIndices(
+          void*                   pDst,
+    const void*                   pSrc,
+          uint32_t                Count,
+          uint32_t                Base) {
+    auto dst = reinterpret_cast<      T*>(pDst);
+    auto src = reinterpret_cast<const T*>(pSrc);
+
+    for (uint32_t i = 0; i < Count; i++)
+      dst[i] = T(src[i] + Base);
+  }
+
+
+  bool D3D9DeviceEx::BatchUPDraw(
+          D3DPRIMITIVETYPE        PrimitiveType,
+          UINT                    VertexCount,
+    const void*                   pVertexData,
+          UINT                    Stride,
+          UINT                    IndexCount,
+    const void*                   pIndexData,
+          D3DFORMAT               IndexFormat) {
+    // Strips and fans cannot be concatenated
+    const bool isList = PrimitiveType == D3DPT_POINTLIST
+                     || PrimitiveType == D3DPT_LINELIST
+                     || PrimitiveType == D3DPT_TRIANGLELIST;
+
+    if (!m_d3d9Options.batchUPDraws || !isList || !Stride)
+      return false;
+
+    if (unlikely(m_drawBatch.drawCount))
+      FlushDrawBatch();
+
+    const bool indexed = pIndexData != nullptr;
+
+    const VkIndexType indexType = indexed
+      ? DecodeIndexType(static_cast<D3D9Format>(IndexFormat))
+      : VK_INDEX_TYPE_UINT16;
+
+    const uint32_t indexSize  = indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4;
+    const uint32_t dataSize   = GetUPDataSize(VertexCount, Stride);
+    const uint32_t bufferSize = GetUPBufferSize(VertexCount, Stride);
+
+    D3D9UPBatch& batch = m_upBatch;
+
+    // Vertex data is appended in place, so nothing else may be allocated
+    // from the UP buffer while the batch is pending. Room for the indices
+    // is kept at the end so that flushing never needs to wrap the buffer.
+    const VkDeviceSize vertexEnd = batch.slice.offset()
+      + VkDeviceSize(batch.vertexCount) * Stride + bufferSize;
+    const VkDeviceSize indexEnd = align(vertexEnd, CACHE_LINE_SIZE)
+      + align(batch.indices.size() + IndexCount * indexSize, CACHE_LINE_SIZE);
+
+    bool merge = batch.drawCount
+      && batch.primType  == PrimitiveType
+      && batch.stride    == Stride
+      && batch.indexed   == indexed
+      && batch.indexType == indexType
+      && indexEnd <= UPBufferSize;
+
+    if (indexType == VK_INDEX_TYPE_UINT16)
+      merge &= batch.vertexCount + VertexCount <= 0xffffu;
+
+    if (!merge) {
+      FlushUPBatch();
+
+      VkDeviceSize size = align(bufferSize, CACHE_LINE_SIZE) + IndexCount * indexSize;
+
+      if (size > UPBufferSize)
+        return false;
+
+      auto upSlice = AllocUPBuffer(size);
+
+      batch.primType    = PrimitiveType;
+      batch.stride      = Stride;
+      batch.indexed     = indexed;
+      batch.indexType   = indexType;
+      batch.slice       = std::move(upSlice.slice);
+      batch.mapPtr      = reinterpret_cast<uint8_t*>(upSlice.mapPtr);
+      batch.vertexCount = 0;
+      batch.indices.clear();
+    }
+
+    const VkDeviceSize vertexOffset = VkDeviceSize(batch.vertexCount) * Stride;
+    FillUPVertexBuffer(batch.mapPtr + vertexOffset, pVertexData, dataSize, bufferSize);
+
+    if (indexed) {
+      size_t indexOffset = batch.indices.size();
+      batch.indices.resize(indexOffset + IndexCount * indexSize);
+
+      if (indexType == VK_INDEX_TYPE_UINT16)
+        RebaseUPIndices<uint16_t>(&batch.indices[indexOffset], pIndexData, IndexCount, batch.vertexCount);
+      else
+        RebaseUPIndices<uint32_t>(&batch.indices[indexOffset], pIndexData, IndexCount, batch.vertexCount);
+    }
+
+    batch.dataSize     = vertexOffset + bufferSize;
+    batch.vertexCount += VertexCount;
+    batch.drawCount   += 1;
+
+    // Release the space reserved for indices, it is only
+    // needed again once the batch actually gets flushed
+    m_upBufferOffset = align(batch.slice.offset() + batch.dataSize, CACHE_LINE_SIZE);
+    return true;
+  }
+
+
+  void D3D9DeviceEx::FlushUPBatch() {
+    D3D9UPBatch& batch = m_upBatch;
+
+    if (!batch.drawCount)
+      return;
+
+    // Reset this first since emitting commands
+    // would otherwise try to flush the batch again
+    batch.drawCount = 0;
+
+    DxvkBufferSlice vertexSlice(batch.slice.buffer(),
+      batch.slice.offset(), batch.dataSize);
+
+    if (!batch.indexed) {
+      EmitCs([this,
+        cBufferSlice  = std::move(vertexSlice),
+        cPrimType     = batch.primType,
+        cStride       = batch.stride,
+        cVertexCount  = batch.vertexCount
+      ](DxvkContext* ctx) {
+        ApplyPrimitiveType(ctx, cPrimType);
+
+        ctx->bindVertexBuffer(0, cBufferSlice, cStride);
+        ctx->draw(
+          cVertexCount, 1,
+          0, 0);
+        ctx->bindVertexBuffer(0, DxvkBufferSlice(), 0);
+      });
+    } else {
+      const uint32_t indexSize = batch.indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4;
+
+      auto indexSlice = AllocUPBuffer(batch.indices.size());
+      std::memcpy(indexSlice.mapPtr, batch.indices.data(), batch.indices.size());
+
+      EmitCs([this,
+        cVertexSlice  = std::move(vertexSlice),
+        cIndexSlice   = std::move(indexSlice.slice),
+        cPrimType     = batch.primType,
+        cStride       = batch.stride,
+        cIndexType    = batch.indexType,
+        cIndexCount   = uint32_t(batch.indices.size() / indexSize)
+      ](DxvkContext* ctx) {
+        ApplyPrimitiveType(ctx, cPrimType);
+
+        ctx->bindVertexBuffer(0, cVertexSlice, cStride);
+        ctx->bindIndexBuffer(cIndexSlice, cIndexType);
+        ctx->drawIndexed(
+          cIndexCount, 1,
+          0,
+          0, 0);
+        ctx->bindVertexBuffer(0, DxvkBufferSlice(), 0);
+        ctx->bindIndexBuffer(DxvkBufferSlice(), VK_INDEX_TYPE_UINT32);
+      });
+    }
+
+    batch.slice = DxvkBufferSlice();
+  }
+
+
+  bool D3D9DeviceEx::BatchIndexedDraw(
+          D3DPRIMITIVETYPE        PrimitiveType,
+          UINT                    IndexCount,
+          UINT                    StartIndex,
+          INT                     BaseVertexIndex) {
+    if (!m_d3d9Options.batchIndexedDraws || !m_dxvkDevice->features().core.features.multiDrawIndirect)
+      return false;
+
+    if (unlikely(m_upBatch.drawCount))
+      FlushUPBatch();
+
+    D3D9DrawBatch& batch = m_drawBatch;
+
+    const uint32_t instanceCount = GetInstanceCount();
+
+    bool merge = batch.drawCount
+      && batch.drawCount     <  D3D9DrawBatch::MaxDraws
+      && batch.primType      == PrimitiveType
+      && batch.instanceCount == instanceCount;
+
+    if (!merge) {
+      FlushDrawBatch();
+
+      batch.primType      = PrimitiveType;
+      batch.instanceCount = instanceCount;
+    }
+
+    VkDrawIndexedIndirectCommand& draw = batch.draws[batch.drawCount++];
+    draw.indexCount    = IndexCount;
+    draw.instanceCount = instanceCount;
+    draw.firstIndex    = StartIndex;
+    draw.vertexOffset  = BaseVertexIndex;
+    draw.firstInstance = 0;
+    return true;
+  }
+
+
+  void D3D9DeviceEx::FlushDrawBatch() {
+    D3D9DrawBatch& batch = m_drawBatch;
+
+    if (!batch.drawCount)
+      return;
+
+    // Reset this first since emitting commands
+    // would otherwise try to flush the batch again
+    const uint32_t drawCount = std::exchange(batch.drawCount, 0u);
+
+    if (drawCount == 1) {
+      EmitCs([this,
+        cPrimType      = batch.primType,
+        cInstanceCount = batch.instanceCount,
+        cDraw          = batch.draws[0]
+      ](DxvkContext* ctx) {
+        auto drawInfo = GenerateDrawInfo(cPrimType, 0, cInstanceCount);
+
+        ApplyPrimitiveType(ctx, cPrimType);
+
+        ctx->drawIndexed(
+          cDraw.indexCount, drawInfo.instanceCount,
+          cDraw.firstIndex,
+          cDraw.vertexOffset, 0);
+      });
+    } else {
+      const size_t argSize = drawCount * sizeof(VkDrawIndexedIndirectCommand);
+
+      auto argSlice = AllocUPBuffer(argSize);
+      std::memcpy(argSlice.mapPtr, batch.draws.data(), argSize);
+
+      EmitCs([this,
+        cArgSlice      = std::move(argSlice.slice),
+        cArgData       = reinterpret_cast<VkDrawIndexedIndirectCommand*>(argSlice.mapPtr),
+        cPrimType      = batch.primType,
+        cInstanceCount = batch.instanceCount,
+        cDrawCount     = drawCount
+      ](DxvkContext* ctx) {
+        auto drawInfo = GenerateDrawInfo(cPrimType, 0, cInstanceCount);
+
+        // Whether instancing is used depends on the input
+        // layout, which is only known on the CS thread
+        if (drawInfo.instanceCount != cInstanceCount) {
+          for (uint32_t i = 0; i < cDrawCount; i++)
+            cArgData[i].instanceCount = drawInfo.instanceCount;
+        }
+
+        ApplyPrimitiveType(ctx, cPrimType);
+
+        ctx->bindDrawBuffers(cArgSlice, DxvkBufferSlice());
+        ctx->drawIndexedIndirect(0, cDrawCount,
+          sizeof(VkDrawIndexedIndirectCommand));
+      });
+    }
+  }
+
+
   D3D9BufferSlice D3D9DeviceEx::AllocStagingBuffer(VkDeviceSize size) {
     m_stagingBufferAllocated += size;
 
@@ -4415,6 +4704,46 @@ namespace dxvk {
   }
 
 
+  bool D3D9DeviceEx::ResolveReadbacks(
+          D3D9CommonTexture*                pResource,
+          uint32_t                          Latency,
+          DWORD                             MapFlags) {
+    const auto& readbacks = pResource->GetPendingReadbacks();
+    uint64_t executedSeq = m_csThread.lastSequenceNumber();
+
+    // Copies execute in order, so stop at the first one that is
+    // either not recorded yet or still being executed on the GPU
+    int32_t completed = -1;
+
+    for (size_t i = 0; i < readbacks.size(); i++) {
+      if (readbacks[i].seq > executedSeq || readbacks[i].buffer->isInUse(DxvkAccess::Write))
+        break;
+
+      completed = int32_t(i);
+    }
+
+    // Wait if the data would be too old otherwise, or
+    // if there is no data that could be returned at all
+    int32_t required = int32_t(readbacks.size()) - int32_t(Latency) - 1;
+
+    if (pResource->GetBuffer() == nullptr)
+      required = std::max(required, 0);
+
+    if (completed < required) {
+      if (!WaitForResource(readbacks[required].buffer, readbacks[required].seq,
+          D3DLOCK_READONLY | (MapFlags & D3DLOCK_DONOTWAIT)))
+        return false;
+
+      completed = required;
+    }
+
+    if (completed >= 0)
+      pResource->CompleteReadbacks(size_t(completed) + 1);
+
+    return true;
+  }
+
+
   uint32_t D3D9DeviceEx::CalcImageLockOffset(
             uint32_t                SlicePitch,
             uint32_t                RowPitch,
@@ -4454,6 +4783,7 @@ namespace dxvk {
       const D3DBOX*                 pBox,
             DWORD                   Flags) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     UINT Subresource = pResource->CalcSubresource(Face, MipLevel);
 
@@ -4523,6 +4853,11 @@ namespace dxvk {
 
     bool renderable = desc.Usage & (D3DUSAGE_RENDERTARGET | D3DUSAGE_DEPTHSTENCIL);
 
+    if (unlikely(pResource->HasPendingReadbacks())) {
+      if (!ResolveReadbacks(pResource, uint32_t(m_d3d9Options.readbackLatency), Flags))
+        return D3DERR_WASSTILLDRAWING;
+    }
+
     // If we recently wrote to the texture on the gpu,
     // then we need to copy -> buffer
     // We are also always dirty if we are a render target,
@@ -4540,6 +4875,20 @@ namespace dxvk {
       pResource->CreateBuffer(!needsReadback);
     }
 
+    // The mapping buffer of dynamic textures may be read by a pending
+    // copy to the image. Rename it instead of waiting, and preserve
+    // the previous contents unless the application discards them.
+    if (pResource->IsMapSliceInUse() && !needsReadback && !readOnly) {
+      DxvkBufferSliceHandle slice = pResource->DiscardMapSlice(!(Flags & D3DLOCK_DISCARD));
+
+      EmitCs([
+        cBuffer = pResource->GetBuffer(),
+        cSlice  = slice
+      ] (DxvkContext* ctx) {
+        ctx->invalidateBuffer(cBuffer, cSlice);
+      });
+    }
+
     // Don't use MapTexture here to keep the mapped list small while the resource is still locked.
     void* mapPtr = pResource->GetData(Subresource);
 
@@ -4672,7 +5021,10 @@ namespace dxvk {
     }
 
     if (IsPoolManaged(desc.Pool) && !readOnly) {
-      pResource->SetNeedsUpload(Subresource, true);
+      // Only upload the locked region. D3DLOCK_NO_DIRTY_UPDATE only
+      // affects the dirty region used by UpdateTexture, the locked
+      // data still needs to reach the GPU copy of the texture.
+      pResource->AddUploadBox(Subresource, pBox);
 
       for (uint32_t i : bit::BitMask(m_activeTextures)) {
         // Guaranteed to not be nullptr...
@@ -4704,6 +5056,7 @@ namespace dxvk {
         UINT                    Face,
         UINT                    MipLevel) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     UINT Subresource = pResource->CalcSubresource(Face, MipLevel);
 
@@ -4761,7 +5114,31 @@ namespace dxvk {
     VkOffset3D mip0Offset = { int32_t(box.Left), int32_t(box.Top), int32_t(box.Front) };
     VkOffset3D offset = util::computeMipLevelOffset(mip0Offset, subresource.mipLevel);
 
-    UpdateTextureFromBuffer(pResource, pResource, Subresource, Subresource, offset, extent, offset);
+    VkExtent3D levelExtent = image->mipLevelExtent(subresource.mipLevel);
+
+    if (pResource->SupportsMapSliceDiscard()
+     && offset == VkOffset3D { 0, 0, 0 }
+     && extent == levelExtent) {
+      // Copy straight from the mapping buffer, which gets
+      // renamed the next time the texture is locked
+      EmitCs([
+        cSrcSlice  = pResource->GetBufferSlice(Subresource),
+        cDstImage  = image,
+        cDstLayers = vk::makeSubresourceLayers(subresource),
+        cExtent    = levelExtent
+      ] (DxvkContext* ctx) {
+        ctx->copyBufferToImage(
+          cDstImage, cDstLayers,
+          VkOffset3D { 0, 0, 0 }, cExtent,
+          cSrcSlice.buffer(), cSrcSlice.offset(),
+          4, 0);
+      });
+
+      pResource->SetMapSliceInUse(true);
+      TrackTextureMappingBufferSequenceNumber(pResource, Subresource);
+    } else {
+      UpdateTextureFromBuffer(pResource, pResource, Subresource, Subresource, offset, extent, offset);
+    }
 
     if (pResource->IsAutomaticMip())
       MarkTextureMipsDirty(pResource);
@@ -4797,6 +5174,10 @@ namespace dxvk {
 
     auto convertFormat = pDestTexture->GetFormatMapping().ConversionFormatInfo;
 
+    // Uploads must use the latest data
+    if (unlikely(pSrcTexture->HasPendingReadbacks()))
+      ResolveReadbacks(pSrcTexture, 0, 0);
+
     if (unlikely(pSrcTexture->NeedsReadback(SrcSubresource))) {
       // The src texutre has to be in POOL_SYSTEMEM, so it cannot use AUTOMIPGEN.
       // That means that NeedsReadback is only true if the texture has been used with GetRTData or GetFrontbufferData before.
@@ -4894,24 +5275,66 @@ namespace dxvk {
       VkExtent3D srcBlockCount = util::computeBlockCount(srcTexLevelExtent, srcBlockSize);
       srcBlockCount.height *= std::min(pSrcTexture->GetPlaneCount(), 2u);
 
-      // the converter can not handle the 4 aligned pitch so we always repack into a staging buffer
-      D3D9BufferSlice slice = AllocStagingBuffer(pSrcTexture->GetMipSize(SrcSubresource));
       VkDeviceSize pitch = align(srcBlockCount.width * formatElementSize, 4);
 
       const DxvkFormatInfo* convertedFormatInfo = lookupFormatInfo(convertFormat.FormatColor);      
       VkImageSubresourceLayers convertedDstLayers = { convertedFormatInfo->aspectMask, dstSubresource.mipLevel, dstSubresource.arrayLayer, 1 };
 
-      util::packImageData(
-        slice.mapPtr, mapPtr, srcBlockCount, formatElementSize,
-        pitch, std::min(pSrcTexture->GetPlaneCount(), 2u) * pitch * srcBlockCount.height);
+      uint64_t pixelCount = uint64_t(dstTexLevelExtent.width) * dstTexLevelExtent.height;
 
-      Flush();
-      SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+      if (pixelCount <= uint64_t(m_d3d9Options.cpuFormatConversionPixels)
+       && D3D9CpuFormatConverter::SupportsFormat(convertFormat.FormatType)) {
+        // Small images are converted on the CPU, which avoids
+        // having to synchronize with the CS thread for the
+        // compute pass. The converter needs tightly packed data.
+        VkDeviceSize rowSize = srcBlockCount.width * formatElementSize;
+        const void* srcData = mapPtr;
+
+        if (pitch != rowSize) {
+          m_cpuConversionBuffer.resize(rowSize * srcBlockCount.height);
+
+          util::packImageData(
+            m_cpuConversionBuffer.data(), mapPtr, srcBlockCount, formatElementSize,
+            pitch, pitch * srcBlockCount.height);
+
+          srcData = m_cpuConversionBuffer.data();
+        }
+
+        VkExtent3D dstExtent = { dstTexLevelExtent.width, dstTexLevelExtent.height, 1u };
+        D3D9BufferSlice slice = AllocStagingBuffer(pixelCount * convertedFormatInfo->elementSize);
+
+        D3D9CpuFormatConverter::ConvertFormat(convertFormat.FormatType,
+          VkExtent2D { dstExtent.width, dstExtent.height },
+          slice.mapPtr, srcData);
+
+        EmitCs([
+          cSrcSlice  = slice.slice,
+          cDstImage  = image,
+          cDstLayers = convertedDstLayers,
+          cExtent    = dstExtent
+        ] (DxvkContext* ctx) {
+          ctx->copyBufferToImage(
+            cDstImage, cDstLayers,
+            VkOffset3D { 0, 0, 0 }, cExtent,
+            cSrcSlice.buffer(), cSrcSlice.offset(),
+            1, 1);
+        });
+      } else {
+        // the converter can not handle the 4 aligned pitch so we always repack into a staging buffer
+        D3D9BufferSlice slice = AllocStagingBuffer(pSrcTexture->GetMipSize(SrcSubresource));
+
+        util::packImageData(
+          slice.mapPtr, mapPtr, srcBlockCount, formatElementSize,
+          pitch, std::min(pSrcTexture->GetPlaneCount(), 2u) * pitch * srcBlockCount.height);
+
+        Flush();
+        SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
 
-      m_converter->ConvertFormat(
-        convertFormat,
-        image, convertedDstLayers,
-        slice.slice);
+        m_converter->ConvertFormat(
+          convertFormat,
+          image, convertedDstLayers,
+          slice.slice);
+      }
     }
     UnmapTextures();
     ConsiderFlush(GpuFlushType::ImplicitWeakHint);
@@ -4938,6 +5361,7 @@ namespace dxvk {
           void**                  ppbData,
           DWORD                   Flags) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     if (unlikely(ppbData == nullptr))
       return D3DERR_INVALIDCALL;
@@ -5081,6 +5505,7 @@ namespace dxvk {
   HRESULT D3D9DeviceEx::UnlockBuffer(
         D3D9CommonBuffer*       pResource) {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Resources);
 
     if (pResource->DecrementLockCount() != 0)
       return D3D_OK;
@@ -5101,6 +5526,220 @@ namespace dxvk {
     return D3D_OK;
   }
 
+
+  HRESULT D3D9DeviceEx::ProcessVerticesCpu(
+          UINT                    SrcStartIndex,
+          UINT                    DestIndex,
+          UINT                    VertexCount,
+          D3D9CommonBuffer*       pDestBuffer,
+          D3D9VertexDecl*         pDestDecl,
+          DWORD                   Flags) {
+    if (m_state.vertexDecl == nullptr)
+      return D3DERR_NOTAVAILABLE;
+
+    std::unique_ptr<D3D9SWVPProgram> ffProgram;
+    std::array<Vector4, 4> ffConsts;
+
+    const D3D9SWVPProgram* program = nullptr;
+
+    D3D9SWVPArgs args = { };
+    args.vertexCount    = VertexCount;
+    args.positionOutput = -1;
+    args.viewport       = m_state.viewport;
+    args.floatEmulation = m_d3d9Options.d3d9FloatEmulation == D3D9FloatEmulation::Enabled;
+
+    if (UseProgrammableVS()) {
+      program = m_swvpProcessor.GetProgram(m_state.vertexShader.ptr());
+
+      args.consts     = m_state.vsConsts->fConsts;
+      args.constCount = m_vsLayout.floatCount;
+    } else {
+      // Lighting, vertex blending and texture coordinate generation
+      // or transforms are only implemented in the fixed-function shader
+      if (m_state.renderStates[D3DRS_LIGHTING]
+       || m_state.renderStates[D3DRS_VERTEXBLEND] != D3DVBF_DISABLE
+       || m_state.renderStates[D3DRS_INDEXEDVERTEXBLENDENABLE]
+       || m_state.vertexDecl->TestFlag(D3D9VertexDeclFlag::HasPositionT))
+        return D3DERR_NOTAVAILABLE;
+
+      std::array<uint32_t, 8> texcoordIndices;
+
+      for (uint32_t i = 0; i < texcoordIndices.size(); i++) {
+        const DWORD index = m_state.textureStages[i][DXVK_TSS_TEXCOORDINDEX];
+
+        if ((index & TCIMask) || (m_state.textureStages[i][DXVK_TSS_TEXTURETRANSFORMFLAGS] & ~D3DTTFF_PROJECTED))
+          return D3DERR_NOTAVAILABLE;
+
+        texcoordIndices[i] = index & 0b111;
+      }
+
+      ffProgram = D3D9SWVPProgram::CreateFixedFunction(texcoordIndices);
+      program   = ffProgram.get();
+
+      Matrix4 wvp = transpose(
+          m_state.transforms[GetTransformIndex(D3DTS_PROJECTION)]
+        * m_state.transforms[GetTransformIndex(D3DTS_VIEW)]
+        * m_state.transforms[GetTransformIndex(D3DTS_WORLD)]);
+
+      for (uint32_t i = 0; i < ffConsts.size(); i++)
+        ffConsts[i] = wvp[i];
+
+      args.consts     = ffConsts.data();
+      args.constCount = ffConsts.size();
+    }
+
+    if (program == nullptr)
+      return D3DERR_NOTAVAILABLE;
+
+    // Validate everything up front so that we never
+    // have to back out with buffers still locked
+    const auto& srcElements = m_state.vertexDecl->GetElements();
+    const auto& dstElements = pDestDecl->GetElements();
+
+    std::array<bool, caps::MaxStreams> usedStreams = { };
+
+    for (const auto& element : srcElements) {
+      if (!D3D9SWVPProcessor::SupportsType(D3DDECLTYPE(element.Type)))
+        return D3DERR_NOTAVAILABLE;
+
+      const auto& vbo = m_state.vertexBuffers[element.Stream];
+
+      if (vbo.vertexBuffer == nullptr)
+        return D3DERR_NOTAVAILABLE;
+
+      D3D9CommonBuffer* buffer = vbo.vertexBuffer->GetCommonBuffer();
+
+      if (vbo.offset + uint64_t(SrcStartIndex + VertexCount - 1) * vbo.stride
+        + element.Offset + GetDecltypeSize(D3DDECLTYPE(element.Type)) > buffer->Desc()->Size)
+        return D3DERR_NOTAVAILABLE;
+
+      usedStreams[element.Stream] = true;
+    }
+
+    for (const auto& element : dstElements) {
+      if (!D3D9SWVPProcessor::SupportsType(D3DDECLTYPE(element.Type)))
+        return D3DERR_NOTAVAILABLE;
+    }
+
+    const uint32_t dstStride = pDestDecl->GetSize(0);
+
+    if (uint64_t(DestIndex + VertexCount) * dstStride > pDestBuffer->Desc()->Size)
+      return D3DERR_NOTAVAILABLE;
+
+    std::array<uint8_t*, caps::MaxStreams> srcData = { };
+
+    for (uint32_t i = 0; i < caps::MaxStreams; i++) {
+      if (!usedStreams[i])
+        continue;
+
+      void* data = nullptr;
+
+      if (FAILED(LockBuffer(m_state.vertexBuffers[i].vertexBuffer->GetCommonBuffer(),
+          0, 0, &data, D3DLOCK_READONLY))) {
+        for (uint32_t j = 0; j < i; j++) {
+          if (usedStreams[j])
+            UnlockBuffer(m_state.vertexBuffers[j].vertexBuffer->GetCommonBuffer());
+        }
+
+        return D3DERR_INVALIDCALL;
+      }
+
+      srcData[i] = reinterpret_cast<uint8_t*>(data)
+        + m_state.vertexBuffers[i].offset
+        + SrcStartIndex * m_state.vertexBuffers[i].stride;
+    }
+
+    void* dstData = nullptr;
+
+    if (FAILED(LockBuffer(pDestBuffer, DestIndex * dstStride, VertexCount * dstStride, &dstData, 0))) {
+      for (uint32_t i = 0; i < caps::MaxStreams; i++) {
+        if (usedStreams[i])
+          UnlockBuffer(m_state.vertexBuffers[i].vertexBuffer->GetCommonBuffer());
+      }
+
+      return D3DERR_INVALIDCALL;
+    }
+
+    for (const auto& element : srcElements) {
+      D3D9SWVPElement input;
+      input.data   = srcData[element.Stream] + element.Offset;
+      input.stride = m_state.vertexBuffers[element.Stream].stride;
+      input.type   = D3DDECLTYPE(element.Type);
+
+      for (uint32_t i = 0; i < D3D9SWVPProgram::MaxInputs; i++) {
+        DxsoSemantic semantic = program->GetInputSemantic(i);
+
+        if ((program->GetInputMask() & (1u << i))
+         && semantic.usage      == DxsoUsage(element.Usage)
+         && semantic.usageIndex == element.UsageIndex) {
+          input.reg = i;
+          args.inputs.push_back(input);
+        }
+      }
+    }
+
+    for (const auto& element : dstElements) {
+      D3D9SWVPElement output;
+      output.data   = reinterpret_cast<uint8_t*>(dstData) + element.Offset;
+      output.stride = dstStride;
+      output.type   = D3DDECLTYPE(element.Type);
+      output.reg    = ~0u;
+
+      DxsoUsage usage = DxsoUsage(element.Usage);
+
+      if (usage == DxsoUsage::PositionT)
+        usage = DxsoUsage::Position;
+
+      for (uint32_t i = 0; i < D3D9SWVPProgram::MaxOutputs; i++) {
+        DxsoSemantic semantic = program->GetOutputSemantic(i);
+
+        if ((program->GetOutputMask() & (1u << i))
+         && semantic.usage      == usage
+         && semantic.usageIndex == element.UsageIndex) {
+          output.reg = i;
+          break;
+        }
+      }
+
+      if (output.reg != ~0u) {
+        if (usage == DxsoUsage::Position && element.UsageIndex == 0)
+          args.positionOutput = int32_t(output.reg);
+
+        args.outputs.push_back(output);
+        continue;
+      }
+
+      if (Flags & D3DPV_DONOTCOPYDATA)
+        continue;
+
+      // Elements that the shader does not write
+      // are copied from the source vertices
+      for (const auto& src : srcElements) {
+        if (src.Usage == element.Usage && src.UsageIndex == element.UsageIndex) {
+          D3D9SWVPElement input;
+          input.data   = srcData[src.Stream] + src.Offset;
+          input.stride = m_state.vertexBuffers[src.Stream].stride;
+          input.type   = D3DDECLTYPE(src.Type);
+          input.reg    = 0;
+
+          args.copies.push_back({ input, output });
+          break;
+        }
+      }
+    }
+
+    m_swvpProcessor.Run(*program, args);
+
+    UnlockBuffer(pDestBuffer);
+
+    for (uint32_t i = 0; i < caps::MaxStreams; i++) {
+      if (usedStreams[i])
+        UnlockBuffer(m_state.vertexBuffers[i].vertexBuffer->GetCommonBuffer());
+    }
+
+    return D3D_OK;
+  }
+
   
 
   void D3D9DeviceEx::UploadDynamicSysmemBuffers(
@@ -5414,10 +6053,15 @@ namespace dxvk {
 
     D3D9ConstantSets& constSet = m_consts[DxsoProgramType::VertexShader];
 
-    if (!constSet.dirty)
+    if (!constSet.dirty && !constSet.dirtyFloats.intersects(constSet.meta.maxConstIndexF)) {
+      if (std::exchange(constSet.redundantUpdate, false))
+        m_constSavedSize += constSet.lastUploadSize;
       return;
+    }
 
     constSet.dirty = false;
+    constSet.dirtyFloats.clear();
+    constSet.redundantUpdate = false;
 
     uint32_t floatCount = m_vsFloatConstsCount;
     if (constSet.meta.needsConstantCopies) {
@@ -5454,6 +6098,9 @@ namespace dxvk {
 
     if (likely(constSet.meta.maxConstIndexB != 0))
       CopySoftwareConstants(constSet.swvp.boolBuffer, Src.bConsts, boolDataSize);
+
+    constSet.lastUploadSize = floatDataSize + intDataSize + boolDataSize;
+    m_constUploadSize += constSet.lastUploadSize;
   }
 
 
@@ -5476,10 +6123,15 @@ namespace dxvk {
     */
     D3D9ConstantSets& constSet = m_consts[ShaderStage];
 
-    if (!constSet.dirty)
+    if (!constSet.dirty && !constSet.dirtyFloats.intersects(constSet.meta.maxConstIndexF)) {
+      if (std::exchange(constSet.redundantUpdate, false))
+        m_constSavedSize += constSet.lastUploadSize;
       return;
+    }
 
     constSet.dirty = false;
+    constSet.dirtyFloats.clear();
+    constSet.redundantUpdate = false;
 
     uint32_t floatCount = ShaderStage == DxsoProgramType::VertexShader ? m_vsFloatConstsCount : m_psFloatConstsCount;
     if (constSet.meta.needsConstantCopies) {
@@ -5513,11 +6165,16 @@ namespace dxvk {
           data[constant.uboIdx] = *reinterpret_cast<const Vector4*>(constant.float32);
       }
     }
+
+    constSet.lastUploadSize = bufferSize;
+    m_constUploadSize += bufferSize;
   }
 
 
   template <DxsoProgramType ShaderStage>
   void D3D9DeviceEx::UploadConstants() {
+    DXVK_API_TIMER(m_apiTimers, Constants);
+
     if constexpr (ShaderStage == DxsoProgramTypes::VertexShader) {
       if (CanSWVP())
         return UploadSoftwareConstantSet(m_state.vsConsts.get(), m_vsLayout);
@@ -5620,6 +6277,7 @@ namespace dxvk {
 
   void D3D9DeviceEx::Flush() {
     D3D9DeviceLock lock = LockDevice();
+    DXVK_API_TIMER(m_apiTimers, Submit);
 
     m_initializer->Flush();
     m_converter->Flush();
@@ -5639,6 +6297,12 @@ namespace dxvk {
     // Reset flush timer used for implicit flushes
     m_lastFlush = dxvk::high_resolution_clock::now();
     m_csIsBusy = false;
+
+    m_dxvkDevice->addStatCtr(DxvkStatCounter::ApiConstantUploadSize, std::exchange(m_constUploadSize, 0));
+    m_dxvkDevice->addStatCtr(DxvkStatCounter::ApiConstantSavedSize,  std::exchange(m_constSavedSize,  0));
+    m_dxvkDevice->addStatCtr(DxvkStatCounter::ApiTextureUploadSize,  std::exchange(m_textureUploadSize, 0));
+
+    m_apiTimers.flush(m_dxvkDevice.ptr());
   }
 
 
@@ -5844,7 +6508,7 @@ namespace dxvk {
       if (!pResource->NeedsUpload(subresource))
         continue;
 
-      this->FlushImage(pResource, subresource);
+      this->UploadManagedSubresource(pResource, subresource);
     }
 
     pResource->ClearDirtyBoxes();
@@ -5852,6 +6516,40 @@ namespace dxvk {
   }
 
 
+  void D3D9DeviceEx::UploadManagedSubresource(
+          D3D9CommonTexture*      pResource,
+          UINT                    Subresource) {
+    const D3D9UploadBoxes& boxes = pResource->GetUploadBoxes(Subresource);
+
+    if (likely(pResource->GetFormatMapping().ConversionFormatInfo.FormatType == D3D9ConversionFormat_None)) {
+      auto formatInfo = lookupFormatInfo(pResource->GetFormatMapping().FormatColor);
+
+      for (uint32_t i = 0; i < boxes.count; i++) {
+        VkOffset3D offset;
+        VkExtent3D extent;
+        ConvertBox(boxes.boxes[i], offset, extent);
+
+        UpdateTextureFromBuffer(pResource, pResource, Subresource, Subresource, offset, extent, offset);
+
+        VkExtent3D blockCount = util::computeBlockCount(extent, formatInfo->blockSize);
+        m_textureUploadSize += uint64_t(formatInfo->elementSize)
+          * blockCount.width * blockCount.height * blockCount.depth;
+      }
+    } else {
+      // The format converter always processes the entire subresource
+      VkExtent3D extent = pResource->GetExtentMip(Subresource);
+      UpdateTextureFromBuffer(pResource, pResource, Subresource, Subresource, VkOffset3D(), extent, VkOffset3D());
+
+      m_textureUploadSize += pResource->GetMipSize(Subresource);
+    }
+
+    pResource->ClearUploadBoxes(Subresource);
+
+    if (pResource->IsAutomaticMip())
+      MarkTextureMipsDirty(pResource);
+  }
+
+
   void D3D9DeviceEx::UploadManagedTextures(uint32_t mask) {
     // Guaranteed to not be nullptr...
     for (uint32_t texIdx : bit::BitMask(mask))
@@ -6694,6 +7392,8 @@ namespace dxvk {
 
 
   void D3D9DeviceEx::PrepareDraw(D3DPRIMITIVETYPE PrimitiveType, bool UploadVBOs, bool UploadIBO) {
+    DXVK_API_TIMER(m_apiTimers, PrepareDraw);
+
     if (unlikely(m_activeHazardsRT != 0 || m_activeHazardsDS != 0))
       MarkRenderHazards();
 
@@ -6875,6 +7575,8 @@ namespace dxvk {
   void D3D9DeviceEx::BindShader(
       const D3D9CommonShader* pShaderModule,
       D3D9ShaderPermutation   Permutation) {
+      DXVK_API_TIMER(m_apiTimers, Shaders);
+
       EmitCs([
         cShader = pShaderModule->GetShader(Permutation)
       ] (DxvkContext* ctx) {
@@ -7086,6 +7788,39 @@ namespace dxvk {
   }
 
 
+  template <
+    DxsoProgramType  ProgramType,
+    D3D9ConstantType ConstantType,
+    typename         T>
+    bool D3D9DeviceEx::ShaderConstantsChanged(
+            UINT  StartRegister,
+      const T*    pConstantData,
+            UINT  Count) const {
+    auto CompareHelper = [&] (const auto& set) {
+      if constexpr (ConstantType == D3D9ConstantType::Float) {
+        if (m_d3d9Options.d3d9FloatEmulation == D3D9FloatEmulation::Enabled) {
+          for (UINT i = 0; i < Count; i++) {
+            Vector4 value = replaceNaN(pConstantData + (i * 4));
+
+            if (std::memcmp(&set->fConsts[StartRegister + i], &value, sizeof(value)))
+              return true;
+          }
+
+          return false;
+        }
+
+        return std::memcmp(set->fConsts[StartRegister].data, pConstantData, Count * sizeof(Vector4)) != 0;
+      } else {
+        return std::memcmp(set->iConsts[StartRegister].data, pConstantData, Count * sizeof(Vector4i)) != 0;
+      }
+    };
+
+    return ProgramType == DxsoProgramTypes::VertexShader
+      ? CompareHelper(m_state.vsConsts)
+      : CompareHelper(m_state.psConsts);
+  }
+
+
   template <
     DxsoProgramType  ProgramType,
     D3D9ConstantType ConstantType,
@@ -7094,6 +7829,8 @@ namespace dxvk {
             UINT  StartRegister,
       const T*    pConstantData,
             UINT  Count) {
+    DXVK_API_TIMER(m_apiTimers, Constants);
+
     const     uint32_t regCountHardware = DetermineHardwareRegCount<ProgramType, ConstantType>();
     constexpr uint32_t regCountSoftware = DetermineSoftwareRegCount<ProgramType, ConstantType>();
 
@@ -7117,6 +7854,19 @@ namespace dxvk {
         pConstantData,
         Count);
 
+    // Many games set the same constants for every draw. Skip these
+    // updates so that they do not force a constant buffer upload.
+    if constexpr (ConstantType != D3D9ConstantType::Bool) {
+      if (!ShaderConstantsChanged<ProgramType, ConstantType, T>(StartRegister, pConstantData, Count)) {
+        uint32_t maxCount = ConstantType == D3D9ConstantType::Float
+          ? m_consts[ProgramType].meta.maxConstIndexF
+          : m_consts[ProgramType].meta.maxConstIndexI;
+
+        m_consts[ProgramType].redundantUpdate |= StartRegister < maxCount;
+        return D3D_OK;
+      }
+    }
+
     if constexpr (ProgramType == DxsoProgramType::VertexShader) {
       if constexpr (ConstantType == D3D9ConstantType::Float) {
         m_vsFloatConstsCount = std::max(m_vsFloatConstsCount, StartRegister + Count);
@@ -7131,12 +7881,12 @@ namespace dxvk {
       }
     }
 
-    if constexpr (ConstantType != D3D9ConstantType::Bool) {
-      uint32_t maxCount = ConstantType == D3D9ConstantType::Float
-        ? m_consts[ProgramType].meta.maxConstIndexF
-        : m_consts[ProgramType].meta.maxConstIndexI;
-
-      m_consts[ProgramType].dirty |= StartRegister < maxCount;
+    if constexpr (ConstantType == D3D9ConstantType::Float) {
+      // Whether the update affects the shader is checked
+      // at upload time, since the shader may still change
+      m_consts[ProgramType].dirtyFloats.add(StartRegister, Count);
+    } else if constexpr (ConstantType == D3D9ConstantType::Int) {
+      m_consts[ProgramType].dirty |= StartRegister < m_consts[ProgramType].meta.maxConstIndexI;
     } else if constexpr (ProgramType == DxsoProgramType::VertexShader) {
       if (unlikely(CanSWVP())) {
         m_consts[DxsoProgramType::VertexShader].dirty |= StartRegister < m_consts[ProgramType].meta.maxConstIndexB;
@@ -7947,7 +8697,8 @@ namespace dxvk {
     // We do not flush empty chunks, so if we are tracking a resource
     // immediately after a flush, we need to use the sequence number
     // of the previously submitted chunk to prevent deadlocks.
-    return m_csChunk->empty() ? m_csSeqNum : m_csSeqNum + 1;
+    return m_csChunk->empty() && !m_upBatch.drawCount && !m_drawBatch.drawCount
+      ? m_csSeqNum : m_csSeqNum + 1;
   }
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../dxvk/dxvk_api_timers.h"
 #include "../dxvk/dxvk_device.h"
 #include "../dxvk/dxvk_cs.h"
 #include "../dxvk/dxvk_staging.h"
@@ -25,6 +26,7 @@
 #include "d3d9_sampler.h"
 #include "d3d9_fixed_function.h"
 #include "d3d9_swvp_emu.h"
+#include "d3d9_swvp_cpu.h"
 
 #include "d3d9_spec_constants.h"
 
@@ -107,6 +109,47 @@ namespace dxvk {
     void*           mapPtr = nullptr;
   };
 
+  /**
+   * \brief Pending batch of UP draws
+   *
+   * Vertex data of all draws is stored back to back in the
+   * UP buffer, indices are rebased and kept on the CPU until
+   * the batch is flushed. The batch must be flushed before
+   * any other command is recorded, which guarantees that
+   * all merged draws use the same state.
+   */
+  struct D3D9UPBatch {
+    D3DPRIMITIVETYPE      primType    = D3DPT_TRIANGLELIST;
+    uint32_t              stride      = 0;
+    bool                  indexed     = false;
+    VkIndexType           indexType   = VK_INDEX_TYPE_UINT16;
+    DxvkBufferSlice       slice       = {};
+    uint8_t*              mapPtr      = nullptr;
+    VkDeviceSize          dataSize    = 0;
+    uint32_t              vertexCount = 0;
+    uint32_t              drawCount   = 0;
+    std::vector<uint8_t>  indices;
+  };
+
+  /**
+   * \brief Pending batch of indexed draws
+   *
+   * Indexed draws that are recorded back to back with no
+   * other command in between use the same state, and only
+   * differ in their index and vertex ranges. These get
+   * merged into one indirect draw when the batch is
+   * flushed. Like the UP batch, this must be flushed
+   * before any other command is recorded.
+   */
+  struct D3D9DrawBatch {
+    constexpr static uint32_t MaxDraws = 128;
+
+    D3DPRIMITIVETYPE      primType      = D3DPT_TRIANGLELIST;
+    uint32_t              instanceCount = 0;
+    uint32_t              drawCount     = 0;
+    std::array<VkDrawIndexedIndirectCommand, MaxDraws> draws;
+  };
+
   struct D3D9StagingBufferMarkerPayload {
     uint64_t        sequenceNumber;
     VkDeviceSize    allocated;
@@ -125,6 +168,7 @@ namespace dxvk {
     constexpr static uint32_t NullStreamIdx = caps::MaxStreams;
 
     constexpr static VkDeviceSize StagingBufferSize = 4ull << 20;
+    constexpr static VkDeviceSize UPBufferSize      = 1ull << 20;
 
     friend class D3D9SwapChainEx;
     friend struct D3D9WindowContext;
@@ -686,6 +730,10 @@ namespace dxvk {
       return m_dxvkDevice;
     }
 
+    DxvkApiTimers& GetApiTimers() {
+      return m_apiTimers;
+    }
+
     D3D9_VK_FORMAT_MAPPING LookupFormat(
       D3D9Format            Format) const;
 
@@ -697,6 +745,23 @@ namespace dxvk {
             uint64_t                          SequenceNumber,
             DWORD                             MapFlags);
 
+    /**
+     * \brief Makes asynchronous readbacks visible
+     *
+     * Picks the most recent readback that has completed on the
+     * GPU, and only waits if the mapped data would otherwise be
+     * more than the given number of readbacks behind.
+     * \param [in] pResource Readback destination
+     * \param [in] Latency Maximum number of readbacks to lag behind
+     * \param [in] MapFlags Lock flags
+     * \returns \c false if the resource was still in use and
+     *    \c D3DLOCK_DONOTWAIT was specified
+     */
+    bool ResolveReadbacks(
+            D3D9CommonTexture*                pResource,
+            uint32_t                          Latency,
+            DWORD                             MapFlags);
+
     /**
      * \brief Locks a subresource of an image
      * 
@@ -761,6 +826,21 @@ namespace dxvk {
     HRESULT UnlockBuffer(
             D3D9CommonBuffer*       pResource);
 
+    /**
+     * \brief Runs ProcessVertices on the CPU
+     *
+     * \returns \c D3DERR_NOTAVAILABLE if the current vertex shader
+     *    or state is not supported by the CPU path, and
+     *    \c D3DERR_INVALIDCALL if a buffer cannot be locked
+     */
+    HRESULT ProcessVerticesCpu(
+            UINT                    SrcStartIndex,
+            UINT                    DestIndex,
+            UINT                    VertexCount,
+            D3D9CommonBuffer*       pDestBuffer,
+            D3D9VertexDecl*         pDestDecl,
+            DWORD                   Flags);
+
     /**
      * @brief Uploads data from D3DPOOL_SYSMEM + D3DUSAGE_DYNAMIC buffers and binds the temporary buffers.
      * 
@@ -810,6 +890,18 @@ namespace dxvk {
 
     void UploadManagedTexture(D3D9CommonTexture* pResource);
 
+    /**
+     * \brief Uploads dirty regions of a managed subresource
+     *
+     * Copies the regions recorded via \c AddUploadBox
+     * from the staging buffer and clears them.
+     * \param [in] pResource Managed texture
+     * \param [in] Subresource Subresource index
+     */
+    void UploadManagedSubresource(
+            D3D9CommonTexture*      pResource,
+            UINT                    Subresource);
+
     void UploadManagedTextures(uint32_t mask);
 
     void GenerateTextureMips(uint32_t mask);
@@ -939,6 +1031,10 @@ namespace dxvk {
       return &m_state;
     }
 
+    bool IsRecording() const {
+      return m_recorder != nullptr;
+    }
+
     void Begin(D3D9Query* pQuery);
     void End(D3D9Query* pQuery);
 
@@ -1018,6 +1114,12 @@ namespace dxvk {
 
     template<bool AllowFlush = true, typename Cmd>
     void EmitCs(Cmd&& command) {
+      if (unlikely(m_upBatch.drawCount))
+        FlushUPBatch();
+
+      if (unlikely(m_drawBatch.drawCount))
+        FlushDrawBatch();
+
       if (unlikely(!m_csChunk->push(command))) {
         EmitCsChunk(std::move(m_csChunk));
         m_csChunk = AllocCsChunk();
@@ -1032,6 +1134,12 @@ namespace dxvk {
     void EmitCsChunk(DxvkCsChunkRef&& chunk);
 
     void FlushCsChunk() {
+      if (unlikely(m_upBatch.drawCount))
+        FlushUPBatch();
+
+      if (unlikely(m_drawBatch.drawCount))
+        FlushDrawBatch();
+
       if (likely(!m_csChunk->empty())) {
         EmitCsChunk(std::move(m_csChunk));
         m_csChunk = AllocCsChunk();
@@ -1057,6 +1165,41 @@ namespace dxvk {
 
     D3D9BufferSlice AllocUPBuffer(VkDeviceSize size);
 
+    /**
+     * \brief Adds a UP draw to the pending batch
+     *
+     * Starts a new batch if the draw cannot be merged
+     * with the pending one. Must be called after the
+     * draw state has been applied.
+     * \returns \c false if the draw cannot be batched
+     */
+    bool BatchUPDraw(
+            D3DPRIMITIVETYPE        PrimitiveType,
+            UINT                    VertexCount,
+      const void*                   pVertexData,
+            UINT                    Stride,
+            UINT                    IndexCount,
+      const void*                   pIndexData,
+            D3DFORMAT               IndexFormat);
+
+    void FlushUPBatch();
+
+    /**
+     * \brief Adds an indexed draw to the pending batch
+     *
+     * Starts a new batch if the draw cannot be merged
+     * with the pending one. Must be called after the
+     * draw state has been applied.
+     * \returns \c false if the draw cannot be batched
+     */
+    bool BatchIndexedDraw(
+            D3DPRIMITIVETYPE        PrimitiveType,
+            UINT                    IndexCount,
+            UINT                    StartIndex,
+            INT                     BaseVertexIndex);
+
+    void FlushDrawBatch();
+
     D3D9BufferSlice AllocStagingBuffer(VkDeviceSize size);
 
     void EmitStagingBufferMarker();
@@ -1139,6 +1282,15 @@ namespace dxvk {
         const T*    pConstantData,
               UINT  Count);
 
+    template <
+      DxsoProgramType  ProgramType,
+      D3D9ConstantType ConstantType,
+      typename         T>
+      bool ShaderConstantsChanged(
+              UINT  StartRegister,
+        const T*    pConstantData,
+              UINT  Count) const;
+
     template <
       DxsoProgramType  ProgramType,
       D3D9ConstantType ConstantType,
@@ -1242,6 +1394,7 @@ namespace dxvk {
 
     D3D9Adapter*                    m_adapter;
     Rc<DxvkDevice>                  m_dxvkDevice;
+    DxvkApiTimers                   m_apiTimers;
 
     D3D9MemoryAllocator             m_memoryAllocator;
 
@@ -1254,9 +1407,10 @@ namespace dxvk {
 
     D3D9Initializer*                m_initializer = nullptr;
     D3D9FormatHelper*               m_converter   = nullptr;
+    std::vector<uint8_t>            m_cpuConversionBuffer;
 
     D3D9FFShaderModuleSet           m_ffModules;
-    D3D9SWVPEmulator                m_swvpEmulator;
+    D3D9SWVPProcessor               m_swvpProcessor;
 
     Com<D3D9StateBlock, false>      m_recorder;
 
@@ -1272,6 +1426,8 @@ namespace dxvk {
     Rc<DxvkBuffer>                  m_upBuffer;
     VkDeviceSize                    m_upBufferOffset  = 0ull;
     void*                           m_upBufferMapPtr  = nullptr;
+    D3D9UPBatch                     m_upBatch;
+    D3D9DrawBatch                   m_drawBatch;
 
     DxvkStagingBuffer               m_stagingBuffer;
     VkDeviceSize                    m_stagingBufferAllocated      = 0ull;
@@ -1366,6 +1522,9 @@ namespace dxvk {
     uint32_t                        m_psFloatConstsCount = 0;
     VkDeviceSize                    m_boundVSConstantsBufferSize = 0;
     VkDeviceSize                    m_boundPSConstantsBufferSize = 0;
+    uint64_t                        m_constUploadSize = 0;
+    uint64_t                        m_constSavedSize  = 0;
+    uint64_t                        m_textureUploadSize = 0;
 
     D3D9ConstantLayout              m_vsLayout;
     D3D9ConstantLayout              m_psLayout;
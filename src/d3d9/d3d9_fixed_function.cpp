@@ -6,6 +6,7 @@
 
 #include "../dxvk/dxvk_hash.h"
 #include "../dxvk/dxvk_spec_const.h"
+#include "../dxvk/dxvk_state_cache.h"
 
 #include "../spirv/spirv_module.h"
 
@@ -2446,20 +2447,232 @@ namespace dxvk {
   }
 
 
+  struct D3D9FFShaderCacheHeader {
+    char     magic[4]   = { 'D','X','F','F' };
+    uint32_t version    = 2;
+    uint32_t keySizeVS  = sizeof(D3D9FFShaderKeyVS);
+    uint32_t keySizeFS  = sizeof(D3D9FFShaderKeyFS);
+  };
+
+  static_assert(sizeof(D3D9FFShaderCacheHeader) == 16);
+
+
+  struct D3D9FFShaderCacheEntryHeader {
+    uint32_t stage;
+    uint32_t size;
+  };
+
+  static_assert(sizeof(D3D9FFShaderCacheEntryHeader) == 8);
+
+
+  D3D9FFShaderCacheFile::D3D9FFShaderCacheFile() {
+    std::string dir = DxvkStateCache::getCacheDir();
+    std::string path = dir;
+
+    if (!path.empty() && *path.rbegin() != '/')
+      path += '/';
+
+    path += env::getExeBaseName() + ".dxvk-ff-cache";
+
+    if (ReadFile(path)) {
+      m_file.open(str::topath(path.c_str()).c_str(),
+        std::ios_base::binary | std::ios_base::app);
+    } else {
+      // Start over in case the file is missing or invalid
+      m_file.open(str::topath(path.c_str()).c_str(),
+        std::ios_base::binary | std::ios_base::trunc);
+
+      if (!m_file && env::createDirectory(dir)) {
+        m_file.open(str::topath(path.c_str()).c_str(),
+          std::ios_base::binary | std::ios_base::trunc);
+      }
+
+      D3D9FFShaderCacheHeader header;
+      m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      // Write back all valid entries in case
+      // we're recovering a corrupted file
+      for (const auto& key : m_keysVS)
+        WriteEntry(VK_SHADER_STAGE_VERTEX_BIT, key);
+
+      for (const auto& key : m_keysFS)
+        WriteEntry(VK_SHADER_STAGE_FRAGMENT_BIT, key);
+    }
+
+    if (!m_file)
+      Logger::warn(str::format("D3D9: Failed to open ", path));
+  }
+
+
+  D3D9FFShaderCacheFile::~D3D9FFShaderCacheFile() {
+
+  }
+
+
+  void D3D9FFShaderCacheFile::AddKey(const D3D9FFShaderKeyVS& Key) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    if (m_setVS.insert(Key).second)
+      WriteEntry(VK_SHADER_STAGE_VERTEX_BIT, Key);
+  }
+
+
+  void D3D9FFShaderCacheFile::AddKey(const D3D9FFShaderKeyFS& Key) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    if (m_setFS.insert(Key).second)
+      WriteEntry(VK_SHADER_STAGE_FRAGMENT_BIT, Key);
+  }
+
+
+  Rc<D3D9FFShaderCacheFile> D3D9FFShaderCacheFile::GetInstance() {
+    static dxvk::mutex               s_mutex;
+    static Rc<D3D9FFShaderCacheFile> s_instance;
+
+    std::lock_guard<dxvk::mutex> lock(s_mutex);
+
+    if (s_instance == nullptr)
+      s_instance = new D3D9FFShaderCacheFile();
+
+    return s_instance;
+  }
+
+
+  bool D3D9FFShaderCacheFile::ReadFile(
+    const std::string&          FileName) {
+    std::ifstream file(str::topath(FileName.c_str()).c_str(), std::ios_base::binary);
+
+    if (!file)
+      return false;
+
+    D3D9FFShaderCacheHeader expected;
+    D3D9FFShaderCacheHeader header;
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+     || std::memcmp(&header, &expected, sizeof(header))) {
+      Logger::warn("D3D9: Fixed-function shader cache out of date");
+      return false;
+    }
+
+    D3D9FFShaderCacheEntryHeader entry;
+    bool valid = true;
+
+    while (file.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+      if (entry.stage == VK_SHADER_STAGE_VERTEX_BIT && entry.size == sizeof(D3D9FFShaderKeyVS)) {
+        D3D9FFShaderKeyVS key;
+
+        if (!file.read(reinterpret_cast<char*>(&key), sizeof(key))) {
+          valid = false;
+          break;
+        }
+
+        if (m_setVS.insert(key).second)
+          m_keysVS.push_back(key);
+      } else if (entry.stage == VK_SHADER_STAGE_FRAGMENT_BIT && entry.size == sizeof(D3D9FFShaderKeyFS)) {
+        D3D9FFShaderKeyFS key;
+
+        if (!file.read(reinterpret_cast<char*>(&key), sizeof(key))) {
+          valid = false;
+          break;
+        }
+
+        if (m_setFS.insert(key).second)
+          m_keysFS.push_back(key);
+      } else {
+        valid = false;
+        break;
+      }
+    }
+
+    // Entries are only ever appended, so anything other than
+    // a clean end of file is the result of corruption, e.g. a
+    // process getting killed while writing an entry.
+    if (!valid || file.gcount() != 0) {
+      Logger::warn("D3D9: Fixed-function shader cache corrupted");
+      return false;
+    }
+
+    return true;
+  }
+
+
+  template<typename T>
+  void D3D9FFShaderCacheFile::WriteEntry(
+          VkShaderStageFlagBits Stage,
+    const T&                    Key) {
+    if (!m_file)
+      return;
+
+    D3D9FFShaderCacheEntryHeader entry;
+    entry.stage = uint32_t(Stage);
+    entry.size  = sizeof(Key);
+
+    m_file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    m_file.write(reinterpret_cast<const char*>(&Key), sizeof(Key));
+    m_file.flush();
+  }
+
+
+  D3D9FFShaderModuleSet::D3D9FFShaderModuleSet() {
+
+  }
+
+
+  D3D9FFShaderModuleSet::~D3D9FFShaderModuleSet() {
+    StopPrecompile();
+  }
+
+
+  void D3D9FFShaderModuleSet::Initialize(
+          D3D9DeviceEx*         pDevice) {
+    if (!pDevice->GetDXVKDevice()->hasStateCache())
+      return;
+
+    m_cache = D3D9FFShaderCacheFile::GetInstance();
+
+    if (m_cache->GetKeysVS().empty() && m_cache->GetKeysFS().empty())
+      return;
+
+    Logger::info(str::format("D3D9: Precompiling ",
+      m_cache->GetKeysVS().size(), " fixed-function vertex shaders and ",
+      m_cache->GetKeysFS().size(), " fixed-function pixel shaders"));
+
+    m_thread = dxvk::thread([this, pDevice] { RunPrecompile(pDevice); });
+  }
+
+
+  void D3D9FFShaderModuleSet::StopPrecompile() {
+    m_stopped.store(true);
+
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+
   D3D9FFShader D3D9FFShaderModuleSet::GetShaderModule(
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyVS&    ShaderKey) {
     // Use the shader's unique key for the lookup
-    auto entry = m_vsModules.find(ShaderKey);
-    if (entry != m_vsModules.end())
-      return entry->second;
-    
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      auto entry = m_vsModules.find(ShaderKey);
+      if (entry != m_vsModules.end())
+        return entry->second;
+    }
+
+    // Compile without holding the lock so that we don't
+    // wait for the precompile thread. If both end up
+    // compiling the shader, the first one wins.
     D3D9FFShader shader(
       pDevice, ShaderKey);
 
-    m_vsModules.insert({ShaderKey, shader});
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    auto entry = m_vsModules.insert({ShaderKey, shader});
 
-    return shader;
+    if (entry.second && m_cache != nullptr)
+      m_cache->AddKey(ShaderKey);
+
+    return entry.first->second;
   }
 
 
@@ -2467,16 +2680,61 @@ namespace dxvk {
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyFS&    ShaderKey) {
     // Use the shader's unique key for the lookup
-    auto entry = m_fsModules.find(ShaderKey);
-    if (entry != m_fsModules.end())
-      return entry->second;
-    
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      auto entry = m_fsModules.find(ShaderKey);
+      if (entry != m_fsModules.end())
+        return entry->second;
+    }
+
     D3D9FFShader shader(
       pDevice, ShaderKey);
 
-    m_fsModules.insert({ShaderKey, shader});
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    auto entry = m_fsModules.insert({ShaderKey, shader});
+
+    if (entry.second && m_cache != nullptr)
+      m_cache->AddKey(ShaderKey);
+
+    return entry.first->second;
+  }
 
-    return shader;
+
+  void D3D9FFShaderModuleSet::RunPrecompile(
+          D3D9DeviceEx*         pDevice) {
+    env::setThreadName("dxvk-ff-cache");
+
+    for (const auto& key : m_cache->GetKeysVS()) {
+      if (m_stopped.load())
+        return;
+
+      { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+        if (m_vsModules.find(key) != m_vsModules.end())
+          continue;
+      }
+
+      D3D9FFShader shader(pDevice, key);
+
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
+      m_vsModules.insert({ key, shader });
+    }
+
+    for (const auto& key : m_cache->GetKeysFS()) {
+      if (m_stopped.load())
+        return;
+
+      { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+        if (m_fsModules.find(key) != m_fsModules.end())
+          continue;
+      }
+
+      D3D9FFShader shader(pDevice, key);
+
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
+      m_fsModules.insert({ key, shader });
+    }
   }
 
 
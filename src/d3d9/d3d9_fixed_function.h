@@ -8,8 +8,12 @@
 
 #include "../dxso/dxso_isgn.h"
 
-#include <unordered_map>
+#include <atomic>
 #include <bitset>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace dxvk {
 
@@ -220,10 +224,126 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Fixed-function shader key cache file
+   *
+   * Stores the keys of all fixed-function shaders that
+   * were compiled in previous runs. Shared by all devices
+   * in the process, so that they append to a single file
+   * without duplicating or interleaving entries.
+   */
+  class D3D9FFShaderCacheFile : public RcObject {
+
+  public:
+
+    D3D9FFShaderCacheFile();
+
+    ~D3D9FFShaderCacheFile();
+
+    /**
+     * \brief Vertex shader keys read from the file
+     * \returns Keys, never modified after creation
+     */
+    const std::vector<D3D9FFShaderKeyVS>& GetKeysVS() const {
+      return m_keysVS;
+    }
+
+    /**
+     * \brief Pixel shader keys read from the file
+     * \returns Keys, never modified after creation
+     */
+    const std::vector<D3D9FFShaderKeyFS>& GetKeysFS() const {
+      return m_keysFS;
+    }
+
+    /**
+     * \brief Appends a key to the file
+     *
+     * Does nothing if the key is already known.
+     * \param [in] Key Shader key
+     */
+    void AddKey(const D3D9FFShaderKeyVS& Key);
+
+    /**
+     * \brief Appends a key to the file
+     *
+     * Does nothing if the key is already known.
+     * \param [in] Key Shader key
+     */
+    void AddKey(const D3D9FFShaderKeyFS& Key);
+
+    /**
+     * \brief Retrieves the cache file of this process
+     *
+     * Opens the file on first use. Only call this
+     * if the state cache is enabled.
+     * \returns Shared cache file
+     */
+    static Rc<D3D9FFShaderCacheFile> GetInstance();
+
+  private:
+
+    dxvk::mutex                   m_mutex;
+
+    std::vector<D3D9FFShaderKeyVS> m_keysVS;
+    std::vector<D3D9FFShaderKeyFS> m_keysFS;
+
+    std::unordered_set<
+      D3D9FFShaderKeyVS,
+      D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_setVS;
+
+    std::unordered_set<
+      D3D9FFShaderKeyFS,
+      D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_setFS;
+
+    std::ofstream                 m_file;
+
+    bool ReadFile(
+      const std::string&          FileName);
+
+    template<typename T>
+    void WriteEntry(
+            VkShaderStageFlagBits Stage,
+      const T&                    Key);
+
+  };
+
+
+  /**
+   * \brief Fixed-function shader module set
+   *
+   * Caches fixed-function shaders by key. If the state
+   * cache is enabled, keys are also written to disk so
+   * that shaders seen in previous runs can be compiled
+   * on a background thread at device creation, which
+   * in turn lets the state cache compile pipelines
+   * before the shaders are used for the first time.
+   */
   class D3D9FFShaderModuleSet : public RcObject {
 
   public:
 
+    D3D9FFShaderModuleSet();
+
+    ~D3D9FFShaderModuleSet();
+
+    /**
+     * \brief Loads cached keys and starts precompiling
+     *
+     * Does nothing if the state cache is disabled.
+     * \param [in] pDevice Device
+     */
+    void Initialize(
+            D3D9DeviceEx*         pDevice);
+
+    /**
+     * \brief Stops precompiling shaders
+     *
+     * Must be called before the device is destroyed,
+     * since compiling shaders accesses device state.
+     */
+    void StopPrecompile();
+
     D3D9FFShader GetShaderModule(
             D3D9DeviceEx*         pDevice,
       const D3D9FFShaderKeyVS&    ShaderKey);
@@ -234,6 +354,8 @@ namespace dxvk {
 
   private:
 
+    dxvk::mutex                   m_mutex;
+
     std::unordered_map<
       D3D9FFShaderKeyVS,
       D3D9FFShader,
@@ -244,6 +366,14 @@ namespace dxvk {
       D3D9FFShader,
       D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_fsModules;
 
+    Rc<D3D9FFShaderCacheFile>     m_cache;
+
+    std::atomic<bool>             m_stopped = { false };
+    dxvk::thread                  m_thread;
+
+    void RunPrecompile(
+            D3D9DeviceEx*         pDevice);
+
   };
 
 
@@ -0,0 +1,530 @@
+#include "d3d9_format_convert_cpu.h"
+
+#include "../util/util_bit.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace dxvk {
+
+  /**
+   * \brief YUV to RGB transform
+   *
+   * Each channel is computed as a dot product
+   * of (y, u, v, 1) with the given coefficients.
+   */
+  struct D3D9YuvTransform {
+    float r[4];
+    float g[4];
+    float b[4];
+  };
+
+  // Matches g_yuv_to_rgb in d3d9_convert_common.h. Note that
+  // the shader computes the coefficients with integer divisions.
+  static const D3D9YuvTransform g_yuvTransform = {
+    { float(298 / 256), float(   0 / 256), float( 409 / 256), 0.5f * (1.0f / 255.0f) },
+    { float(298 / 256), float(-100 / 256), float(-208 / 256), 0.5f * (1.0f / 255.0f) },
+    { float(298 / 256), float( 516 / 256), float(   0 / 256), 0.5f * (1.0f / 255.0f) },
+  };
+
+  // Matches g_bt709_to_rgb in d3d9_convert_common.h
+  static const D3D9YuvTransform g_bt709Transform = {
+    { 1.164f,  0.000f,  1.793f, 0.0f },
+    { 1.164f, -0.213f, -0.533f, 0.0f },
+    { 1.164f,  2.112f,  0.000f, 0.0f },
+  };
+
+
+  static float UnpackUnorm(uint32_t Value, float Bias) {
+    return float(Value) / 255.0f - Bias;
+  }
+
+
+  static uint32_t PackUnorm8(float Value) {
+    return uint32_t(std::min(std::max(Value, 0.0f), 1.0f) * 255.0f + 0.5f);
+  }
+
+
+  static uint32_t TransformYuv(
+    const D3D9YuvTransform&             Transform,
+          float                         Y,
+          float                         U,
+          float                         V) {
+    auto channel = [=] (const float* c) {
+      return PackUnorm8(Y * c[0] + U * c[1] + V * c[2] + c[3]);
+    };
+
+    // B8G8R8A8, with alpha set to one
+    return channel(Transform.b)
+        | (channel(Transform.g) << 8)
+        | (channel(Transform.r) << 16)
+        | 0xff000000u;
+  }
+
+
+#ifdef DXVK_ARCH_X86
+  static __m128 UnpackUnormSse(__m128i Value, float Bias) {
+    return _mm_sub_ps(
+      _mm_div_ps(_mm_cvtepi32_ps(Value), _mm_set1_ps(255.0f)),
+      _mm_set1_ps(Bias));
+  }
+
+
+  static __m128i TransformYuvSse(
+    const D3D9YuvTransform&             Transform,
+          __m128                        Y,
+          __m128                        U,
+          __m128                        V) {
+    auto channel = [=] (const float* c) {
+      __m128 x = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+        _mm_mul_ps(Y, _mm_set1_ps(c[0])),
+        _mm_mul_ps(U, _mm_set1_ps(c[1]))),
+        _mm_mul_ps(V, _mm_set1_ps(c[2]))),
+        _mm_set1_ps(c[3]));
+
+      x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+      x = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+      return _mm_cvttps_epi32(x);
+    };
+
+    return _mm_or_si128(
+      _mm_or_si128(channel(Transform.b), _mm_slli_epi32(channel(Transform.g), 8)),
+      _mm_or_si128(_mm_slli_epi32(channel(Transform.r), 16), _mm_set1_epi32(int32_t(0xff000000u))));
+  }
+#endif
+
+
+  static int32_t ExtractSigned(uint32_t Value, uint32_t Offset, uint32_t Bits) {
+    return int32_t(Value << (32 - Offset - Bits)) >> (32 - Bits);
+  }
+
+
+  static uint32_t ExtractUnsigned(uint32_t Value, uint32_t Offset, uint32_t Bits) {
+    return (Value >> Offset) & ((1u << Bits) - 1u);
+  }
+
+
+  static float Snormalize(int32_t Value, uint32_t Bits) {
+    return std::max(float(Value) / float((1 << (Bits - 1)) - 1), -1.0f);
+  }
+
+
+  static float Unormalize(uint32_t Value, uint32_t Bits) {
+    return float(Value) / float((1u << Bits) - 1u);
+  }
+
+
+  static uint16_t FloatToHalf(float Value) {
+    uint32_t bits;
+    std::memcpy(&bits, &Value, sizeof(bits));
+
+    uint16_t sign = uint16_t((bits >> 16) & 0x8000u);
+    uint32_t abs  = bits & 0x7fffffffu;
+
+    if (abs > 0x7f800000u)
+      return sign | 0x7e00u;
+
+    // Anything from 65520 upwards rounds to infinity
+    if (abs >= 0x477ff000u)
+      return sign | 0x7c00u;
+
+    // Denormals, scaling by a power of two is exact
+    if (abs < 0x38800000u) {
+      float absValue;
+      std::memcpy(&absValue, &abs, sizeof(abs));
+      return sign | uint16_t(std::nearbyint(absValue * 16777216.0f));
+    }
+
+    // Round to nearest even, may carry into the exponent
+    uint32_t result = (((abs >> 23) - 112u) << 10) | ((abs >> 13) & 0x3ffu);
+    uint32_t rest   = abs & 0x1fffu;
+
+    if (rest > 0x1000u || (rest == 0x1000u && (result & 1u)))
+      result += 1;
+
+    return sign | uint16_t(result);
+  }
+
+
+  static uint16_t FloatToSnorm16(float Value) {
+    float clamped = std::min(std::max(Value, -1.0f), 1.0f);
+    return uint16_t(int16_t(std::nearbyint(clamped * 32767.0f)));
+  }
+
+
+#ifdef DXVK_ARCH_X86
+  static __m128i SelectSse(__m128i Mask, __m128i A, __m128i B) {
+    return _mm_or_si128(_mm_and_si128(Mask, A), _mm_andnot_si128(Mask, B));
+  }
+
+
+  static __m128i ExtractSignedSse(__m128i Value, int Offset, int Bits) {
+    return _mm_srai_epi32(_mm_slli_epi32(Value, 32 - Offset - Bits), 32 - Bits);
+  }
+
+
+  static __m128i ExtractUnsignedSse(__m128i Value, int Offset, int Bits) {
+    return _mm_and_si128(_mm_srli_epi32(Value, Offset), _mm_set1_epi32((1 << Bits) - 1));
+  }
+
+
+  static __m128 SnormalizeSse(__m128i Value, uint32_t Bits) {
+    return _mm_max_ps(
+      _mm_div_ps(_mm_cvtepi32_ps(Value), _mm_set1_ps(float((1 << (Bits - 1)) - 1))),
+      _mm_set1_ps(-1.0f));
+  }
+
+
+  static __m128 UnormalizeSse(__m128i Value, uint32_t Bits) {
+    return _mm_div_ps(_mm_cvtepi32_ps(Value), _mm_set1_ps(float((1u << Bits) - 1u)));
+  }
+
+
+  static __m128i FloatToHalfSse(__m128 Value) {
+    // Same as the scalar version. The comparisons are
+    // signed, which is fine since the sign is masked.
+    __m128i bits = _mm_castps_si128(Value);
+    __m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x8000));
+    __m128i abs  = _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff));
+
+    __m128i result = _mm_or_si128(
+      _mm_slli_epi32(_mm_sub_epi32(_mm_srli_epi32(abs, 23), _mm_set1_epi32(112)), 10),
+      _mm_and_si128(_mm_srli_epi32(abs, 13), _mm_set1_epi32(0x3ff)));
+
+    __m128i rest = _mm_and_si128(abs, _mm_set1_epi32(0x1fff));
+    __m128i odd  = _mm_and_si128(result, _mm_set1_epi32(1));
+
+    __m128i roundUp = _mm_or_si128(
+      _mm_cmpgt_epi32(rest, _mm_set1_epi32(0x1000)),
+      _mm_and_si128(_mm_cmpeq_epi32(rest, _mm_set1_epi32(0x1000)),
+                    _mm_cmpeq_epi32(odd,  _mm_set1_epi32(1))));
+
+    result = _mm_sub_epi32(result, roundUp);
+
+    // Denormals, converting with the default rounding mode
+    // matches std::nearbyint in the scalar version
+    __m128i denorm = _mm_cvtps_epi32(_mm_mul_ps(
+      _mm_castsi128_ps(abs), _mm_set1_ps(16777216.0f)));
+
+    result = SelectSse(_mm_cmplt_epi32(abs, _mm_set1_epi32(0x38800000)), denorm, result);
+    result = SelectSse(_mm_cmpgt_epi32(abs, _mm_set1_epi32(0x477fefff)), _mm_set1_epi32(0x7c00), result);
+    result = SelectSse(_mm_cmpgt_epi32(abs, _mm_set1_epi32(0x7f800000)), _mm_set1_epi32(0x7e00), result);
+    return _mm_or_si128(result, sign);
+  }
+
+
+  static __m128i FloatToSnorm16Sse(__m128 Value) {
+    __m128 clamped = _mm_min_ps(_mm_max_ps(Value, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    return _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(32767.0f)));
+  }
+
+
+  static void StoreBumpMapSse(uint16_t* pDst, __m128i C0, __m128i C1, __m128i C2, __m128i C3) {
+    // Sign-extend the 16-bit values so that the
+    // saturating pack instruction keeps them intact
+    auto sext = [] (__m128i v) {
+      return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+    };
+
+    __m128i t0 = _mm_packs_epi32(sext(C0), sext(C2));
+    __m128i t1 = _mm_packs_epi32(sext(C1), sext(C3));
+
+    __m128i lo = _mm_unpacklo_epi16(t0, t1);
+    __m128i hi = _mm_unpackhi_epi16(t0, t1);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 0), _mm_unpacklo_epi32(lo, hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + 8), _mm_unpackhi_epi32(lo, hi));
+  }
+#endif
+
+
+  bool D3D9CpuFormatConverter::SupportsFormat(
+          D3D9ConversionFormat          Format) {
+    switch (Format) {
+      case D3D9ConversionFormat_YUY2:
+      case D3D9ConversionFormat_UYVY:
+      case D3D9ConversionFormat_NV12:
+      case D3D9ConversionFormat_YV12:
+      case D3D9ConversionFormat_L6V5U5:
+      case D3D9ConversionFormat_X8L8V8U8:
+      case D3D9ConversionFormat_A2W10V10U10:
+      case D3D9ConversionFormat_W11V11U10:
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+
+  void D3D9CpuFormatConverter::ConvertFormat(
+          D3D9ConversionFormat          Format,
+          VkExtent2D                    Extent,
+          void*                         pDst,
+    const void*                         pSrc) {
+    auto dst = reinterpret_cast<uint8_t*>(pDst);
+    auto src = reinterpret_cast<const uint8_t*>(pSrc);
+
+    switch (Format) {
+      case D3D9ConversionFormat_YUY2:
+      case D3D9ConversionFormat_UYVY:
+        ConvertYUY2(Extent, dst, src, Format == D3D9ConversionFormat_UYVY);
+        break;
+
+      case D3D9ConversionFormat_NV12:
+        ConvertNV12(Extent, dst, src);
+        break;
+
+      case D3D9ConversionFormat_YV12:
+        ConvertYV12(Extent, dst, src);
+        break;
+
+      case D3D9ConversionFormat_L6V5U5:
+        ConvertBumpMap<D3D9ConversionFormat_L6V5U5>(Extent, reinterpret_cast<uint16_t*>(pDst), src);
+        break;
+
+      case D3D9ConversionFormat_X8L8V8U8:
+        ConvertBumpMap<D3D9ConversionFormat_X8L8V8U8>(Extent, reinterpret_cast<uint16_t*>(pDst), src);
+        break;
+
+      case D3D9ConversionFormat_A2W10V10U10:
+        ConvertBumpMap<D3D9ConversionFormat_A2W10V10U10>(Extent, reinterpret_cast<uint16_t*>(pDst), src);
+        break;
+
+      case D3D9ConversionFormat_W11V11U10:
+        ConvertBumpMap<D3D9ConversionFormat_W11V11U10>(Extent, reinterpret_cast<uint16_t*>(pDst), src);
+        break;
+
+      default:
+        Logger::warn("Unimplemented CPU format conversion");
+    }
+  }
+
+
+  void D3D9CpuFormatConverter::ConvertYUY2(
+          VkExtent2D                    Extent,
+          uint8_t*                      pDst,
+    const uint8_t*                      pSrc,
+          bool                          IsUYVY) {
+    // Byte offsets of Y0, U, Y1 and V within a macropixel
+    const uint32_t iy0 = IsUYVY ? 1 : 0;
+    const uint32_t iu  = IsUYVY ? 0 : 1;
+    const uint32_t iy1 = IsUYVY ? 3 : 2;
+    const uint32_t iv  = IsUYVY ? 2 : 3;
+
+    const uint32_t macroCount = Extent.width / 2;
+
+    for (uint32_t y = 0; y < Extent.height; y++) {
+      const uint8_t* src = pSrc + 4 * y * macroCount;
+      uint32_t*      dst = reinterpret_cast<uint32_t*>(pDst) + y * Extent.width;
+
+      uint32_t x = 0;
+
+#ifdef DXVK_ARCH_X86
+      // Two macropixels, i.e. four pixels per iteration
+      for ( ; x + 2 <= macroCount; x += 2) {
+        const uint8_t* s = src + 4 * x;
+
+        __m128 yv = UnpackUnormSse(_mm_setr_epi32(s[iy0], s[iy1], s[4 + iy0], s[4 + iy1]), 16.0f / 255.0f);
+        __m128 uv = UnpackUnormSse(_mm_setr_epi32(s[iu],  s[iu],  s[4 + iu],  s[4 + iu]),  128.0f / 255.0f);
+        __m128 vv = UnpackUnormSse(_mm_setr_epi32(s[iv],  s[iv],  s[4 + iv],  s[4 + iv]),  128.0f / 255.0f);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * x),
+          TransformYuvSse(g_yuvTransform, yv, uv, vv));
+      }
+#endif
+
+      for ( ; x < macroCount; x++) {
+        const uint8_t* s = src + 4 * x;
+
+        float u = UnpackUnorm(s[iu], 128.0f / 255.0f);
+        float v = UnpackUnorm(s[iv], 128.0f / 255.0f);
+
+        dst[2 * x + 0] = TransformYuv(g_yuvTransform, UnpackUnorm(s[iy0], 16.0f / 255.0f), u, v);
+        dst[2 * x + 1] = TransformYuv(g_yuvTransform, UnpackUnorm(s[iy1], 16.0f / 255.0f), u, v);
+      }
+    }
+  }
+
+
+  void D3D9CpuFormatConverter::ConvertNV12(
+          VkExtent2D                    Extent,
+          uint8_t*                      pDst,
+    const uint8_t*                      pSrc) {
+    // The shader processes two pixels at a time, so
+    // odd widths lose their last column. Do the same.
+    const uint32_t pitch = 2 * (Extent.width / 2);
+
+    const uint8_t* chroma = pSrc + pitch * Extent.height;
+
+    for (uint32_t y = 0; y < Extent.height; y++) {
+      const uint8_t* srcY  = pSrc   + y * pitch;
+      const uint8_t* srcUV = chroma + (y / 2) * pitch;
+      uint32_t*      dst   = reinterpret_cast<uint32_t*>(pDst) + y * Extent.width;
+
+      uint32_t x = 0;
+
+#ifdef DXVK_ARCH_X86
+      for ( ; x + 4 <= pitch; x += 4) {
+        __m128 yv = UnpackUnormSse(_mm_setr_epi32(srcY[x], srcY[x + 1], srcY[x + 2], srcY[x + 3]), 16.0f / 255.0f);
+        __m128 uv = UnpackUnormSse(_mm_setr_epi32(srcUV[x], srcUV[x], srcUV[x + 2], srcUV[x + 2]), 128.0f / 255.0f);
+        __m128 vv = UnpackUnormSse(_mm_setr_epi32(srcUV[x + 1], srcUV[x + 1], srcUV[x + 3], srcUV[x + 3]), 128.0f / 255.0f);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+          TransformYuvSse(g_bt709Transform, yv, uv, vv));
+      }
+#endif
+
+      for ( ; x < pitch; x += 2) {
+        float u = UnpackUnorm(srcUV[x + 0], 128.0f / 255.0f);
+        float v = UnpackUnorm(srcUV[x + 1], 128.0f / 255.0f);
+
+        dst[x + 0] = TransformYuv(g_bt709Transform, UnpackUnorm(srcY[x + 0], 16.0f / 255.0f), u, v);
+        dst[x + 1] = TransformYuv(g_bt709Transform, UnpackUnorm(srcY[x + 1], 16.0f / 255.0f), u, v);
+      }
+    }
+  }
+
+
+  void D3D9CpuFormatConverter::ConvertYV12(
+          VkExtent2D                    Extent,
+          uint8_t*                      pDst,
+    const uint8_t*                      pSrc) {
+    const uint32_t chromaPitch = Extent.width / 2;
+
+    const uint8_t* planeV = pSrc   + Extent.width * Extent.height;
+    const uint8_t* planeU = planeV + chromaPitch * (Extent.height / 2);
+
+    for (uint32_t y = 0; y < Extent.height; y++) {
+      const uint8_t* srcY = pSrc   + y * Extent.width;
+      const uint8_t* srcV = planeV + (y / 2) * chromaPitch;
+      const uint8_t* srcU = planeU + (y / 2) * chromaPitch;
+      uint32_t*      dst  = reinterpret_cast<uint32_t*>(pDst) + y * Extent.width;
+
+      uint32_t x = 0;
+
+#ifdef DXVK_ARCH_X86
+      for ( ; x + 4 <= Extent.width; x += 4) {
+        uint32_t c = x / 2;
+
+        __m128 yv = UnpackUnormSse(_mm_setr_epi32(srcY[x], srcY[x + 1], srcY[x + 2], srcY[x + 3]), 16.0f / 255.0f);
+        __m128 uv = UnpackUnormSse(_mm_setr_epi32(srcU[c], srcU[c], srcU[c + 1], srcU[c + 1]), 128.0f / 255.0f);
+        __m128 vv = UnpackUnormSse(_mm_setr_epi32(srcV[c], srcV[c], srcV[c + 1], srcV[c + 1]), 128.0f / 255.0f);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+          TransformYuvSse(g_bt709Transform, yv, uv, vv));
+      }
+#endif
+
+      for ( ; x < Extent.width; x++) {
+        dst[x] = TransformYuv(g_bt709Transform,
+          UnpackUnorm(srcY[x],     16.0f  / 255.0f),
+          UnpackUnorm(srcU[x / 2], 128.0f / 255.0f),
+          UnpackUnorm(srcV[x / 2], 128.0f / 255.0f));
+      }
+    }
+  }
+
+
+  template<D3D9ConversionFormat Format>
+  void D3D9CpuFormatConverter::ConvertBumpMap(
+          VkExtent2D                    Extent,
+          uint16_t*                     pDst,
+    const uint8_t*                      pSrc) {
+    const uint32_t count = Extent.width * Extent.height;
+
+    uint32_t i = 0;
+
+#ifdef DXVK_ARCH_X86
+    // Four pixels per iteration
+    for ( ; i + 4 <= count; i += 4) {
+      __m128i value;
+      __m128  color[4];
+
+      if constexpr (Format == D3D9ConversionFormat_L6V5U5) {
+        value = _mm_unpacklo_epi16(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + 2 * i)),
+          _mm_setzero_si128());
+
+        color[0] = SnormalizeSse(ExtractSignedSse(value, 0, 5), 5);
+        color[1] = SnormalizeSse(ExtractSignedSse(value, 5, 5), 5);
+        color[2] = UnormalizeSse(ExtractUnsignedSse(value, 10, 6), 6);
+        color[3] = _mm_set1_ps(1.0f);
+      } else {
+        value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 4 * i));
+
+        if constexpr (Format == D3D9ConversionFormat_X8L8V8U8) {
+          color[0] = SnormalizeSse(ExtractSignedSse(value, 0, 8), 8);
+          color[1] = SnormalizeSse(ExtractSignedSse(value, 8, 8), 8);
+          color[2] = UnormalizeSse(ExtractUnsignedSse(value, 16, 8), 8);
+          color[3] = _mm_set1_ps(1.0f);
+        } else if constexpr (Format == D3D9ConversionFormat_A2W10V10U10) {
+          color[0] = SnormalizeSse(ExtractSignedSse(value,  0, 10), 10);
+          color[1] = SnormalizeSse(ExtractSignedSse(value, 10, 10), 10);
+          color[2] = SnormalizeSse(ExtractSignedSse(value, 20, 10), 10);
+          color[3] = UnormalizeSse(ExtractUnsignedSse(value, 30, 2), 2);
+        } else {
+          color[0] = SnormalizeSse(ExtractSignedSse(value,  0, 10), 10);
+          color[1] = SnormalizeSse(ExtractSignedSse(value, 10, 11), 10);
+          color[2] = SnormalizeSse(ExtractSignedSse(value, 21, 11), 10);
+          color[3] = _mm_set1_ps(1.0f);
+        }
+      }
+
+      __m128i packed[4];
+
+      for (uint32_t c = 0; c < 4; c++) {
+        packed[c] = Format == D3D9ConversionFormat_W11V11U10
+          ? FloatToSnorm16Sse(color[c])
+          : FloatToHalfSse(color[c]);
+      }
+
+      StoreBumpMapSse(pDst + 4 * i, packed[0], packed[1], packed[2], packed[3]);
+    }
+#endif
+
+    for ( ; i < count; i++) {
+      uint32_t value = 0;
+      float    color[4];
+
+      if constexpr (Format == D3D9ConversionFormat_L6V5U5) {
+        uint16_t packed;
+        std::memcpy(&packed, pSrc + 2 * i, sizeof(packed));
+        value = packed;
+
+        color[0] = Snormalize(ExtractSigned(value, 0, 5), 5);
+        color[1] = Snormalize(ExtractSigned(value, 5, 5), 5);
+        color[2] = Unormalize(ExtractUnsigned(value, 10, 6), 6);
+        color[3] = 1.0f;
+      } else {
+        std::memcpy(&value, pSrc + 4 * i, sizeof(value));
+
+        if constexpr (Format == D3D9ConversionFormat_X8L8V8U8) {
+          color[0] = Snormalize(ExtractSigned(value, 0, 8), 8);
+          color[1] = Snormalize(ExtractSigned(value, 8, 8), 8);
+          color[2] = Unormalize(ExtractUnsigned(value, 16, 8), 8);
+          color[3] = 1.0f;
+        } else if constexpr (Format == D3D9ConversionFormat_A2W10V10U10) {
+          color[0] = Snormalize(ExtractSigned(value,  0, 10), 10);
+          color[1] = Snormalize(ExtractSigned(value, 10, 10), 10);
+          color[2] = Snormalize(ExtractSigned(value, 20, 10), 10);
+          color[3] = Unormalize(ExtractUnsigned(value, 30, 2), 2);
+        } else {
+          // The shader normalizes the 11-bit
+          // components as if they had 10 bits
+          color[0] = Snormalize(ExtractSigned(value,  0, 10), 10);
+          color[1] = Snormalize(ExtractSigned(value, 10, 11), 10);
+          color[2] = Snormalize(ExtractSigned(value, 21, 11), 10);
+          color[3] = 1.0f;
+        }
+      }
+
+      for (uint32_t c = 0; c < 4; c++) {
+        pDst[4 * i + c] = Format == D3D9ConversionFormat_W11V11U10
+          ? FloatToSnorm16(color[c])
+          : FloatToHalf(color[c]);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "d3d9_include.h"
+#include "d3d9_format.h"
+
+namespace dxvk {
+
+  /**
+   * \brief CPU format converter
+   *
+   * Converts the formats handled by \c D3D9FormatHelper
+   * on the CPU, so that small uploads do not need to
+   * synchronize with the CS thread and dispatch a compute
+   * shader. Results match the conversion shaders.
+   */
+  class D3D9CpuFormatConverter {
+
+  public:
+
+    /**
+     * \brief Checks whether a format can be converted
+     *
+     * \param [in] Format Conversion format
+     * \returns \c true if the format is supported
+     */
+    static bool SupportsFormat(
+            D3D9ConversionFormat          Format);
+
+    /**
+     * \brief Converts an image
+     *
+     * The source data must be laid out exactly like the
+     * data passed to the conversion shaders, i.e. tightly
+     * packed, with additional planes following the first.
+     * The destination is written tightly packed in the
+     * conversion format of the texture.
+     * \param [in] Format Conversion format
+     * \param [in] Extent Image size, in pixels
+     * \param [out] pDst Destination data
+     * \param [in] pSrc Source data
+     */
+    static void ConvertFormat(
+            D3D9ConversionFormat          Format,
+            VkExtent2D                    Extent,
+            void*                         pDst,
+      const void*                         pSrc);
+
+  private:
+
+    static void ConvertYUY2(
+            VkExtent2D                    Extent,
+            uint8_t*                      pDst,
+      const uint8_t*                      pSrc,
+            bool                          IsUYVY);
+
+    static void ConvertNV12(
+            VkExtent2D                    Extent,
+            uint8_t*                      pDst,
+      const uint8_t*                      pSrc);
+
+    static void ConvertYV12(
+            VkExtent2D                    Extent,
+            uint8_t*                      pDst,
+      const uint8_t*                      pSrc);
+
+    template<D3D9ConversionFormat Format>
+    static void ConvertBumpMap(
+            VkExtent2D                    Extent,
+            uint16_t*                     pDst,
+      const uint8_t*                      pSrc);
+
+  };
+
+}
@@ -73,6 +73,10 @@ namespace dxvk {
     this->deviceLocalConstantBuffers    = config.getOption<bool>        ("d3d9.deviceLocalConstantBuffers",    false);
     this->allowDirectBufferMapping      = config.getOption<bool>        ("d3d9.allowDirectBufferMapping",      true);
     this->seamlessCubes                 = config.getOption<bool>        ("d3d9.seamlessCubes",                 false);
+    this->batchUPDraws                  = config.getOption<bool>        ("d3d9.batchUPDraws",                  true);
+    this->batchIndexedDraws             = config.getOption<bool>        ("d3d9.batchIndexedDraws",             true);
+    this->cpuFormatConversionPixels     = std::max(config.getOption<int32_t>("d3d9.cpuFormatConversionPixels", 1 << 16), 0);
+    this->readbackLatency               = std::max(config.getOption<int32_t>("d3d9.readbackLatency",           0), 0);
     this->textureMemory                 = config.getOption<int32_t>     ("d3d9.textureMemory",                 100) << 20;
     this->deviceLossOnFocusLoss         = config.getOption<bool>        ("d3d9.deviceLossOnFocusLoss",         false);
     this->samplerLodBias                = config.getOption<float>       ("d3d9.samplerLodBias",                0.0f);
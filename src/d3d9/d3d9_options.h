@@ -140,6 +140,21 @@ namespace dxvk {
     /// Don't use non seamless cube maps
     bool seamlessCubes;
 
+    /// Merge consecutive UP draws into one draw
+    bool batchUPDraws;
+
+    /// Merge consecutive indexed draws into one indirect draw
+    bool batchIndexedDraws;
+
+    /// Largest image, in pixels, that is format-converted on
+    /// the CPU instead of with a compute shader
+    int32_t cpuFormatConversionPixels;
+
+    /// Number of GetRenderTargetData calls that the data seen
+    /// when locking the destination surface may lag behind.
+    /// 0 waits for every copy.
+    int32_t readbackLatency;
+
     /// Mipmap LOD bias
     ///
     /// Enforces the given LOD bias for all samplers.
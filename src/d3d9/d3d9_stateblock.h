@@ -82,6 +82,70 @@ namespace dxvk {
     }
   }
 
+  /**
+   * \brief Compares arrays of 32-bit state values
+   *
+   * \param [in] pA First array
+   * \param [in] pB Second array
+   * \param [in] Count Number of values, at most 32
+   * \returns Bit mask of values that differ
+   */
+  template <typename T>
+  uint32_t GetStateDifferenceMask(const T* pA, const T* pB, uint32_t Count) {
+    static_assert(sizeof(T) == sizeof(uint32_t));
+
+    uint32_t equal = 0;
+    uint32_t i = 0;
+
+#ifdef DXVK_ARCH_X86
+    for (; i + 4 <= Count; i += 4) {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i));
+
+      equal |= uint32_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))) << i;
+    }
+#endif
+
+    for (; i < Count; i++)
+      equal |= uint32_t(pA[i] == pB[i]) << i;
+
+    uint32_t mask = Count < 32 ? (1u << Count) - 1u : ~0u;
+    return ~equal & mask;
+  }
+
+
+  /**
+   * \brief Compares arrays of shader constants
+   *
+   * Constants are compared bitwise, so that e.g.
+   * NaN values do not prevent updates from being
+   * skipped.
+   * \param [in] pA First array
+   * \param [in] pB Second array
+   * \param [in] Count Number of constants, at most 32
+   * \returns Bit mask of constants that differ
+   */
+  template <typename T>
+  uint32_t GetConstantDifferenceMask(const T* pA, const T* pB, uint32_t Count) {
+    static_assert(sizeof(T) == 16);
+
+    uint32_t mask = 0;
+
+    for (uint32_t i = 0; i < Count; i++) {
+#ifdef DXVK_ARCH_X86
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pA[i]));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pB[i]));
+
+      bool differs = _mm_movemask_epi8(_mm_cmpeq_epi32(a, b)) != 0xFFFF;
+#else
+      bool differs = std::memcmp(&pA[i], &pB[i], sizeof(T)) != 0;
+#endif
+      mask |= uint32_t(differs) << i;
+    }
+
+    return mask;
+  }
+
   using D3D9StateBlockBase = D3D9DeviceChild<IDirect3DStateBlock9>;
   class D3D9StateBlock : public D3D9StateBlockBase {
 
@@ -181,19 +245,44 @@ namespace dxvk {
       Capture
     };
 
-    template <typename Dst, typename Src>
-    void ApplyOrCapture(Dst* dst, const Src* src) {
+    /**
+     * \brief Applies or captures the state
+     *
+     * Writes all captured state from \c src to \c dst.
+     * If \c skipUnchanged is set, values that are already
+     * the same in \c dstState are compared in bulk and
+     * skipped, and only the remaining ones go through the
+     * setters. Constants are written in contiguous ranges.
+     * \param [in] dst Object to write the state to
+     * \param [in] src State to read from
+     * \param [in] dstState Current state of \c dst
+     * \param [in] skipUnchanged Whether to skip unchanged state
+     */
+    template <typename Dst, typename Src, typename DstState>
+    void ApplyOrCapture(Dst* dst, const Src* src, const DstState* dstState, bool skipUnchanged) {
       if (m_captures.flags.test(D3D9CapturedStateFlag::StreamFreq)) {
-        for (uint32_t idx : bit::BitMask(m_captures.streamFreq.dword(0)))
+        uint32_t mask = m_captures.streamFreq.dword(0);
+
+        if (skipUnchanged && mask)
+          mask &= GetStateDifferenceMask(src->streamFreq.data(), dstState->streamFreq.data(), caps::MaxStreams);
+
+        for (uint32_t idx : bit::BitMask(mask))
           dst->SetStreamSourceFreq(idx, src->streamFreq[idx]);
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Indices))
-        dst->SetIndices(src->indices.ptr());
+      if (m_captures.flags.test(D3D9CapturedStateFlag::Indices)) {
+        if (!skipUnchanged || src->indices.ptr() != dstState->indices.ptr())
+          dst->SetIndices(src->indices.ptr());
+      }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::RenderStates)) {
         for (uint32_t i = 0; i < m_captures.renderStates.dwordCount(); i++) {
-          for (uint32_t rs : bit::BitMask(m_captures.renderStates.dword(i))) {
+          uint32_t mask = m_captures.renderStates.dword(i);
+
+          if (skipUnchanged && mask)
+            mask &= GetStateDifferenceMask(&src->renderStates[i * 32], &dstState->renderStates[i * 32], 32);
+
+          for (uint32_t rs : bit::BitMask(mask)) {
             uint32_t idx = i * 32 + rs;
 
             dst->SetRenderState(D3DRENDERSTATETYPE(idx), src->renderStates[idx]);
@@ -203,7 +292,14 @@ namespace dxvk {
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::SamplerStates)) {
         for (uint32_t samplerIdx : bit::BitMask(m_captures.samplers.dword(0))) {
-          for (uint32_t stateIdx : bit::BitMask(m_captures.samplerStates[samplerIdx].dword(0)))
+          uint32_t mask = m_captures.samplerStates[samplerIdx].dword(0);
+
+          if (skipUnchanged && mask) {
+            mask &= GetStateDifferenceMask(src->samplerStates[samplerIdx].data(),
+              dstState->samplerStates[samplerIdx].data(), SamplerStateCount);
+          }
+
+          for (uint32_t stateIdx : bit::BitMask(mask))
             dst->SetStateSamplerState(samplerIdx, D3DSAMPLERSTATETYPE(stateIdx), src->samplerStates[samplerIdx][stateIdx]);
         }
       }
@@ -211,6 +307,16 @@ namespace dxvk {
       if (m_captures.flags.test(D3D9CapturedStateFlag::VertexBuffers)) {
         for (uint32_t idx : bit::BitMask(m_captures.vertexBuffers.dword(0))) {
           const auto& vbo = src->vertexBuffers[idx];
+
+          if (skipUnchanged) {
+            const auto& dstVbo = dstState->vertexBuffers[idx];
+
+            if (vbo.vertexBuffer.ptr() == dstVbo.vertexBuffer.ptr()
+             && vbo.offset == dstVbo.offset
+             && vbo.stride == dstVbo.stride)
+              continue;
+          }
+
           dst->SetStreamSource(
             idx,
             vbo.vertexBuffer.ptr(),
@@ -219,25 +325,36 @@ namespace dxvk {
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Material))
-        dst->SetMaterial(&src->material);
+      if (m_captures.flags.test(D3D9CapturedStateFlag::Material)) {
+        if (!skipUnchanged || std::memcmp(&src->material, &dstState->material, sizeof(D3DMATERIAL9)))
+          dst->SetMaterial(&src->material);
+      }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::Textures)) {
-        for (uint32_t idx : bit::BitMask(m_captures.textures.dword(0)))
-          dst->SetStateTexture(idx, src->textures[idx]);
+        for (uint32_t idx : bit::BitMask(m_captures.textures.dword(0))) {
+          if (!skipUnchanged || src->textures[idx] != dstState->textures[idx])
+            dst->SetStateTexture(idx, src->textures[idx]);
+        }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::VertexShader))
-        dst->SetVertexShader(src->vertexShader.ptr());
+      if (m_captures.flags.test(D3D9CapturedStateFlag::VertexShader)) {
+        if (!skipUnchanged || src->vertexShader.ptr() != dstState->vertexShader.ptr())
+          dst->SetVertexShader(src->vertexShader.ptr());
+      }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::PixelShader))
-        dst->SetPixelShader(src->pixelShader.ptr());
+      if (m_captures.flags.test(D3D9CapturedStateFlag::PixelShader)) {
+        if (!skipUnchanged || src->pixelShader.ptr() != dstState->pixelShader.ptr())
+          dst->SetPixelShader(src->pixelShader.ptr());
+      }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::Transforms)) {
         for (uint32_t i = 0; i < m_captures.transforms.dwordCount(); i++) {
           for (uint32_t trans : bit::BitMask(m_captures.transforms.dword(i))) {
             uint32_t idx = i * 32 + trans;
 
+            if (skipUnchanged && !std::memcmp(&src->transforms[idx], &dstState->transforms[idx], sizeof(Matrix4)))
+              continue;
+
             dst->SetStateTransform(idx, reinterpret_cast<const D3DMATRIX*>(&src->transforms[idx]));
           }
         }
@@ -245,65 +362,74 @@ namespace dxvk {
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::TextureStages)) {
         for (uint32_t stageIdx : bit::BitMask(m_captures.textureStages.dword(0))) {
-          for (uint32_t stateIdx : bit::BitMask(m_captures.textureStageStates[stageIdx].dword(0)))
+          uint32_t mask = m_captures.textureStageStates[stageIdx].dword(0);
+
+          if (skipUnchanged && mask) {
+            mask &= GetStateDifferenceMask(src->textureStages[stageIdx].data(),
+              dstState->textureStages[stageIdx].data(), TextureStageStateCount);
+          }
+
+          for (uint32_t stateIdx : bit::BitMask(mask))
             dst->SetStateTextureStageState(stageIdx, D3D9TextureStageStateTypes(stateIdx), src->textureStages[stageIdx][stateIdx]);
         }
       }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::Viewport))
-        dst->SetViewport(&src->viewport);
+      if (m_captures.flags.test(D3D9CapturedStateFlag::Viewport)) {
+        if (!skipUnchanged || !(src->viewport == dstState->viewport))
+          dst->SetViewport(&src->viewport);
+      }
 
-      if (m_captures.flags.test(D3D9CapturedStateFlag::ScissorRect))
-        dst->SetScissorRect(&src->scissorRect);
+      if (m_captures.flags.test(D3D9CapturedStateFlag::ScissorRect)) {
+        if (!skipUnchanged || !(src->scissorRect == dstState->scissorRect))
+          dst->SetScissorRect(&src->scissorRect);
+      }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::ClipPlanes)) {
-        for (uint32_t idx : bit::BitMask(m_captures.clipPlanes.dword(0)))
+        for (uint32_t idx : bit::BitMask(m_captures.clipPlanes.dword(0))) {
+          if (skipUnchanged && !std::memcmp(src->clipPlanes[idx].coeff, dstState->clipPlanes[idx].coeff, sizeof(D3D9ClipPlane::coeff)))
+            continue;
+
           dst->SetClipPlane(idx, src->clipPlanes[idx].coeff);
+        }
       }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::VsConstants)) {
-        for (uint32_t i = 0; i < m_captures.vsConsts.fConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.vsConsts.fConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
+        const auto& srcConsts = *(&src->vsConsts);
+        const auto& dstConsts = *(&dstState->vsConsts);
 
-            dst->SetVertexShaderConstantF(idx, (float*)&src->vsConsts->fConsts[idx], 1);
-          }
-        }
+        ForEachConstantRange(m_captures.vsConsts.fConsts, srcConsts.fConsts, dstConsts.fConsts, skipUnchanged,
+          [&] (uint32_t idx, uint32_t count) {
+            dst->SetVertexShaderConstantF(idx, (const float*)&srcConsts.fConsts[idx], count);
+          });
 
-        for (uint32_t i = 0; i < m_captures.vsConsts.iConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.vsConsts.iConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetVertexShaderConstantI(idx, (int*)&src->vsConsts->iConsts[idx], 1);
-          }
-        }
+        ForEachConstantRange(m_captures.vsConsts.iConsts, srcConsts.iConsts, dstConsts.iConsts, skipUnchanged,
+          [&] (uint32_t idx, uint32_t count) {
+            dst->SetVertexShaderConstantI(idx, (const int*)&srcConsts.iConsts[idx], count);
+          });
 
         if (m_captures.vsConsts.bConsts.any()) {
           for (uint32_t i = 0; i < m_captures.vsConsts.bConsts.dwordCount(); i++)
-            dst->SetVertexBoolBitfield(i, m_captures.vsConsts.bConsts.dword(i), src->vsConsts->bConsts[i]);
+            dst->SetVertexBoolBitfield(i, m_captures.vsConsts.bConsts.dword(i), srcConsts.bConsts[i]);
         }
       }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::PsConstants)) {
-        for (uint32_t i = 0; i < m_captures.psConsts.fConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.psConsts.fConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetPixelShaderConstantF(idx, (float*)&src->psConsts->fConsts[idx], 1);
-          }
-        }
+        const auto& srcConsts = *(&src->psConsts);
+        const auto& dstConsts = *(&dstState->psConsts);
 
-        for (uint32_t i = 0; i < m_captures.psConsts.iConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.psConsts.iConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
+        ForEachConstantRange(m_captures.psConsts.fConsts, srcConsts.fConsts, dstConsts.fConsts, skipUnchanged,
+          [&] (uint32_t idx, uint32_t count) {
+            dst->SetPixelShaderConstantF(idx, (const float*)&srcConsts.fConsts[idx], count);
+          });
 
-            dst->SetPixelShaderConstantI(idx, (int*)&src->psConsts->iConsts[idx], 1);
-          }
-        }
+        ForEachConstantRange(m_captures.psConsts.iConsts, srcConsts.iConsts, dstConsts.iConsts, skipUnchanged,
+          [&] (uint32_t idx, uint32_t count) {
+            dst->SetPixelShaderConstantI(idx, (const int*)&srcConsts.iConsts[idx], count);
+          });
 
         if (m_captures.psConsts.bConsts.any()) {
           for (uint32_t i = 0; i < m_captures.psConsts.bConsts.dwordCount(); i++)
-            dst->SetPixelBoolBitfield(i, m_captures.psConsts.bConsts.dword(i), src->psConsts->bConsts[i]);
+            dst->SetPixelBoolBitfield(i, m_captures.psConsts.bConsts.dword(i), srcConsts.bConsts[i]);
         }
       }
 
@@ -327,9 +453,9 @@ namespace dxvk {
     template <D3D9StateFunction Func>
     void ApplyOrCapture() {
       if      constexpr (Func == D3D9StateFunction::Apply)
-        ApplyOrCapture(m_parent, &m_state);
+        ApplyOrCapture(m_parent, &m_state, m_deviceState, !m_parent->IsRecording());
       else if constexpr (Func == D3D9StateFunction::Capture)
-        ApplyOrCapture(this, m_deviceState);
+        ApplyOrCapture(this, m_deviceState, &m_state, true);
     }
 
     template <
@@ -383,6 +509,62 @@ namespace dxvk {
 
   private:
 
+    /**
+     * \brief Iterates over ranges of captured constants
+     *
+     * Calls \c fn once for each contiguous range of captured
+     * constants, optionally leaving out constants that have
+     * the same value in both sets.
+     * \param [in] captures Captured constants
+     * \param [in] src Source constants
+     * \param [in] dst Destination constants
+     * \param [in] skipUnchanged Whether to skip unchanged constants
+     * \param [in] fn Function taking the first index and count
+     */
+    template <size_t N, typename T, size_t Count, typename Fn>
+    static void ForEachConstantRange(
+            bit::bitset<N>& captures,
+      const T               (&src)[Count],
+      const T               (&dst)[Count],
+            bool            skipUnchanged,
+            Fn&&            fn) {
+      static_assert(N <= Count);
+
+      uint32_t rangeStart = 0;
+      uint32_t rangeCount = 0;
+
+      for (uint32_t i = 0; i < captures.dwordCount(); i++) {
+        uint32_t mask = captures.dword(i);
+
+        if (skipUnchanged && mask) {
+          uint32_t base = i * 32;
+          mask &= GetConstantDifferenceMask(&src[base], &dst[base], std::min<uint32_t>(Count - base, 32));
+        }
+
+        if (mask == ~0u && rangeStart + rangeCount == i * 32) {
+          rangeCount += 32;
+          continue;
+        }
+
+        for (uint32_t bitIdx : bit::BitMask(mask)) {
+          uint32_t idx = i * 32 + bitIdx;
+
+          if (rangeCount && rangeStart + rangeCount == idx) {
+            rangeCount += 1;
+          } else {
+            if (rangeCount)
+              fn(rangeStart, rangeCount);
+
+            rangeStart = idx;
+            rangeCount = 1;
+          }
+        }
+      }
+
+      if (rangeCount)
+        fn(rangeStart, rangeCount);
+    }
+
     void CapturePixelRenderStates();
     void CapturePixelSamplerStates();
     void CapturePixelShaderStates();
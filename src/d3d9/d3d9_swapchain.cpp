@@ -258,6 +258,7 @@ namespace dxvk {
     const RGNDATA* pDirtyRegion,
           DWORD    dwFlags) {
     D3D9DeviceLock lock = m_parent->LockDevice();
+    DXVK_API_TIMER(m_parent->GetApiTimers(), Present);
 
     uint32_t presentInterval = m_presentParams.PresentationInterval;
 
@@ -401,6 +402,10 @@ namespace dxvk {
                        || dstTexExtent.width > srcTexExtent.width
                        || dstTexExtent.height > srcTexExtent.height;
 
+    // Older readbacks must not replace this data later on
+    if (unlikely(dstTexInfo->HasPendingReadbacks()))
+      m_parent->ResolveReadbacks(dstTexInfo, 0, 0);
+
     dstTexInfo->CreateBuffer(clearDst);
     DxvkBufferSlice dstBufferSlice = dstTexInfo->GetBufferSlice(dst->GetSubresource());
     Rc<DxvkImage>   srcImage       = srcTexInfo->GetImage();
@@ -883,6 +888,8 @@ namespace dxvk {
 
 
   void D3D9SwapChainEx::PresentImage(UINT SyncInterval) {
+    DxvkTraceScope trace(m_device->tracer(), "Present", "api");
+
     m_parent->Flush();
 
     // Retrieve the image and image view to present
@@ -0,0 +1,1241 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "d3d9_swvp_cpu.h"
+#include "d3d9_shader.h"
+
+#include "../dxso/dxso_header.h"
+#include "../dxso/dxso_reader.h"
+
+namespace dxvk {
+
+  static uint32_t GetSourceCount(DxsoOpcode Opcode) {
+    switch (Opcode) {
+      case DxsoOpcode::Add:
+      case DxsoOpcode::Sub:
+      case DxsoOpcode::Mul:
+      case DxsoOpcode::Dp3:
+      case DxsoOpcode::Dp4:
+      case DxsoOpcode::Min:
+      case DxsoOpcode::Max:
+      case DxsoOpcode::Slt:
+      case DxsoOpcode::Sge:
+      case DxsoOpcode::Dst:
+      case DxsoOpcode::Pow:
+      case DxsoOpcode::Crs:
+      case DxsoOpcode::M4x4:
+      case DxsoOpcode::M4x3:
+      case DxsoOpcode::M3x4:
+      case DxsoOpcode::M3x3:
+      case DxsoOpcode::M3x2:
+        return 2;
+
+      case DxsoOpcode::Mad:
+      case DxsoOpcode::Lrp:
+      case DxsoOpcode::Cmp:
+      case DxsoOpcode::Cnd:
+        return 3;
+
+      default:
+        return 1;
+    }
+  }
+
+
+  static bool GetConstIndex(const DxsoRegisterId& Id, uint32_t& Index) {
+    switch (Id.type) {
+      case DxsoRegisterType::Const:  Index = Id.num;        return true;
+      case DxsoRegisterType::Const2: Index = Id.num + 2048; return true;
+      case DxsoRegisterType::Const3: Index = Id.num + 4096; return true;
+      case DxsoRegisterType::Const4: Index = Id.num + 6144; return true;
+      default: return false;
+    }
+  }
+
+
+  std::unique_ptr<D3D9SWVPProgram> D3D9SWVPProgram::Decode(
+    const uint32_t*               pBytecode) {
+    try {
+      DxsoReader reader(reinterpret_cast<const char*>(pBytecode));
+
+      DxsoHeader header(reader);
+      DxsoCode   code(reader);
+
+      const DxsoProgramInfo& info = header.info();
+
+      if (info.type() != DxsoProgramTypes::VertexShader)
+        return nullptr;
+
+      auto program = std::make_unique<D3D9SWVPProgram>();
+      program->m_majorVersion = info.majorVersion();
+      program->m_floorAddress = info.majorVersion() == 1 && info.minorVersion() < 2;
+
+      DxsoCodeIter iter = code.iter();
+      DxsoDecodeContext decoder(info);
+
+      while (decoder.decodeInstruction(iter)) {
+        if (!program->DecodeInstruction(info, decoder.getInstructionContext()))
+          return nullptr;
+      }
+
+      // Definitions apply to the entire shader regardless of
+      // where they appear, so resolve direct reads afterwards.
+      for (auto& ins : program->m_instructions) {
+        for (uint32_t i = 0; i < GetSourceCount(ins.opcode); i++) {
+          auto& src = ins.src[i];
+
+          if (src.file != D3D9SWVPRegFile::Const || src.relative)
+            continue;
+
+          for (const auto& def : program->m_definitions) {
+            if (def.first == src.index) {
+              src.file  = D3D9SWVPRegFile::Imm;
+              src.index = def.second;
+            }
+          }
+        }
+      }
+
+      return program;
+    } catch (const DxvkError& e) {
+      Logger::err(e.message());
+      return nullptr;
+    }
+  }
+
+
+  std::unique_ptr<D3D9SWVPProgram> D3D9SWVPProgram::CreateFixedFunction(
+    const std::array<uint32_t, 8>& TexcoordIndices) {
+    auto program = std::make_unique<D3D9SWVPProgram>();
+
+    // v0: Position, v1: Diffuse, v2: Specular, v3+: Texcoords
+    program->m_inputs[0] = { DxsoUsage::Position, 0 };
+    program->m_inputs[1] = { DxsoUsage::Color,    0 };
+    program->m_inputs[2] = { DxsoUsage::Color,    1 };
+
+    program->m_inputDefaults[0] = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    program->m_inputDefaults[1] = Vector4(1.0f);
+
+    for (uint32_t i = 0; i < TexcoordIndices.size(); i++)
+      program->m_inputs[3 + i] = { DxsoUsage::Texcoord, i };
+
+    program->m_inputMask = (1u << (3 + TexcoordIndices.size())) - 1;
+
+    // Output slots match the ones used for vs_1_x and vs_2_x
+    program->AddOutput(0, DxsoUsage::Position, 0);
+    program->AddOutput(3, DxsoUsage::Color,    0);
+    program->AddOutput(4, DxsoUsage::Color,    1);
+
+    D3D9SWVPInstruction ins = { };
+    ins.opcode      = DxsoOpcode::Dp4;
+    ins.dst.file    = D3D9SWVPRegFile::Output;
+    ins.src[0].file = D3D9SWVPRegFile::Input;
+    ins.src[1].file = D3D9SWVPRegFile::Const;
+
+    for (uint32_t i = 0; i < 4; i++) {
+      ins.dst.mask     = DxsoRegMask(uint8_t(1u << i));
+      ins.src[1].index = i;
+      program->m_instructions.push_back(ins);
+    }
+
+    ins = D3D9SWVPInstruction();
+    ins.opcode      = DxsoOpcode::Mov;
+    ins.dst.file    = D3D9SWVPRegFile::Output;
+    ins.src[0].file = D3D9SWVPRegFile::Input;
+
+    for (uint32_t i = 0; i < 2; i++) {
+      ins.dst.index    = 3 + i;
+      ins.src[0].index = 1 + i;
+      program->m_instructions.push_back(ins);
+    }
+
+    for (uint32_t i = 0; i < TexcoordIndices.size(); i++) {
+      if (TexcoordIndices[i] >= TexcoordIndices.size())
+        continue;
+
+      program->AddOutput(5 + i, DxsoUsage::Texcoord, i);
+
+      ins.dst.index    = 5 + i;
+      ins.src[0].index = 3 + TexcoordIndices[i];
+      program->m_instructions.push_back(ins);
+    }
+
+    return program;
+  }
+
+
+  bool D3D9SWVPProgram::DecodeInstruction(
+    const DxsoProgramInfo&              Info,
+    const DxsoInstructionContext&       Ctx) {
+    const DxsoOpcode opcode = Ctx.instruction.opcode;
+
+    if (Ctx.instruction.predicated)
+      return false;
+
+    switch (opcode) {
+      case DxsoOpcode::Nop:
+      case DxsoOpcode::Comment:
+      case DxsoOpcode::End:
+        return true;
+
+      case DxsoOpcode::Dcl: {
+        const DxsoRegisterId& id = Ctx.dst.id;
+
+        if (id.type == DxsoRegisterType::Input && id.num < MaxInputs) {
+          m_inputs[id.num] = Ctx.dcl.semantic;
+          m_inputMask |= 1u << id.num;
+          return true;
+        }
+
+        if (id.type == DxsoRegisterType::Output && id.num < MaxOutputs
+         && Info.majorVersion() >= 3) {
+          AddOutput(id.num, Ctx.dcl.semantic.usage, Ctx.dcl.semantic.usageIndex);
+          return true;
+        }
+
+        // Samplers, i.e. vertex texture fetch
+        return false;
+      }
+
+      case DxsoOpcode::Def: {
+        uint32_t index;
+
+        if (!GetConstIndex(Ctx.dst.id, index))
+          return false;
+
+        m_definitions.push_back({ index, uint32_t(m_immediates.size()) });
+        m_immediates.push_back(Vector4(Ctx.def.float32));
+        return true;
+      }
+
+      case DxsoOpcode::DefI:
+      case DxsoOpcode::DefB:
+        // Only consumed by flow control, which
+        // fails to decode anyway
+        return true;
+
+      case DxsoOpcode::Mov:
+      case DxsoOpcode::Mova:
+      case DxsoOpcode::Add:
+      case DxsoOpcode::Sub:
+      case DxsoOpcode::Mad:
+      case DxsoOpcode::Mul:
+      case DxsoOpcode::Rcp:
+      case DxsoOpcode::Rsq:
+      case DxsoOpcode::Dp3:
+      case DxsoOpcode::Dp4:
+      case DxsoOpcode::Min:
+      case DxsoOpcode::Max:
+      case DxsoOpcode::Slt:
+      case DxsoOpcode::Sge:
+      case DxsoOpcode::Exp:
+      case DxsoOpcode::ExpP:
+      case DxsoOpcode::Log:
+      case DxsoOpcode::LogP:
+      case DxsoOpcode::Lit:
+      case DxsoOpcode::Dst:
+      case DxsoOpcode::Lrp:
+      case DxsoOpcode::Frc:
+      case DxsoOpcode::Pow:
+      case DxsoOpcode::Crs:
+      case DxsoOpcode::Sgn:
+      case DxsoOpcode::Abs:
+      case DxsoOpcode::Nrm:
+      case DxsoOpcode::SinCos:
+      case DxsoOpcode::Cmp:
+      case DxsoOpcode::Cnd:
+      case DxsoOpcode::M4x4:
+      case DxsoOpcode::M4x3:
+      case DxsoOpcode::M3x4:
+      case DxsoOpcode::M3x3:
+      case DxsoOpcode::M3x2: {
+        D3D9SWVPInstruction ins = { };
+        ins.opcode = opcode;
+
+        if (!DecodeOperand(Info, Ctx.dst, true, ins.dst))
+          return false;
+
+        for (uint32_t i = 0; i < GetSourceCount(opcode); i++) {
+          if (!DecodeOperand(Info, Ctx.src[i], false, ins.src[i]))
+            return false;
+        }
+
+        switch (opcode) {
+          case DxsoOpcode::M4x4: LowerMatrix(ins, 4, 4); break;
+          case DxsoOpcode::M4x3: LowerMatrix(ins, 3, 4); break;
+          case DxsoOpcode::M3x4: LowerMatrix(ins, 4, 3); break;
+          case DxsoOpcode::M3x3: LowerMatrix(ins, 3, 3); break;
+          case DxsoOpcode::M3x2: LowerMatrix(ins, 2, 3); break;
+          default: m_instructions.push_back(ins);
+        }
+
+        return true;
+      }
+
+      default:
+        // Flow control, texture sampling
+        return false;
+    }
+  }
+
+
+  bool D3D9SWVPProgram::DecodeOperand(
+    const DxsoProgramInfo&              Info,
+    const DxsoRegister&                 Reg,
+          bool                          IsDst,
+          D3D9SWVPOperand&              Operand) {
+    Operand.swizzle  = Reg.swizzle;
+    Operand.modifier = Reg.modifier;
+    Operand.mask     = Reg.mask;
+    Operand.saturate = Reg.saturate;
+
+    if (Reg.shift != 0)
+      return false;
+
+    if (Reg.modifier == DxsoRegModifier::Dz
+     || Reg.modifier == DxsoRegModifier::Dw
+     || Reg.modifier == DxsoRegModifier::Not)
+      return false;
+
+    if (Reg.hasRelative) {
+      if (Reg.relative.id.type != DxsoRegisterType::Addr)
+        return false;
+
+      Operand.relative     = true;
+      Operand.relComponent = Reg.relative.swizzle[0];
+    }
+
+    uint32_t constIndex;
+
+    if (GetConstIndex(Reg.id, constIndex)) {
+      if (IsDst)
+        return false;
+
+      Operand.file  = D3D9SWVPRegFile::Const;
+      Operand.index = constIndex;
+
+      m_relativeConsts |= Operand.relative;
+      return true;
+    }
+
+    // Only constants can be indexed in vertex shaders
+    if (Operand.relative)
+      return false;
+
+    switch (Reg.id.type) {
+      case DxsoRegisterType::Temp:
+        if (Reg.id.num >= DxsoMaxTempRegs)
+          return false;
+
+        Operand.file  = D3D9SWVPRegFile::Temp;
+        Operand.index = Reg.id.num;
+        return true;
+
+      case DxsoRegisterType::Input:
+        if (IsDst || Reg.id.num >= MaxInputs)
+          return false;
+
+        Operand.file  = D3D9SWVPRegFile::Input;
+        Operand.index = Reg.id.num;
+        return true;
+
+      case DxsoRegisterType::Addr:
+        Operand.file  = D3D9SWVPRegFile::Addr;
+        Operand.index = 0;
+        return true;
+
+      case DxsoRegisterType::RasterizerOut:
+        if (!IsDst || Info.majorVersion() >= 3 || Reg.id.num > 2)
+          return false;
+
+        Operand.file  = D3D9SWVPRegFile::Output;
+        Operand.index = Reg.id.num;
+
+        if (Reg.id.num == 0) {
+          AddOutput(0, DxsoUsage::Position, 0);
+        } else {
+          // oFog and oPts are scalar
+          Operand.mask = DxsoRegMask(true, false, false, false);
+
+          AddOutput(Reg.id.num, Reg.id.num == 1
+            ? DxsoUsage::Fog : DxsoUsage::PointSize, 0);
+        }
+        return true;
+
+      case DxsoRegisterType::AttributeOut:
+        if (!IsDst || Info.majorVersion() >= 3 || Reg.id.num > 1)
+          return false;
+
+        Operand.file  = D3D9SWVPRegFile::Output;
+        Operand.index = 3 + Reg.id.num;
+
+        AddOutput(Operand.index, DxsoUsage::Color, Reg.id.num);
+        return true;
+
+      // Also the generic output register file for vs_3_0
+      case DxsoRegisterType::TexcoordOut:
+        if (!IsDst)
+          return false;
+
+        Operand.file = D3D9SWVPRegFile::Output;
+
+        if (Info.majorVersion() >= 3) {
+          if (Reg.id.num >= MaxOutputs)
+            return false;
+
+          Operand.index = Reg.id.num;
+        } else {
+          if (Reg.id.num >= 8)
+            return false;
+
+          Operand.index = 5 + Reg.id.num;
+          AddOutput(Operand.index, DxsoUsage::Texcoord, Reg.id.num);
+        }
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+
+  void D3D9SWVPProgram::AddOutput(
+          uint32_t                      Index,
+          DxsoUsage                     Usage,
+          uint32_t                      UsageIndex) {
+    m_outputs[Index] = { Usage, UsageIndex };
+    m_outputMask |= 1u << Index;
+  }
+
+
+  void D3D9SWVPProgram::LowerMatrix(
+    const D3D9SWVPInstruction&          Ins,
+          uint32_t                      Rows,
+          uint32_t                      Columns) {
+    D3D9SWVPOperand scratch;
+    scratch.file  = D3D9SWVPRegFile::Temp;
+    scratch.index = MaxTemps - 1;
+
+    // Compute all rows first in case the
+    // destination aliases a source operand
+    for (uint32_t i = 0; i < Rows; i++) {
+      D3D9SWVPInstruction dot = Ins;
+      dot.opcode = Columns == 4 ? DxsoOpcode::Dp4 : DxsoOpcode::Dp3;
+      dot.dst    = scratch;
+      dot.dst.mask = DxsoRegMask(uint8_t(1u << i));
+      dot.src[1].index += i;
+
+      m_instructions.push_back(dot);
+    }
+
+    // Results go to the first enabled components of the
+    // destination in order, as with the shader compiler
+    std::array<uint32_t, 4> swizzle = { 0, 0, 0, 0 };
+    uint8_t mask = 0;
+
+    for (uint32_t i = 0, row = 0; i < 4 && row < Rows; i++) {
+      if (Ins.dst.mask[i]) {
+        swizzle[i] = row++;
+        mask |= 1u << i;
+      }
+    }
+
+    D3D9SWVPInstruction mov = { };
+    mov.opcode   = DxsoOpcode::Mov;
+    mov.dst      = Ins.dst;
+    mov.dst.mask = DxsoRegMask(mask);
+    mov.src[0]   = scratch;
+    mov.src[0].swizzle = DxsoRegSwizzle(swizzle[0], swizzle[1], swizzle[2], swizzle[3]);
+
+    m_instructions.push_back(mov);
+  }
+
+
+  D3D9SWVPProcessor::D3D9SWVPProcessor()
+  : m_temps   (D3D9SWVPProgram::MaxTemps),
+    m_inputs  (D3D9SWVPProgram::MaxInputs),
+    m_outputs (D3D9SWVPProgram::MaxOutputs) {
+
+  }
+
+
+  D3D9SWVPProcessor::~D3D9SWVPProcessor() {
+
+  }
+
+
+  const D3D9SWVPProgram* D3D9SWVPProcessor::GetProgram(
+          D3D9VertexShader*             pShader) {
+    DxvkShaderKey key = pShader->GetCommonShader()->GetShader(
+      D3D9ShaderPermutations::None)->getShaderKey();
+
+    auto entry = m_programs.find(key);
+
+    if (entry != m_programs.end())
+      return entry->second.get();
+
+    UINT size = 0;
+    pShader->GetFunction(nullptr, &size);
+
+    std::vector<uint32_t> code(align(size, sizeof(uint32_t)) / sizeof(uint32_t));
+    pShader->GetFunction(code.data(), &size);
+
+    auto program = D3D9SWVPProgram::Decode(code.data());
+
+    if (!program) {
+      Logger::warn(str::format("D3D9SWVPProcessor: Shader ",
+        key.toString(), " not supported for CPU vertex processing"));
+    }
+
+    return m_programs.emplace(key, std::move(program)).first->second.get();
+  }
+
+
+  bool D3D9SWVPProcessor::SupportsType(
+          D3DDECLTYPE                   Type) {
+    switch (Type) {
+      case D3DDECLTYPE_FLOAT1:
+      case D3DDECLTYPE_FLOAT2:
+      case D3DDECLTYPE_FLOAT3:
+      case D3DDECLTYPE_FLOAT4:
+      case D3DDECLTYPE_D3DCOLOR:
+      case D3DDECLTYPE_UBYTE4:
+      case D3DDECLTYPE_UBYTE4N:
+      case D3DDECLTYPE_SHORT2:
+      case D3DDECLTYPE_SHORT4:
+      case D3DDECLTYPE_SHORT2N:
+      case D3DDECLTYPE_SHORT4N:
+      case D3DDECLTYPE_USHORT2N:
+      case D3DDECLTYPE_USHORT4N:
+      case D3DDECLTYPE_UDEC3:
+      case D3DDECLTYPE_DEC3N:
+      case D3DDECLTYPE_FLOAT16_2:
+      case D3DDECLTYPE_FLOAT16_4:
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+
+  static Vector4 TransformPosition(
+    const Vector4&                      Position,
+    const D3DVIEWPORT9&                 Viewport) {
+    float rhw = Position.w != 0.0f ? 1.0f / Position.w : 1.0f;
+
+    return Vector4(
+      float(Viewport.X) + (1.0f + Position.x * rhw) * float(Viewport.Width)  * 0.5f,
+      float(Viewport.Y) + (1.0f - Position.y * rhw) * float(Viewport.Height) * 0.5f,
+      Viewport.MinZ + Position.z * rhw * (Viewport.MaxZ - Viewport.MinZ),
+      rhw);
+  }
+
+
+  void D3D9SWVPProcessor::Run(
+    const D3D9SWVPProgram&              Program,
+    const D3D9SWVPArgs&                 Args) {
+    const Vector4* consts     = Args.consts;
+          uint32_t constCount = Args.constCount;
+
+    // Indexed reads must see constants defined by the
+    // shader, direct reads already use immediates
+    if (Program.UsesRelativeConstants() && !Program.GetDefinitions().empty()) {
+      m_consts.assign(consts, consts + constCount);
+
+      for (const auto& def : Program.GetDefinitions()) {
+        if (def.first < constCount)
+          m_consts[def.first] = Program.GetImmediates()[def.second];
+      }
+
+      consts = m_consts.data();
+    }
+
+    for (uint32_t base = 0; base < Args.vertexCount; base += BatchSize) {
+      uint32_t count = std::min(BatchSize, Args.vertexCount - base);
+
+      for (uint32_t i = 0; i < D3D9SWVPProgram::MaxInputs; i++) {
+        if (Program.GetInputMask() & (1u << i))
+          std::fill(m_inputs[i].begin(), m_inputs[i].begin() + count, Program.GetInputDefault(i));
+      }
+
+      for (const auto& input : Args.inputs) {
+        const uint8_t* data = input.data + size_t(base) * input.stride;
+
+        for (uint32_t i = 0; i < count; i++)
+          m_inputs[input.reg][i] = FetchElement(data + size_t(i) * input.stride, input.type);
+      }
+
+      RunBatch(Program, consts, constCount, count, Args.floatEmulation);
+
+      for (const auto& output : Args.outputs) {
+        uint8_t* data = output.data + size_t(base) * output.stride;
+
+        for (uint32_t i = 0; i < count; i++) {
+          Vector4 value = m_outputs[output.reg][i];
+
+          if (int32_t(output.reg) == Args.positionOutput)
+            value = TransformPosition(value, Args.viewport);
+
+          StoreElement(data + size_t(i) * output.stride, output.type, value);
+        }
+      }
+
+      for (const auto& copy : Args.copies) {
+        const uint8_t* src = copy.first.data  + size_t(base) * copy.first.stride;
+              uint8_t* dst = copy.second.data + size_t(base) * copy.second.stride;
+
+        for (uint32_t i = 0; i < count; i++) {
+          StoreElement(dst + size_t(i) * copy.second.stride, copy.second.type,
+            FetchElement(src + size_t(i) * copy.first.stride, copy.first.type));
+        }
+      }
+    }
+  }
+
+
+  void D3D9SWVPProcessor::RunBatch(
+    const D3D9SWVPProgram&              Program,
+    const Vector4*                      pConsts,
+          uint32_t                      ConstCount,
+          uint32_t                      Count,
+          bool                          FloatEmu) {
+    for (auto& reg : m_temps)
+      std::fill(reg.begin(), reg.begin() + Count, Vector4());
+
+    for (auto& reg : m_outputs)
+      std::fill(reg.begin(), reg.begin() + Count, Vector4());
+
+    std::fill(m_addr.begin(), m_addr.begin() + Count, Vector4());
+
+    // D3D9 defines 0 * x as 0 even for inf and nan
+    auto mul = [FloatEmu] (float a, float b) {
+      return (FloatEmu && (a == 0.0f || b == 0.0f)) ? 0.0f : a * b;
+    };
+
+    auto clampMax = [FloatEmu] (float v) {
+      return FloatEmu ? std::min(v, FLT_MAX) : v;
+    };
+
+    // Each opcode gets its own loop over the batch, so that the
+    // opcode is only dispatched once per instruction and batch.
+    auto forEachVertex = [this, Count] (auto&& fn) {
+      for (uint32_t i = 0; i < Count; i++)
+        fn(m_result[i], m_srcs[0][i], m_srcs[1][i], m_srcs[2][i]);
+    };
+
+    using V = const Vector4&;
+
+    for (const auto& ins : Program.GetInstructions()) {
+      for (uint32_t i = 0; i < GetSourceCount(ins.opcode); i++)
+        LoadOperand(Program, ins.src[i], pConsts, ConstCount, Count, m_srcs[i]);
+
+      switch (ins.opcode) {
+        case DxsoOpcode::Mov:
+        case DxsoOpcode::Mova:
+          forEachVertex([] (Vector4& r, V a, V, V) {
+            r = a;
+          });
+          break;
+
+        case DxsoOpcode::Add:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] + b[c];
+          });
+          break;
+
+        case DxsoOpcode::Sub:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] - b[c];
+          });
+          break;
+
+        case DxsoOpcode::Mad:
+          forEachVertex([mul] (Vector4& r, V a, V b, V d) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = mul(a[c], b[c]) + d[c];
+          });
+          break;
+
+        case DxsoOpcode::Mul:
+          forEachVertex([mul] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = mul(a[c], b[c]);
+          });
+          break;
+
+        case DxsoOpcode::Rcp:
+          forEachVertex([clampMax] (Vector4& r, V a, V, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = clampMax(1.0f / a[c]);
+          });
+          break;
+
+        case DxsoOpcode::Rsq:
+          forEachVertex([clampMax] (Vector4& r, V a, V, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = clampMax(1.0f / std::sqrt(std::abs(a[c])));
+          });
+          break;
+
+        case DxsoOpcode::Dp3:
+          forEachVertex([mul] (Vector4& r, V a, V b, V) {
+            r = Vector4(mul(a.x, b.x)
+                      + mul(a.y, b.y)
+                      + mul(a.z, b.z));
+          });
+          break;
+
+        case DxsoOpcode::Dp4:
+          forEachVertex([mul] (Vector4& r, V a, V b, V) {
+            r = Vector4(mul(a.x, b.x)
+                      + mul(a.y, b.y)
+                      + mul(a.z, b.z)
+                      + mul(a.w, b.w));
+          });
+          break;
+
+        case DxsoOpcode::Min:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = std::min(a[c], b[c]);
+          });
+          break;
+
+        case DxsoOpcode::Max:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = std::max(a[c], b[c]);
+          });
+          break;
+
+        case DxsoOpcode::Slt:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] < b[c] ? 1.0f : 0.0f;
+          });
+          break;
+
+        case DxsoOpcode::Sge:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] >= b[c] ? 1.0f : 0.0f;
+          });
+          break;
+
+        case DxsoOpcode::ExpP:
+          // Only vs_1_x uses the partial
+          // precision result layout
+          if (Program.GetMajorVersion() < 2) {
+            forEachVertex([clampMax] (Vector4& r, V a, V, V) {
+              float x = a.x;
+              r = Vector4(
+                clampMax(std::exp2(std::floor(x))),
+                clampMax(x - std::floor(x)),
+                clampMax(std::exp2(x)),
+                1.0f);
+            });
+            break;
+          }
+          [[fallthrough]];
+
+        case DxsoOpcode::Exp:
+          forEachVertex([clampMax] (Vector4& r, V a, V, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = clampMax(std::exp2(a[c]));
+          });
+          break;
+
+        case DxsoOpcode::Log:
+        case DxsoOpcode::LogP:
+          forEachVertex([FloatEmu] (Vector4& r, V a, V, V) {
+            for (uint32_t c = 0; c < 4; c++) {
+              r[c] = std::log2(std::abs(a[c]));
+
+              if (FloatEmu)
+                r[c] = std::max(r[c], -FLT_MAX);
+            }
+          });
+          break;
+
+        case DxsoOpcode::Lit:
+          // Matches the reference implementation, which
+          // only writes y and z for positive inputs
+          forEachVertex([] (Vector4& r, V a, V, V) {
+            float p = std::clamp(a.w, -127.9961f, 127.9961f);
+
+            r = Vector4(1.0f,
+              a.x > 0.0f ? a.x : 0.0f,
+              (a.x > 0.0f && a.y > 0.0f) ? std::pow(a.y, p) : 0.0f,
+              1.0f);
+          });
+          break;
+
+        case DxsoOpcode::Dst:
+          forEachVertex([mul] (Vector4& r, V a, V b, V) {
+            r = Vector4(1.0f, mul(a.y, b.y), a.z, b.w);
+          });
+          break;
+
+        case DxsoOpcode::Lrp:
+          forEachVertex([] (Vector4& r, V a, V b, V d) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = d[c] + a[c] * (b[c] - d[c]);
+          });
+          break;
+
+        case DxsoOpcode::Frc:
+          forEachVertex([] (Vector4& r, V a, V, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] - std::floor(a[c]);
+          });
+          break;
+
+        case DxsoOpcode::Pow:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = std::pow(std::abs(a[c]), b[c]);
+          });
+          break;
+
+        case DxsoOpcode::Crs:
+          forEachVertex([] (Vector4& r, V a, V b, V) {
+            r = Vector4(
+              a.y * b.z - a.z * b.y,
+              a.z * b.x - a.x * b.z,
+              a.x * b.y - a.y * b.x,
+              0.0f);
+          });
+          break;
+
+        case DxsoOpcode::Sgn:
+          forEachVertex([] (Vector4& r, V a, V, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] > 0.0f ? 1.0f : (a[c] < 0.0f ? -1.0f : 0.0f);
+          });
+          break;
+
+        case DxsoOpcode::Abs:
+          forEachVertex([] (Vector4& r, V a, V, V) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = std::abs(a[c]);
+          });
+          break;
+
+        case DxsoOpcode::Nrm:
+          forEachVertex([mul, clampMax] (Vector4& r, V a, V, V) {
+            float dot = a.x * a.x
+                      + a.y * a.y
+                      + a.z * a.z;
+            float rcpLength = clampMax(1.0f / std::sqrt(dot));
+
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = mul(a[c], rcpLength);
+          });
+          break;
+
+        case DxsoOpcode::SinCos:
+          forEachVertex([] (Vector4& r, V a, V, V) {
+            r = Vector4(std::cos(a.x), std::sin(a.x), 0.0f, 0.0f);
+          });
+          break;
+
+        case DxsoOpcode::Cmp:
+          forEachVertex([] (Vector4& r, V a, V b, V d) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] >= 0.0f ? b[c] : d[c];
+          });
+          break;
+
+        case DxsoOpcode::Cnd:
+          forEachVertex([] (Vector4& r, V a, V b, V d) {
+            for (uint32_t c = 0; c < 4; c++)
+              r[c] = a[c] > 0.5f ? b[c] : d[c];
+          });
+          break;
+
+        default:
+          std::fill(m_result.begin(), m_result.begin() + Count, Vector4());
+      }
+
+      StoreResult(ins.dst, Count, Program.FloorAddress());
+    }
+  }
+
+
+  void D3D9SWVPProcessor::LoadOperand(
+    const D3D9SWVPProgram&              Program,
+    const D3D9SWVPOperand&              Operand,
+    const Vector4*                      pConsts,
+          uint32_t                      ConstCount,
+          uint32_t                      Count,
+          RegBatch&                     Dst) {
+    const RegBatch* regs = nullptr;
+
+    switch (Operand.file) {
+      case D3D9SWVPRegFile::Temp:   regs = &m_temps[Operand.index];   break;
+      case D3D9SWVPRegFile::Input:  regs = &m_inputs[Operand.index];  break;
+      case D3D9SWVPRegFile::Output: regs = &m_outputs[Operand.index]; break;
+      case D3D9SWVPRegFile::Addr:   regs = &m_addr;                   break;
+
+      case D3D9SWVPRegFile::Imm:
+        std::fill(Dst.begin(), Dst.begin() + Count, Program.GetImmediates()[Operand.index]);
+        break;
+
+      case D3D9SWVPRegFile::Const:
+        if (!Operand.relative) {
+          Vector4 value = Operand.index < ConstCount
+            ? pConsts[Operand.index] : Vector4();
+          std::fill(Dst.begin(), Dst.begin() + Count, value);
+        } else {
+          // Out of bounds reads return zero
+          for (uint32_t i = 0; i < Count; i++) {
+            int32_t index = int32_t(Operand.index)
+              + int32_t(m_addr[i][Operand.relComponent]);
+
+            Dst[i] = (index >= 0 && uint32_t(index) < ConstCount)
+              ? pConsts[index] : Vector4();
+          }
+        }
+        break;
+    }
+
+    if (regs) {
+      if (Operand.swizzle == IdentitySwizzle) {
+        std::copy(regs->begin(), regs->begin() + Count, Dst.begin());
+      } else {
+        for (uint32_t i = 0; i < Count; i++) {
+          const Vector4& v = (*regs)[i];
+
+          Dst[i] = Vector4(
+            v[Operand.swizzle[0]], v[Operand.swizzle[1]],
+            v[Operand.swizzle[2]], v[Operand.swizzle[3]]);
+        }
+      }
+    } else if (Operand.swizzle != IdentitySwizzle) {
+      for (uint32_t i = 0; i < Count; i++) {
+        Vector4 v = Dst[i];
+
+        Dst[i] = Vector4(
+          v[Operand.swizzle[0]], v[Operand.swizzle[1]],
+          v[Operand.swizzle[2]], v[Operand.swizzle[3]]);
+      }
+    }
+
+    if (Operand.modifier == DxsoRegModifier::None)
+      return;
+
+    for (uint32_t i = 0; i < Count; i++) {
+      for (uint32_t c = 0; c < 4; c++) {
+        float& v = Dst[i][c];
+
+        switch (Operand.modifier) {
+          case DxsoRegModifier::Neg:     v = -v;                  break;
+          case DxsoRegModifier::Bias:    v = v - 0.5f;            break;
+          case DxsoRegModifier::BiasNeg: v = -(v - 0.5f);         break;
+          case DxsoRegModifier::Sign:    v = v * 2.0f - 1.0f;     break;
+          case DxsoRegModifier::SignNeg: v = -(v * 2.0f - 1.0f);  break;
+          case DxsoRegModifier::Comp:    v = 1.0f - v;            break;
+          case DxsoRegModifier::X2:      v = v * 2.0f;            break;
+          case DxsoRegModifier::X2Neg:   v = -(v * 2.0f);         break;
+          case DxsoRegModifier::Abs:     v = std::abs(v);         break;
+          case DxsoRegModifier::AbsNeg:  v = -std::abs(v);        break;
+          default: break;
+        }
+      }
+    }
+  }
+
+
+  void D3D9SWVPProcessor::StoreResult(
+    const D3D9SWVPOperand&              Operand,
+          uint32_t                      Count,
+          bool                          FloorAddr) {
+    RegBatch* regs = nullptr;
+
+    switch (Operand.file) {
+      case D3D9SWVPRegFile::Temp:   regs = &m_temps[Operand.index];   break;
+      case D3D9SWVPRegFile::Output: regs = &m_outputs[Operand.index]; break;
+      case D3D9SWVPRegFile::Addr:   regs = &m_addr;                   break;
+      default: return;
+    }
+
+    const bool isAddr = Operand.file == D3D9SWVPRegFile::Addr;
+
+    for (uint32_t i = 0; i < Count; i++) {
+      for (uint32_t c = 0; c < 4; c++) {
+        if (!Operand.mask[c])
+          continue;
+
+        float value = m_result[i][c];
+
+        if (isAddr)
+          value = FloorAddr ? std::floor(value) : std::round(value);
+
+        if (Operand.saturate)
+          value = std::clamp(value, 0.0f, 1.0f);
+
+        (*regs)[i][c] = value;
+      }
+    }
+  }
+
+
+  static float HalfToFloat(uint16_t Value) {
+    uint32_t sign = uint32_t(Value & 0x8000) << 16;
+    uint32_t exp  = (Value >> 10) & 0x1f;
+    uint32_t frac = Value & 0x3ff;
+
+    float result;
+
+    if (exp == 0)
+      result = std::ldexp(float(frac), -24);
+    else if (exp == 0x1f)
+      result = frac ? NAN : INFINITY;
+    else
+      result = std::ldexp(float(frac | 0x400), int32_t(exp) - 25);
+
+    return sign ? -result : result;
+  }
+
+
+  static uint16_t FloatToHalf(float Value) {
+    uint16_t sign = std::signbit(Value) ? 0x8000 : 0x0000;
+    float    abs  = std::abs(Value);
+
+    if (std::isnan(Value))
+      return sign | 0x7e00;
+
+    if (abs >= 65520.0f)
+      return sign | 0x7c00;
+
+    if (abs < 6.103515625e-05f)
+      return sign | uint16_t(std::lround(abs * 16777216.0f));
+
+    int32_t exp;
+    float   frac = std::frexp(abs, &exp);
+
+    uint32_t bits = uint32_t(std::lround(std::ldexp(frac, 11)));
+    uint32_t e    = uint32_t(exp + 14);
+
+    // Rounding may carry into the exponent
+    if (bits == 0x800) {
+      bits >>= 1;
+      e += 1;
+    }
+
+    return sign | uint16_t((e << 10) | (bits & 0x3ff));
+  }
+
+
+  Vector4 D3D9SWVPProcessor::FetchElement(
+    const uint8_t*                      pData,
+          D3DDECLTYPE                   Type) {
+    auto load = [pData] (auto value, uint32_t index) {
+      std::memcpy(&value, pData + index * sizeof(value), sizeof(value));
+      return value;
+    };
+
+    auto snorm = [] (float value, float max) {
+      return std::max(value / max, -1.0f);
+    };
+
+    switch (Type) {
+      case D3DDECLTYPE_FLOAT1:
+        return Vector4(load(0.0f, 0), 0.0f, 0.0f, 1.0f);
+
+      case D3DDECLTYPE_FLOAT2:
+        return Vector4(load(0.0f, 0), load(0.0f, 1), 0.0f, 1.0f);
+
+      case D3DDECLTYPE_FLOAT3:
+        return Vector4(load(0.0f, 0), load(0.0f, 1), load(0.0f, 2), 1.0f);
+
+      case D3DDECLTYPE_FLOAT4:
+        return Vector4(load(0.0f, 0), load(0.0f, 1), load(0.0f, 2), load(0.0f, 3));
+
+      case D3DDECLTYPE_D3DCOLOR:
+        // Stored as BGRA
+        return Vector4(
+          float(pData[2]) / 255.0f, float(pData[1]) / 255.0f,
+          float(pData[0]) / 255.0f, float(pData[3]) / 255.0f);
+
+      case D3DDECLTYPE_UBYTE4:
+        return Vector4(float(pData[0]), float(pData[1]), float(pData[2]), float(pData[3]));
+
+      case D3DDECLTYPE_UBYTE4N:
+        return Vector4(
+          float(pData[0]) / 255.0f, float(pData[1]) / 255.0f,
+          float(pData[2]) / 255.0f, float(pData[3]) / 255.0f);
+
+      case D3DDECLTYPE_SHORT2:
+        return Vector4(float(load(int16_t(), 0)), float(load(int16_t(), 1)), 0.0f, 1.0f);
+
+      case D3DDECLTYPE_SHORT4:
+        return Vector4(
+          float(load(int16_t(), 0)), float(load(int16_t(), 1)),
+          float(load(int16_t(), 2)), float(load(int16_t(), 3)));
+
+      case D3DDECLTYPE_SHORT2N:
+        return Vector4(
+          snorm(float(load(int16_t(), 0)), 32767.0f),
+          snorm(float(load(int16_t(), 1)), 32767.0f),
+          0.0f, 1.0f);
+
+      case D3DDECLTYPE_SHORT4N:
+        return Vector4(
+          snorm(float(load(int16_t(), 0)), 32767.0f),
+          snorm(float(load(int16_t(), 1)), 32767.0f),
+          snorm(float(load(int16_t(), 2)), 32767.0f),
+          snorm(float(load(int16_t(), 3)), 32767.0f));
+
+      case D3DDECLTYPE_USHORT2N:
+        return Vector4(
+          float(load(uint16_t(), 0)) / 65535.0f,
+          float(load(uint16_t(), 1)) / 65535.0f,
+          0.0f, 1.0f);
+
+      case D3DDECLTYPE_USHORT4N:
+        return Vector4(
+          float(load(uint16_t(), 0)) / 65535.0f,
+          float(load(uint16_t(), 1)) / 65535.0f,
+          float(load(uint16_t(), 2)) / 65535.0f,
+          float(load(uint16_t(), 3)) / 65535.0f);
+
+      case D3DDECLTYPE_UDEC3: {
+        uint32_t value = load(uint32_t(), 0);
+
+        return Vector4(
+          float((value >>  0) & 0x3ff),
+          float((value >> 10) & 0x3ff),
+          float((value >> 20) & 0x3ff),
+          1.0f);
+      }
+
+      case D3DDECLTYPE_DEC3N: {
+        uint32_t value = load(uint32_t(), 0);
+
+        return Vector4(
+          snorm(float(int32_t(value << 22) >> 22), 511.0f),
+          snorm(float(int32_t(value << 12) >> 22), 511.0f),
+          snorm(float(int32_t(value <<  2) >> 22), 511.0f),
+          1.0f);
+      }
+
+      case D3DDECLTYPE_FLOAT16_2:
+        return Vector4(
+          HalfToFloat(load(uint16_t(), 0)),
+          HalfToFloat(load(uint16_t(), 1)),
+          0.0f, 1.0f);
+
+      case D3DDECLTYPE_FLOAT16_4:
+        return Vector4(
+          HalfToFloat(load(uint16_t(), 0)), HalfToFloat(load(uint16_t(), 1)),
+          HalfToFloat(load(uint16_t(), 2)), HalfToFloat(load(uint16_t(), 3)));
+
+      default:
+        return Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+  }
+
+
+  void D3D9SWVPProcessor::StoreElement(
+          uint8_t*                      pData,
+          D3DDECLTYPE                   Type,
+    const Vector4&                      Value) {
+    auto store = [pData] (auto value, uint32_t index) {
+      std::memcpy(pData + index * sizeof(value), &value, sizeof(value));
+    };
+
+    auto unorm = [] (float value, float max) {
+      return std::lround(std::clamp(value, 0.0f, 1.0f) * max);
+    };
+
+    auto snorm = [] (float value, float max) {
+      return std::lround(std::clamp(value, -1.0f, 1.0f) * max);
+    };
+
+    auto sint = [] (float value, float min, float max) {
+      return std::lround(std::clamp(value, min, max));
+    };
+
+    switch (Type) {
+      case D3DDECLTYPE_FLOAT4: store(Value.w, 3); [[fallthrough]];
+      case D3DDECLTYPE_FLOAT3: store(Value.z, 2); [[fallthrough]];
+      case D3DDECLTYPE_FLOAT2: store(Value.y, 1); [[fallthrough]];
+      case D3DDECLTYPE_FLOAT1: store(Value.x, 0); break;
+
+      case D3DDECLTYPE_D3DCOLOR:
+        pData[0] = uint8_t(unorm(Value.z, 255.0f));
+        pData[1] = uint8_t(unorm(Value.y, 255.0f));
+        pData[2] = uint8_t(unorm(Value.x, 255.0f));
+        pData[3] = uint8_t(unorm(Value.w, 255.0f));
+        break;
+
+      case D3DDECLTYPE_UBYTE4:
+        for (uint32_t i = 0; i < 4; i++)
+          pData[i] = uint8_t(sint(Value[i], 0.0f, 255.0f));
+        break;
+
+      case D3DDECLTYPE_UBYTE4N:
+        for (uint32_t i = 0; i < 4; i++)
+          pData[i] = uint8_t(unorm(Value[i], 255.0f));
+        break;
+
+      case D3DDECLTYPE_SHORT4:
+        store(int16_t(sint(Value.z, -32768.0f, 32767.0f)), 2);
+        store(int16_t(sint(Value.w, -32768.0f, 32767.0f)), 3);
+        [[fallthrough]];
+      case D3DDECLTYPE_SHORT2:
+        store(int16_t(sint(Value.x, -32768.0f, 32767.0f)), 0);
+        store(int16_t(sint(Value.y, -32768.0f, 32767.0f)), 1);
+        break;
+
+      case D3DDECLTYPE_SHORT4N:
+        store(int16_t(snorm(Value.z, 32767.0f)), 2);
+        store(int16_t(snorm(Value.w, 32767.0f)), 3);
+        [[fallthrough]];
+      case D3DDECLTYPE_SHORT2N:
+        store(int16_t(snorm(Value.x, 32767.0f)), 0);
+        store(int16_t(snorm(Value.y, 32767.0f)), 1);
+        break;
+
+      case D3DDECLTYPE_USHORT4N:
+        store(uint16_t(unorm(Value.z, 65535.0f)), 2);
+        store(uint16_t(unorm(Value.w, 65535.0f)), 3);
+        [[fallthrough]];
+      case D3DDECLTYPE_USHORT2N:
+        store(uint16_t(unorm(Value.x, 65535.0f)), 0);
+        store(uint16_t(unorm(Value.y, 65535.0f)), 1);
+        break;
+
+      case D3DDECLTYPE_UDEC3:
+        store(uint32_t(sint(Value.x, 0.0f, 1023.0f))
+           | (uint32_t(sint(Value.y, 0.0f, 1023.0f)) << 10)
+           | (uint32_t(sint(Value.z, 0.0f, 1023.0f)) << 20), 0);
+        break;
+
+      case D3DDECLTYPE_DEC3N:
+        store((uint32_t(snorm(Value.x, 511.0f)) & 0x3ff)
+           | ((uint32_t(snorm(Value.y, 511.0f)) & 0x3ff) << 10)
+           | ((uint32_t(snorm(Value.z, 511.0f)) & 0x3ff) << 20), 0);
+        break;
+
+      case D3DDECLTYPE_FLOAT16_4:
+        store(FloatToHalf(Value.z), 2);
+        store(FloatToHalf(Value.w), 3);
+        [[fallthrough]];
+      case D3DDECLTYPE_FLOAT16_2:
+        store(FloatToHalf(Value.x), 0);
+        store(FloatToHalf(Value.y), 1);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "d3d9_include.h"
+
+#include "../dxso/dxso_decoder.h"
+
+#include "../dxvk/dxvk_shader_key.h"
+
+#include "../util/util_vector.h"
+
+namespace dxvk {
+
+  class D3D9VertexShader;
+
+  /**
+   * \brief Register file for CPU vertex processing
+   */
+  enum class D3D9SWVPRegFile : uint8_t {
+    Temp,       ///< Temporary registers
+    Input,      ///< Vertex inputs
+    Output,     ///< Vertex outputs
+    Addr,       ///< Address register
+    Const,      ///< Float constants
+    Imm,        ///< Constants defined in the shader
+  };
+
+
+  /**
+   * \brief Decoded operand
+   */
+  struct D3D9SWVPOperand {
+    D3D9SWVPRegFile   file          = D3D9SWVPRegFile::Temp;
+    uint32_t          index         = 0;
+    DxsoRegSwizzle    swizzle       = IdentitySwizzle;
+    DxsoRegModifier   modifier      = DxsoRegModifier::None;
+    DxsoRegMask       mask          = IdentityWriteMask;
+    bool              saturate      = false;
+    bool              relative      = false;
+    uint32_t          relComponent  = 0;
+  };
+
+
+  /**
+   * \brief Decoded instruction
+   */
+  struct D3D9SWVPInstruction {
+    DxsoOpcode                      opcode;
+    D3D9SWVPOperand                 dst;
+    std::array<D3D9SWVPOperand, 3>  src;
+  };
+
+
+  /**
+   * \brief Vertex program for CPU vertex processing
+   *
+   * DXSO vertex shader or fixed-function transform,
+   * decoded into a form that can be interpreted
+   * efficiently. Matrix instructions are lowered
+   * to dot products when decoding.
+   */
+  class D3D9SWVPProgram {
+
+  public:
+
+    constexpr static uint32_t MaxTemps   = DxsoMaxTempRegs + 1;
+    constexpr static uint32_t MaxInputs  = DxsoMaxInterfaceRegs;
+    constexpr static uint32_t MaxOutputs = DxsoMaxInterfaceRegs;
+
+    /**
+     * \brief Decodes a DXSO vertex shader
+     *
+     * \param [in] pBytecode Shader bytecode
+     * \returns Program, or \c nullptr if the shader
+     *    uses features that are not supported.
+     */
+    static std::unique_ptr<D3D9SWVPProgram> Decode(
+      const uint32_t*               pBytecode);
+
+    /**
+     * \brief Creates fixed-function transform program
+     *
+     * Transforms the position by the matrix stored in
+     * constants \c c0 to \c c3 and passes through vertex
+     * colors and texture coordinates. Does not support
+     * lighting, vertex blending or texture transforms.
+     * \param [in] TexcoordIndices Input texture coordinate
+     *    set for each output texture coordinate
+     * \returns Program
+     */
+    static std::unique_ptr<D3D9SWVPProgram> CreateFixedFunction(
+      const std::array<uint32_t, 8>& TexcoordIndices);
+
+    const std::vector<D3D9SWVPInstruction>& GetInstructions() const {
+      return m_instructions;
+    }
+
+    const std::vector<Vector4>& GetImmediates() const {
+      return m_immediates;
+    }
+
+    const std::vector<std::pair<uint32_t, uint32_t>>& GetDefinitions() const {
+      return m_definitions;
+    }
+
+    uint32_t GetInputMask() const { return m_inputMask; }
+    uint32_t GetOutputMask() const { return m_outputMask; }
+
+    DxsoSemantic GetInputSemantic(uint32_t Index) const {
+      return m_inputs[Index];
+    }
+
+    DxsoSemantic GetOutputSemantic(uint32_t Index) const {
+      return m_outputs[Index];
+    }
+
+    Vector4 GetInputDefault(uint32_t Index) const {
+      return m_inputDefaults[Index];
+    }
+
+    bool UsesRelativeConstants() const {
+      return m_relativeConsts;
+    }
+
+    bool FloorAddress() const {
+      return m_floorAddress;
+    }
+
+    uint32_t GetMajorVersion() const {
+      return m_majorVersion;
+    }
+
+  private:
+
+    std::vector<D3D9SWVPInstruction>  m_instructions;
+    std::vector<Vector4>              m_immediates;
+
+    // Pairs of constant register and immediate index
+    std::vector<std::pair<uint32_t, uint32_t>> m_definitions;
+
+    std::array<DxsoSemantic, MaxInputs>   m_inputs        = { };
+    std::array<Vector4,      MaxInputs>   m_inputDefaults = { };
+    std::array<DxsoSemantic, MaxOutputs>  m_outputs       = { };
+
+    uint32_t m_inputMask      = 0;
+    uint32_t m_outputMask     = 0;
+
+    uint32_t m_majorVersion   = 0;
+
+    bool     m_relativeConsts = false;
+    bool     m_floorAddress   = false;
+
+    bool DecodeInstruction(
+      const DxsoProgramInfo&              Info,
+      const DxsoInstructionContext&       Ctx);
+
+    bool DecodeOperand(
+      const DxsoProgramInfo&              Info,
+      const DxsoRegister&                 Reg,
+            bool                          IsDst,
+            D3D9SWVPOperand&              Operand);
+
+    void AddOutput(
+            uint32_t                      Index,
+            DxsoUsage                     Usage,
+            uint32_t                      UsageIndex);
+
+    void LowerMatrix(
+      const D3D9SWVPInstruction&          Ins,
+            uint32_t                      Rows,
+            uint32_t                      Columns);
+
+  };
+
+
+  /**
+   * \brief Vertex element for CPU vertex processing
+   */
+  struct D3D9SWVPElement {
+    uint8_t*          data;     ///< Pointer to the first vertex
+    uint32_t          stride;   ///< Vertex stride, in bytes
+    D3DDECLTYPE       type;     ///< Element data type
+    uint32_t          reg;      ///< Input or output register
+  };
+
+
+  /**
+   * \brief Arguments for CPU vertex processing
+   */
+  struct D3D9SWVPArgs {
+    uint32_t                      vertexCount;
+    const Vector4*                consts;
+    uint32_t                      constCount;
+    std::vector<D3D9SWVPElement>  inputs;
+    std::vector<D3D9SWVPElement>  outputs;
+    std::vector<std::pair<D3D9SWVPElement, D3D9SWVPElement>> copies;
+    int32_t                       positionOutput;
+    D3DVIEWPORT9                  viewport;
+    bool                          floatEmulation;
+  };
+
+
+  /**
+   * \brief CPU vertex processor
+   *
+   * Runs vertex programs on the CPU for \c ProcessVertices.
+   * Vertices are processed in batches, one instruction at
+   * a time for the whole batch, so that the cost of
+   * interpreting an instruction is amortized.
+   */
+  class D3D9SWVPProcessor {
+    constexpr static uint32_t BatchSize = 64;
+  public:
+
+    D3D9SWVPProcessor();
+
+    ~D3D9SWVPProcessor();
+
+    /**
+     * \brief Looks up or decodes program for a shader
+     *
+     * \param [in] pShader Vertex shader
+     * \returns Program, or \c nullptr if the
+     *    shader cannot be run on the CPU
+     */
+    const D3D9SWVPProgram* GetProgram(
+            D3D9VertexShader*             pShader);
+
+    /**
+     * \brief Checks whether a vertex format is supported
+     *
+     * \param [in] Type Vertex element type
+     * \returns \c true if the type can be read and written
+     */
+    static bool SupportsType(
+            D3DDECLTYPE                   Type);
+
+    /**
+     * \brief Processes vertices
+     *
+     * \param [in] Program Vertex program
+     * \param [in] Args Vertex data and state
+     */
+    void Run(
+      const D3D9SWVPProgram&              Program,
+      const D3D9SWVPArgs&                 Args);
+
+  private:
+
+    using RegBatch = std::array<Vector4, BatchSize>;
+
+    std::unordered_map<DxvkShaderKey,
+      std::unique_ptr<D3D9SWVPProgram>,
+      DxvkHash, DxvkEq>                   m_programs;
+
+    std::vector<RegBatch>                 m_temps;
+    std::vector<RegBatch>                 m_inputs;
+    std::vector<RegBatch>                 m_outputs;
+    RegBatch                              m_addr;
+
+    std::array<RegBatch, 3>               m_srcs;
+    RegBatch                              m_result;
+
+    std::vector<Vector4>                  m_consts;
+
+    void RunBatch(
+      const D3D9SWVPProgram&              Program,
+      const Vector4*                      pConsts,
+            uint32_t                      ConstCount,
+            uint32_t                      Count,
+            bool                          FloatEmu);
+
+    void LoadOperand(
+      const D3D9SWVPProgram&              Program,
+      const D3D9SWVPOperand&              Operand,
+      const Vector4*                      pConsts,
+            uint32_t                      ConstCount,
+            uint32_t                      Count,
+            RegBatch&                     Dst);
+
+    void StoreResult(
+      const D3D9SWVPOperand&              Operand,
+            uint32_t                      Count,
+            bool                          FloorAddr);
+
+    static Vector4 FetchElement(
+      const uint8_t*                      pData,
+            D3DDECLTYPE                   Type);
+
+    static void StoreElement(
+            uint8_t*                      pData,
+            D3DDECLTYPE                   Type,
+      const Vector4&                      Value);
+
+  };
+
+}
@@ -80,18 +80,18 @@ namespace dxvk {
 
 
   HRESULT STDMETHODCALLTYPE D3D9Texture2D::AddDirtyRect(CONST RECT* pDirtyRect) {
-    if (pDirtyRect) {
-      D3DBOX box = { UINT(pDirtyRect->left), UINT(pDirtyRect->top), UINT(pDirtyRect->right), UINT(pDirtyRect->bottom), 0, 1 };
-      m_texture.AddDirtyBox(&box, 0);
-    } else {
-      m_texture.AddDirtyBox(nullptr, 0);
-    }
+    D3DBOX box = { 0, 0, 0, 0, 0, 1 };
+
+    if (pDirtyRect)
+      box = { UINT(pDirtyRect->left), UINT(pDirtyRect->top), UINT(pDirtyRect->right), UINT(pDirtyRect->bottom), 0, 1 };
+
+    m_texture.AddDirtyBox(pDirtyRect ? &box : nullptr, 0);
 
     // Some games keep using the pointer returned in LockRect() after calling Unlock()
     // and purely rely on AddDirtyRect to notify D3D9 that contents have changed.
     // We have no way of knowing which mip levels were actually changed.
     if (m_texture.IsManaged())
-      m_texture.SetAllNeedUpload();
+      m_texture.AddUploadBoxAllMips(0, pDirtyRect ? &box : nullptr);
 
     m_parent->TouchMappedTexture(&m_texture);
     return D3D_OK;
@@ -179,7 +179,7 @@ namespace dxvk {
     // and purely rely on AddDirtyBox to notify D3D9 that contents have changed.
     // We have no way of knowing which mip levels were actually changed.
     if (m_texture.IsManaged())
-      m_texture.SetAllNeedUpload();
+      m_texture.AddUploadBoxAllMips(0, pDirtyBox);
 
     m_parent->TouchMappedTexture(&m_texture);
     return D3D_OK;
@@ -262,21 +262,18 @@ namespace dxvk {
 
 
   HRESULT STDMETHODCALLTYPE D3D9TextureCube::AddDirtyRect(D3DCUBEMAP_FACES Face, CONST RECT* pDirtyRect) {
-    if (pDirtyRect) {
-      D3DBOX box = { UINT(pDirtyRect->left), UINT(pDirtyRect->top), UINT(pDirtyRect->right), UINT(pDirtyRect->bottom), 0, 1 };
-      m_texture.AddDirtyBox(&box, Face);
-    } else {
-      m_texture.AddDirtyBox(nullptr, Face);
-    }
+    D3DBOX box = { 0, 0, 0, 0, 0, 1 };
+
+    if (pDirtyRect)
+      box = { UINT(pDirtyRect->left), UINT(pDirtyRect->top), UINT(pDirtyRect->right), UINT(pDirtyRect->bottom), 0, 1 };
+
+    m_texture.AddDirtyBox(pDirtyRect ? &box : nullptr, Face);
 
     // Some games keep using the pointer returned in LockRect() after calling Unlock()
     // and purely rely on AddDirtyRect to notify D3D9 that contents have changed.
     // We have no way of knowing which mip levels were actually changed.
-    if (m_texture.IsManaged()) {
-      for (uint32_t m = 0; m < m_texture.ExposedMipLevels(); m++) {
-        m_texture.SetNeedsUpload(m_texture.CalcSubresource(Face, m), true);
-      }
-    }
+    if (m_texture.IsManaged())
+      m_texture.AddUploadBoxAllMips(Face, pDirtyRect ? &box : nullptr);
 
     m_parent->TouchMappedTexture(&m_texture);
     return D3D_OK;
@@ -39,8 +39,23 @@ namespace dxvk {
   
   
   void DxbcDecodeContext::decodeInstruction(DxbcCodeSlice& code) {
+    DxbcOperandStorage storage;
+    storage.dst     = m_dstOperands.data();
+    storage.src     = m_srcOperands.data();
+    storage.imm     = m_immOperands.data();
+    storage.indices = m_indices.data();
+    
+    this->decodeInstruction(code, storage);
+  }
+  
+  
+  void DxbcDecodeContext::decodeInstruction(
+          DxbcCodeSlice&      code,
+    const DxbcOperandStorage& storage) {
     const uint32_t token0 = code.at(0);
     
+    m_storage = storage;
+    
     // Initialize the instruction structure. Some of these values
     // may not get written otherwise while decoding the instruction.
     m_instruction.op             = static_cast<DxbcOpcode>(bit::extract(token0, 0, 10));
@@ -49,9 +64,9 @@ namespace dxvk {
     m_instruction.dstCount       = 0;
     m_instruction.srcCount       = 0;
     m_instruction.immCount       = 0;
-    m_instruction.dst            = m_dstOperands.data();
-    m_instruction.src            = m_srcOperands.data();
-    m_instruction.imm            = m_immOperands.data();
+    m_instruction.dst            = m_storage.dst;
+    m_instruction.src            = m_storage.src;
+    m_instruction.imm            = m_storage.imm;
     m_instruction.customDataType = DxbcCustomDataClass::Comment;
     m_instruction.customDataSize = 0;
     m_instruction.customData     = nullptr;
@@ -148,7 +163,7 @@ namespace dxvk {
     // Retrieve the instruction format in order to parse the
     // operands. Doing this mostly automatically means that
     // the compiler can rely on the operands being valid.
-    const DxbcInstFormat format = dxbcInstructionFormat(m_instruction.op);
+    const DxbcInstFormat& format = dxbcInstructionFormat(m_instruction.op);
     m_instruction.opClass = format.instructionClass;
     
     for (uint32_t i = 0; i < format.operandCount; i++)
@@ -285,19 +300,19 @@ namespace dxvk {
         
         case DxbcOperandIndexRepresentation::Relative:
           reg.idx[i].offset = 0;
-          reg.idx[i].relReg = &m_indices.at(m_indexId);
+          reg.idx[i].relReg = this->allocIndex();
           
           this->decodeRegister(code,
-            m_indices.at(m_indexId++),
+            *reg.idx[i].relReg,
             DxbcScalarType::Sint32);
           break;
         
         case DxbcOperandIndexRepresentation::Imm32Relative:
           reg.idx[i].offset = static_cast<int32_t>(code.read());
-          reg.idx[i].relReg = &m_indices.at(m_indexId);
+          reg.idx[i].relReg = this->allocIndex();
           
           this->decodeRegister(code,
-            m_indices.at(m_indexId++),
+            *reg.idx[i].relReg,
             DxbcScalarType::Sint32);
           break;
         
@@ -339,17 +354,29 @@ namespace dxvk {
     switch (format.kind) {
       case DxbcOperandKind::DstReg: {
         const uint32_t operandId = m_instruction.dstCount++;
-        this->decodeRegister(code, m_dstOperands.at(operandId), format.type);
+        
+        if (operandId >= MaxDstOperands)
+          throw DxvkError("DxbcDecodeContext: Too many destination operands");
+        
+        this->decodeRegister(code, m_storage.dst[operandId], format.type);
       } break;
         
       case DxbcOperandKind::SrcReg: {
         const uint32_t operandId = m_instruction.srcCount++;
-        this->decodeRegister(code, m_srcOperands.at(operandId), format.type);
+        
+        if (operandId >= MaxSrcOperands)
+          throw DxvkError("DxbcDecodeContext: Too many source operands");
+        
+        this->decodeRegister(code, m_storage.src[operandId], format.type);
       } break;
         
       case DxbcOperandKind::Imm32: {
         const uint32_t operandId = m_instruction.immCount++;
-        this->decodeImm32(code, m_immOperands.at(operandId), format.type);
+        
+        if (operandId >= MaxImmOperands)
+          throw DxvkError("DxbcDecodeContext: Too many immediate operands");
+        
+        this->decodeImm32(code, m_storage.imm[operandId], format.type);
       } break;
       
       default:
@@ -357,4 +384,42 @@ namespace dxvk {
     }
   }
   
-}
\ No newline at end of file
+  
+  DxbcRegister* DxbcDecodeContext::allocIndex() {
+    if (m_indexId >= MaxIndices)
+      throw DxvkError("DxbcDecodeContext: Too many relative indices");
+    
+    return &m_storage.indices[m_indexId++];
+  }
+  
+  
+  DxbcInstructionStream::DxbcInstructionStream(DxbcCodeSlice code) {
+    DxbcDecodeContext decoder;
+    
+    while (!code.atEnd()) {
+      // Decode operands directly into arena storage and only
+      // commit what the instruction actually used afterwards
+      DxbcOperandStorage storage;
+      storage.dst     = m_dstOperands.reserve(DxbcDecodeContext::MaxDstOperands);
+      storage.src     = m_srcOperands.reserve(DxbcDecodeContext::MaxSrcOperands);
+      storage.imm     = m_immOperands.reserve(DxbcDecodeContext::MaxImmOperands);
+      storage.indices = m_indices.reserve(DxbcDecodeContext::MaxIndices);
+      
+      decoder.decodeInstruction(code, storage);
+      
+      const DxbcShaderInstruction& ins = decoder.getInstruction();
+      m_dstOperands.commit(ins.dstCount);
+      m_srcOperands.commit(ins.srcCount);
+      m_immOperands.commit(ins.immCount);
+      m_indices.commit(decoder.getIndexCount());
+      
+      m_instructions.push_back(ins);
+    }
+  }
+  
+  
+  DxbcInstructionStream::~DxbcInstructionStream() {
+    
+  }
+  
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <vector>
 
 #include "dxbc_common.h"
 #include "dxbc_decoder.h"
@@ -382,8 +384,9 @@ namespace dxvk {
    * Note that this structure may store pointer to
    * external structures, such as the original code
    * buffer. This is safe to use if and only if:
-   * - The \ref DxbcDecodeContext that created it
-   *   still exists and was not moved
+   * - The \ref DxbcDecodeContext that created it, or
+   *   the operand storage it was decoded into, still
+   *   exists and was not moved
    * - The code buffer that was being decoded
    *   still exists and was not moved.
    */
@@ -443,6 +446,22 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Operand storage
+   * 
+   * Arrays that the operands of a decoded instruction are
+   * written to. Each array must have room for the maximum
+   * operand count of its kind, as defined by the constants
+   * in \ref DxbcDecodeContext.
+   */
+  struct DxbcOperandStorage {
+    DxbcRegister*  dst;
+    DxbcRegister*  src;
+    DxbcImmediate* imm;
+    DxbcRegister*  indices;
+  };
+  
+  
   /**
    * \brief Decode context
    * 
@@ -454,6 +473,11 @@ namespace dxvk {
     
   public:
     
+    constexpr static uint32_t MaxDstOperands = 8;
+    constexpr static uint32_t MaxSrcOperands = 8;
+    constexpr static uint32_t MaxImmOperands = 4;
+    constexpr static uint32_t MaxIndices     = 12;
+    
     /**
      * \brief Retrieves current instruction
      * 
@@ -464,6 +488,14 @@ namespace dxvk {
       return m_instruction;
     }
     
+    /**
+     * \brief Number of relative index registers
+     * \returns Index register count of last instruction
+     */
+    uint32_t getIndexCount() const {
+      return m_indexId;
+    }
+    
     /**
      * \brief Decodes an instruction
      * 
@@ -473,14 +505,29 @@ namespace dxvk {
      */
     void decodeInstruction(DxbcCodeSlice& code);
     
+    /**
+     * \brief Decodes an instruction into external storage
+     * 
+     * Operands of the decoded instruction will point into
+     * the given arrays rather than the decode context, so
+     * that the instruction remains valid after subsequent
+     * calls as long as the arrays are not reused.
+     * \param [in] code Code slice
+     * \param [in] storage Operand storage
+     */
+    void decodeInstruction(
+            DxbcCodeSlice&      code,
+      const DxbcOperandStorage& storage);
+    
   private:
     
     DxbcShaderInstruction m_instruction;
+    DxbcOperandStorage    m_storage;
     
-    std::array<DxbcRegister,  8> m_dstOperands;
-    std::array<DxbcRegister,  8> m_srcOperands;
-    std::array<DxbcImmediate, 4> m_immOperands;
-    std::array<DxbcRegister, 12> m_indices;
+    std::array<DxbcRegister,  MaxDstOperands> m_dstOperands;
+    std::array<DxbcRegister,  MaxSrcOperands> m_srcOperands;
+    std::array<DxbcImmediate, MaxImmOperands> m_immOperands;
+    std::array<DxbcRegister,  MaxIndices>     m_indices;
     
     // Index into the indices array. Used when decoding
     // instruction operands with relative indexing.
@@ -499,6 +546,98 @@ namespace dxvk {
     
     void decodeOperand(DxbcCodeSlice& code, const DxbcInstOperandFormat& format);
     
+    DxbcRegister* allocIndex();
+    
+  };
+  
+  
+  /**
+   * \brief Operand arena
+   * 
+   * Provides contiguous ranges of objects from fixed-size
+   * blocks. Objects are never moved or freed before the
+   * arena itself is destroyed, so pointers remain valid.
+   */
+  template<typename T, size_t BlockSize>
+  class DxbcArena {
+    
+  public:
+    
+    /**
+     * \brief Reserves storage
+     * 
+     * Returns a pointer to at least \c count free objects.
+     * The same range is returned until \ref commit is called.
+     * \param [in] count Number of objects to reserve
+     * \returns Pointer to reserved objects
+     */
+    T* reserve(uint32_t count) {
+      if (count > BlockSize)
+        throw DxvkError("DxbcArena: Allocation exceeds block size");
+      
+      // Don't value-initialize blocks, the decoder writes all
+      // relevant fields and zeroing them is measurably slower
+      if (m_blocks.empty() || m_used + count > BlockSize) {
+        m_blocks.push_back(std::unique_ptr<T[]>(new T[BlockSize]));
+        m_used = 0;
+      }
+      
+      return &m_blocks.back()[m_used];
+    }
+    
+    /**
+     * \brief Commits reserved storage
+     * 
+     * \param [in] count Number of objects actually used.
+     *    Must not exceed the previously reserved count.
+     */
+    void commit(uint32_t count) {
+      m_used += count;
+    }
+    
+  private:
+    
+    std::vector<std::unique_ptr<T[]>> m_blocks;
+    size_t                            m_used = 0;
+    
+  };
+  
+  
+  /**
+   * \brief Decoded instruction stream
+   * 
+   * Decodes all instructions of a shader once, so that
+   * the analyzer and the compiler can both iterate over
+   * the instruction stream without decoding it again.
+   * Instructions may point into the code buffer, which
+   * must therefore outlive the instruction stream.
+   */
+  class DxbcInstructionStream {
+    
+  public:
+    
+    DxbcInstructionStream(DxbcCodeSlice code);
+    ~DxbcInstructionStream();
+    
+    DxbcInstructionStream             (const DxbcInstructionStream&) = delete;
+    DxbcInstructionStream& operator = (const DxbcInstructionStream&) = delete;
+    
+    size_t size() const {
+      return m_instructions.size();
+    }
+    
+    auto begin() const { return m_instructions.cbegin(); }
+    auto end() const { return m_instructions.cend(); }
+    
+  private:
+    
+    std::vector<DxbcShaderInstruction> m_instructions;
+    
+    DxbcArena<DxbcRegister,  64>       m_dstOperands;
+    DxbcArena<DxbcRegister,  64>       m_srcOperands;
+    DxbcArena<DxbcImmediate, 64>       m_immOperands;
+    DxbcArena<DxbcRegister,  64>       m_indices;
+    
   };
   
 }
@@ -2,7 +2,7 @@
 
 namespace dxvk {
   
-  const std::array<DxbcInstFormat, 218> g_instructionFormats = {{
+  static constexpr std::array<DxbcInstFormat, 218> g_instructionFormats = {{
     /* Add                                  */
     { 3, DxbcInstClass::VectorAlu, {
       { DxbcOperandKind::DstReg, DxbcScalarType::Float32 },
@@ -1106,12 +1106,15 @@ namespace dxvk {
   }};
   
   
-  DxbcInstFormat dxbcInstructionFormat(DxbcOpcode opcode) {
+  static constexpr DxbcInstFormat g_undefinedFormat = { };
+
+
+  const DxbcInstFormat& dxbcInstructionFormat(DxbcOpcode opcode) {
     const uint32_t idx = static_cast<uint32_t>(opcode);
     
     return (idx < g_instructionFormats.size())
-      ? g_instructionFormats.at(idx)
-      : DxbcInstFormat();
+      ? g_instructionFormats[idx]
+      : g_undefinedFormat;
   }
   
 }
\ No newline at end of file
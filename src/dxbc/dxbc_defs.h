@@ -95,9 +95,11 @@ namespace dxvk {
   /**
    * \brief Retrieves instruction format info
    * 
+   * Formats are stored in a static table, so the
+   * returned reference remains valid indefinitely.
    * \param [in] opcode The opcode to retrieve
    * \returns Instruction format info
    */
-  DxbcInstFormat dxbcInstructionFormat(DxbcOpcode opcode);
+  const DxbcInstFormat& dxbcInstructionFormat(DxbcOpcode opcode);
   
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include "dxvk_api_timers.h"
+#include "dxvk_device.h"
+
+namespace dxvk {
+
+  void DxvkApiTimers::flush(DxvkDevice* device) {
+#ifdef DXVK_API_TIMERS
+    for (uint32_t i = 0; i < m_ticks.size(); i++) {
+      // Stat counters use microseconds, keep the
+      // remainder around for the next flush
+      uint64_t us = m_ticks[i] / 1000;
+
+      if (us) {
+        device->addStatCtr(DxvkStatCounter(
+          uint32_t(DxvkStatCounter::ApiDrawTicks) + i), us);
+        m_ticks[i] -= us * 1000;
+      }
+    }
+#endif
+  }
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+
+#include "../util/util_time.h"
+
+#include "dxvk_include.h"
+#include "dxvk_stats.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+  class DxvkApiTimerScope;
+
+  /**
+   * \brief API thread timer categories
+   *
+   * Phases of API call translation that are
+   * timed separately. Must match the order of
+   * the \c Api*Ticks stat counters.
+   */
+  enum class DxvkApiTimer : uint32_t {
+    Draw,                     ///< Draw and dispatch calls
+    PrepareDraw,              ///< State validation before draws
+    Constants,                ///< Shader constant updates
+    Shaders,                  ///< Shader binding
+    State,                    ///< Other state setters
+    Resources,                ///< Resource mapping and updates
+    Submit,                   ///< CS chunk and command list submission
+    Present,                  ///< Presentation
+    NumTimers,                ///< Number of timers
+  };
+
+
+  /**
+   * \brief API thread timers
+   *
+   * Accumulates the CPU time spent in each phase on
+   * the thread that owns the object. Nested scopes are
+   * not counted towards the enclosing scope, so that
+   * the sum of all timers is the total time spent
+   * inside instrumented API calls.
+   *
+   * Only compiled in if \c DXVK_API_TIMERS is defined.
+   */
+  class DxvkApiTimers {
+    friend class DxvkApiTimerScope;
+  public:
+
+    /**
+     * \brief Adds accumulated times to stat counters
+     *
+     * Must be called periodically from the owning
+     * thread, e.g. when flushing the context.
+     * \param [in] device Device to add counters to
+     */
+    void flush(DxvkDevice* device);
+
+  private:
+
+    std::array<uint64_t, uint32_t(DxvkApiTimer::NumTimers)> m_ticks = { };
+
+    DxvkApiTimerScope* m_current = nullptr;
+
+  };
+
+
+  /**
+   * \brief Scoped API thread timer
+   *
+   * Use the \c DXVK_API_TIMER macro instead of
+   * using this class directly, so that timers
+   * can be disabled at compile time.
+   */
+  class DxvkApiTimerScope {
+
+  public:
+
+    DxvkApiTimerScope(
+            DxvkApiTimers&        timers,
+            DxvkApiTimer          timer)
+    : m_timers(timers), m_timer(timer),
+      m_parent(timers.m_current), m_start(now()) {
+      m_timers.m_current = this;
+    }
+
+    ~DxvkApiTimerScope() {
+      uint64_t elapsed = now() - m_start;
+      m_timers.m_ticks[uint32_t(m_timer)] += elapsed - m_childTicks;
+
+      if (m_parent)
+        m_parent->m_childTicks += elapsed;
+
+      m_timers.m_current = m_parent;
+    }
+
+    DxvkApiTimerScope             (const DxvkApiTimerScope&) = delete;
+    DxvkApiTimerScope& operator = (const DxvkApiTimerScope&) = delete;
+
+  private:
+
+    DxvkApiTimers&      m_timers;
+    DxvkApiTimer        m_timer;
+    DxvkApiTimerScope*  m_parent;
+    uint64_t            m_start;
+    uint64_t            m_childTicks = 0;
+
+    static uint64_t now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        dxvk::high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+  };
+
+}
+
+#ifdef DXVK_API_TIMERS
+#define DXVK_API_TIMER(timers, timer) \
+  DxvkApiTimerScope apiTimer(timers, DxvkApiTimer::timer)
+#else
+#define DXVK_API_TIMER(timers, timer)
+#endif
@@ -6,10 +6,164 @@
 
 namespace dxvk {
   
+  DxvkBufferArena::DxvkBufferArena(
+          DxvkDevice*           device,
+          DxvkMemoryAllocator&  memAlloc,
+          VkBufferUsageFlags    usage,
+          VkMemoryPropertyFlags memFlags)
+  : m_vkd(device->vkd()) {
+    VkBufferCreateInfo info;
+    info.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    info.pNext                 = nullptr;
+    info.flags                 = 0;
+    info.size                  = ArenaSize;
+    info.usage                 = usage;
+    info.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+    info.queueFamilyIndexCount = 0;
+    info.pQueueFamilyIndices   = nullptr;
+
+    if (m_vkd->vkCreateBuffer(m_vkd->device(),
+          &info, nullptr, &m_buffer) != VK_SUCCESS) {
+      throw DxvkError(str::format(
+        "DxvkBufferArena: Failed to create buffer:"
+        "\n  size:  ", info.size,
+        "\n  usage: ", info.usage));
+    }
+
+    VkMemoryDedicatedRequirements dedicatedRequirements;
+    dedicatedRequirements.sType                       = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    dedicatedRequirements.pNext                       = VK_NULL_HANDLE;
+    dedicatedRequirements.prefersDedicatedAllocation  = VK_FALSE;
+    dedicatedRequirements.requiresDedicatedAllocation = VK_FALSE;
+
+    VkMemoryRequirements2 memReq;
+    memReq.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    memReq.pNext = &dedicatedRequirements;
+
+    VkBufferMemoryRequirementsInfo2 memReqInfo;
+    memReqInfo.sType  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+    memReqInfo.buffer = m_buffer;
+    memReqInfo.pNext  = VK_NULL_HANDLE;
+
+    VkMemoryDedicatedAllocateInfo dedMemoryAllocInfo;
+    dedMemoryAllocInfo.sType  = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedMemoryAllocInfo.pNext  = VK_NULL_HANDLE;
+    dedMemoryAllocInfo.buffer = m_buffer;
+    dedMemoryAllocInfo.image  = VK_NULL_HANDLE;
+
+    m_vkd->vkGetBufferMemoryRequirements2(
+       m_vkd->device(), &memReqInfo, &memReq);
+
+    m_memory = memAlloc.alloc(&memReq.memoryRequirements,
+      dedicatedRequirements, dedMemoryAllocInfo, memFlags,
+      DxvkMemoryFlags(DxvkMemoryFlag::GpuReadable));
+
+    if (m_vkd->vkBindBufferMemory(m_vkd->device(), m_buffer,
+        m_memory.memory(), m_memory.offset()) != VK_SUCCESS)
+      throw DxvkError("DxvkBufferArena: Failed to bind device memory");
+  }
+
+
+  DxvkBufferArena::~DxvkBufferArena() {
+    m_vkd->vkDestroyBuffer(m_vkd->device(), m_buffer, nullptr);
+  }
+
+
+  bool DxvkBufferArena::alloc(
+          VkDeviceSize          size,
+          VkDeviceSize&         offset) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    uint32_t blockClass = getBlockClass(size);
+    auto& freeBlocks = m_freeBlocks[blockClass];
+
+    if (!freeBlocks.empty()) {
+      offset = freeBlocks.back();
+      freeBlocks.pop_back();
+      return true;
+    }
+
+    VkDeviceSize blockSize = MinBlockSize << blockClass;
+
+    if (m_allocated + blockSize > ArenaSize)
+      return false;
+
+    offset = m_allocated;
+    m_allocated += blockSize;
+    return true;
+  }
+
+
+  void DxvkBufferArena::free(
+          VkDeviceSize          offset,
+          VkDeviceSize          size) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    m_freeBlocks[getBlockClass(size)].push_back(offset);
+  }
+
+
+  uint32_t DxvkBufferArena::getBlockClass(VkDeviceSize size) {
+    uint32_t blockClass = 0;
+
+    while ((MinBlockSize << blockClass) < size)
+      blockClass += 1;
+
+    return blockClass;
+  }
+
+
+  DxvkBufferArenaPool::DxvkBufferArenaPool(
+          DxvkDevice*           device,
+          DxvkMemoryAllocator&  memAlloc)
+  : m_device(device), m_memAlloc(&memAlloc) {
+
+  }
+
+
+  DxvkBufferArenaPool::~DxvkBufferArenaPool() {
+
+  }
+
+
+  Rc<DxvkBufferArena> DxvkBufferArenaPool::alloc(
+          VkBufferUsageFlags    usage,
+          VkMemoryPropertyFlags memFlags,
+          VkDeviceSize          size,
+          VkDeviceSize&         offset) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    ArenaList* list = nullptr;
+
+    for (auto& entry : m_lists) {
+      if (entry.usage == usage && entry.memFlags == memFlags)
+        list = &entry;
+    }
+
+    if (!list) {
+      list = &m_lists.emplace_back();
+      list->usage    = usage;
+      list->memFlags = memFlags;
+    }
+
+    for (const auto& arena : list->arenas) {
+      if (arena->alloc(size, offset))
+        return arena;
+    }
+
+    Rc<DxvkBufferArena> arena = new DxvkBufferArena(
+      m_device, *m_memAlloc, usage, memFlags);
+    arena->alloc(size, offset);
+
+    list->arenas.push_back(arena);
+    return arena;
+  }
+
+
   DxvkBuffer::DxvkBuffer(
           DxvkDevice*           device,
     const DxvkBufferCreateInfo& createInfo,
           DxvkMemoryAllocator&  memAlloc,
+          DxvkBufferArenaPool&  arenaPool,
           VkMemoryPropertyFlags memFlags)
   : m_device        (device),
     m_info          (createInfo),
@@ -23,10 +177,17 @@ namespace dxvk {
     m_physSliceCount  = std::max<VkDeviceSize>(1, 256 / m_physSliceStride);
 
     // Limit size of multi-slice buffers to reduce fragmentation
-    constexpr VkDeviceSize MaxBufferSize = 256 << 10;
+    VkDeviceSize maxBufferSize = 256 << 10;
 
-    m_physSliceMaxCount = MaxBufferSize >= m_physSliceStride
-      ? MaxBufferSize / m_physSliceStride
+    // Small uniform buffers share their backing storage, so that
+    // switching between them only changes the dynamic offsets.
+    if (sliceAlignment <= DxvkBufferArena::MinBlockSize && canUseArena()) {
+      m_arenaPool = &arenaPool;
+      maxBufferSize = DxvkBufferArena::MaxBlockSize;
+    }
+
+    m_physSliceMaxCount = maxBufferSize >= m_physSliceStride
+      ? maxBufferSize / m_physSliceStride
       : 1;
 
     // Allocate the initial set of buffer slices. Only clear
@@ -36,9 +197,9 @@ namespace dxvk {
 
     DxvkBufferSliceHandle slice;
     slice.handle = m_buffer.buffer;
-    slice.offset = 0;
+    slice.offset = m_buffer.offset;
     slice.length = m_physSliceLength;
-    slice.mapPtr = m_buffer.memory.mapPtr(0);
+    slice.mapPtr = m_buffer.mapPtr;
 
     m_physSlice = slice;
     m_lazyAlloc = m_physSliceCount > 1;
@@ -46,15 +207,26 @@ namespace dxvk {
 
 
   DxvkBuffer::~DxvkBuffer() {
-    auto vkd = m_device->vkd();
-
     for (const auto& buffer : m_buffers)
-      vkd->vkDestroyBuffer(vkd->device(), buffer.buffer, nullptr);
-    vkd->vkDestroyBuffer(vkd->device(), m_buffer.buffer, nullptr);
+      freeBuffer(buffer);
+    freeBuffer(m_buffer);
   }
   
   
   DxvkBufferHandle DxvkBuffer::allocBuffer(VkDeviceSize sliceCount, bool clear) const {
+    if (m_arenaPool) {
+      DxvkBufferHandle handle;
+      handle.length = m_physSliceStride * sliceCount;
+      handle.arena  = m_arenaPool->alloc(m_info.usage, m_memFlags, handle.length, handle.offset);
+      handle.buffer = handle.arena->handle();
+      handle.mapPtr = handle.arena->mapPtr(handle.offset);
+
+      if (clear && (m_memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+        std::memset(handle.mapPtr, 0, handle.length);
+
+      return handle;
+    }
+
     auto vkd = m_device->vkd();
 
     VkBufferCreateInfo info;
@@ -126,13 +298,36 @@ namespace dxvk {
         handle.memory.memory(), handle.memory.offset()) != VK_SUCCESS)
       throw DxvkError("DxvkBuffer: Failed to bind device memory");
     
+    handle.length = info.size;
+    handle.mapPtr = handle.memory.mapPtr(0);
+
     if (clear && (m_memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
-      std::memset(handle.memory.mapPtr(0), 0, info.size);
+      std::memset(handle.mapPtr, 0, info.size);
 
     return handle;
   }
 
 
+  void DxvkBuffer::freeBuffer(const DxvkBufferHandle& handle) const {
+    if (handle.arena != nullptr) {
+      handle.arena->free(handle.offset, handle.length);
+    } else {
+      auto vkd = m_device->vkd();
+      vkd->vkDestroyBuffer(vkd->device(), handle.buffer, nullptr);
+    }
+  }
+
+
+  bool DxvkBuffer::canUseArena() const {
+    VkBufferUsageFlags usage = m_info.usage & ~(
+      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+      VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    return usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+        && m_physSliceStride <= DxvkBufferArena::MaxBlockSize;
+  }
+
+
   VkDeviceSize DxvkBuffer::computeSliceAlignment() const {
     const auto& devInfo = m_device->properties().core.properties;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <unordered_map>
 #include <vector>
 
@@ -51,15 +52,156 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Buffer arena
+   *
+   * Large Vulkan buffer that small buffers take their
+   * backing storage from, so that binding a different
+   * buffer does not necessarily require updating any
+   * descriptors. Memory is handed out in power-of-two
+   * blocks, which get recycled when the buffer owning
+   * them is destroyed.
+   */
+  class DxvkBufferArena : public RcObject {
+
+  public:
+
+    constexpr static VkDeviceSize MinBlockSize  = 256;
+    constexpr static VkDeviceSize MaxBlockSize  = 16 << 10;
+    constexpr static VkDeviceSize ArenaSize     = 1 << 20;
+    constexpr static uint32_t     BlockClassCount = 7;
+
+    DxvkBufferArena(
+            DxvkDevice*           device,
+            DxvkMemoryAllocator&  memAlloc,
+            VkBufferUsageFlags    usage,
+            VkMemoryPropertyFlags memFlags);
+
+    ~DxvkBufferArena();
+
+    /**
+     * \brief Vulkan buffer handle
+     * \returns Buffer handle
+     */
+    VkBuffer handle() const {
+      return m_buffer;
+    }
+
+    /**
+     * \brief Map pointer
+     *
+     * \param [in] offset Byte offset into the arena
+     * \returns Pointer to mapped memory region
+     */
+    void* mapPtr(VkDeviceSize offset) const {
+      return m_memory.mapPtr(offset);
+    }
+
+    /**
+     * \brief Allocates a block
+     *
+     * \param [in] size Number of bytes to allocate, must
+     *    not be larger than \c MaxBlockSize
+     * \param [out] offset Offset of the block
+     * \returns \c true on success, \c false if
+     *    the arena is full
+     */
+    bool alloc(
+            VkDeviceSize          size,
+            VkDeviceSize&         offset);
+
+    /**
+     * \brief Frees a block
+     *
+     * The block must not be in use by the GPU.
+     * \param [in] offset Block offset
+     * \param [in] size Size the block was allocated with
+     */
+    void free(
+            VkDeviceSize          offset,
+            VkDeviceSize          size);
+
+  private:
+
+    Rc<vk::DeviceFn>        m_vkd;
+    VkBuffer                m_buffer = VK_NULL_HANDLE;
+    DxvkMemory              m_memory;
+
+    dxvk::mutex             m_mutex;
+    VkDeviceSize            m_allocated = 0;
+
+    std::array<std::vector<VkDeviceSize>, BlockClassCount> m_freeBlocks;
+
+    static uint32_t getBlockClass(VkDeviceSize size);
+
+  };
+
+
+  /**
+   * \brief Buffer arena pool
+   *
+   * Manages arenas for each combination of
+   * buffer usage and memory property flags.
+   */
+  class DxvkBufferArenaPool {
+
+  public:
+
+    DxvkBufferArenaPool(
+            DxvkDevice*           device,
+            DxvkMemoryAllocator&  memAlloc);
+
+    ~DxvkBufferArenaPool();
+
+    /**
+     * \brief Allocates a block from an arena
+     *
+     * Creates a new arena if all existing
+     * arenas with matching properties are full.
+     * \param [in] usage Buffer usage flags
+     * \param [in] memFlags Memory property flags
+     * \param [in] size Number of bytes to allocate
+     * \param [out] offset Offset of the block
+     * \returns Arena that the block was allocated from
+     */
+    Rc<DxvkBufferArena> alloc(
+            VkBufferUsageFlags    usage,
+            VkMemoryPropertyFlags memFlags,
+            VkDeviceSize          size,
+            VkDeviceSize&         offset);
+
+  private:
+
+    struct ArenaList {
+      VkBufferUsageFlags                usage;
+      VkMemoryPropertyFlags             memFlags;
+      std::vector<Rc<DxvkBufferArena>>  arenas;
+    };
+
+    DxvkDevice*             m_device;
+    DxvkMemoryAllocator*    m_memAlloc;
+
+    dxvk::mutex             m_mutex;
+    std::vector<ArenaList>  m_lists;
+
+  };
+
+
   /**
    * \brief Buffer info
    * 
    * Stores a Vulkan buffer handle and the
    * memory object that is bound to the buffer.
+   * If the storage was taken from an arena,
+   * the memory object is empty.
    */
   struct DxvkBufferHandle {
-    VkBuffer      buffer = VK_NULL_HANDLE;
-    DxvkMemory    memory;
+    VkBuffer            buffer = VK_NULL_HANDLE;
+    DxvkMemory          memory;
+    Rc<DxvkBufferArena> arena;
+    VkDeviceSize        offset = 0;
+    VkDeviceSize        length = 0;
+    void*               mapPtr = nullptr;
   };
   
 
@@ -107,6 +249,7 @@ namespace dxvk {
             DxvkDevice*           device,
       const DxvkBufferCreateInfo& createInfo,
             DxvkMemoryAllocator&  memAlloc,
+            DxvkBufferArenaPool&  arenaPool,
             VkMemoryPropertyFlags memFlags);
     
     ~DxvkBuffer();
@@ -285,6 +428,7 @@ namespace dxvk {
     DxvkDevice*             m_device;
     DxvkBufferCreateInfo    m_info;
     DxvkMemoryAllocator*    m_memAlloc;
+    DxvkBufferArenaPool*    m_arenaPool = nullptr;
     VkMemoryPropertyFlags   m_memFlags;
     
     DxvkBufferHandle        m_buffer;
@@ -311,8 +455,8 @@ namespace dxvk {
       DxvkBufferSliceHandle slice;
       slice.handle = handle.buffer;
       slice.length = m_physSliceLength;
-      slice.offset = m_physSliceStride * index;
-      slice.mapPtr = handle.memory.mapPtr(slice.offset);
+      slice.offset = handle.offset + m_physSliceStride * index;
+      slice.mapPtr = reinterpret_cast<char*>(handle.mapPtr) + m_physSliceStride * index;
       m_freeSlices.push_back(slice);
     }
 
@@ -320,6 +464,11 @@ namespace dxvk {
             VkDeviceSize          sliceCount,
             bool                  clear) const;
 
+    void freeBuffer(
+      const DxvkBufferHandle&     handle) const;
+
+    bool canUseArena() const;
+
     VkDeviceSize computeSliceAlignment() const;
     
   };
@@ -37,12 +37,15 @@ namespace dxvk {
     DxvkComputePipelineInstance* instance = this->findInstance(state);
 
     if (unlikely(!instance)) {
+      auto t0 = dxvk::high_resolution_clock::now();
+
       std::lock_guard<dxvk::mutex> lock(m_mutex);
       instance = this->findInstance(state);
 
       if (!instance) {
         instance = this->createInstance(state);
         this->writePipelineStateToCache(state);
+        this->recordStall(state, t0);
       }
     }
 
@@ -61,6 +64,10 @@ namespace dxvk {
   
   DxvkComputePipelineInstance* DxvkComputePipeline::createInstance(
     const DxvkComputePipelineStateInfo& state) {
+    DxvkTraceRecorder* tracer = m_pipeMgr->m_device->tracer();
+    DxvkTraceScope trace(tracer, "CompileComputePipeline", "pipeline",
+      tracer ? m_shaders.cs->debugName() : std::string());
+
     VkPipeline newPipelineHandle = this->createPipeline(state);
 
     m_pipeMgr->m_numComputePipelines += 1;
@@ -140,6 +147,27 @@ namespace dxvk {
   }
   
   
+  void DxvkComputePipeline::recordStall(
+    const DxvkComputePipelineStateInfo& state,
+          dxvk::high_resolution_clock::time_point startTime) const {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      dxvk::high_resolution_clock::now() - startTime).count();
+
+    m_pipeMgr->m_device->addStatCtr(DxvkStatCounter::PipeStallCount, 1);
+    m_pipeMgr->m_device->addStatCtr(DxvkStatCounter::PipeStallTicks, duration);
+
+    if (!m_pipeMgr->m_stallTracker.isWorstStall(duration))
+      return;
+
+    DxvkPipelineStall stall;
+    stall.duration = duration;
+    stall.shaders  = { m_shaders.cs->getShaderKey() };
+    stall.state    = Sha1Hash::compute(state);
+
+    m_pipeMgr->m_stallTracker.addStall(std::move(stall));
+  }
+
+
   void DxvkComputePipeline::writePipelineStateToCache(
     const DxvkComputePipelineStateInfo& state) const {
     if (m_pipeMgr->m_stateCache == nullptr)
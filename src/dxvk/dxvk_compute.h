@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "../util/sync/sync_list.h"
+#include "../util/util_time.h"
 
 #include "dxvk_bind_mask.h"
 #include "dxvk_graphics_state.h"
@@ -160,6 +161,10 @@ namespace dxvk {
     void destroyPipeline(
             VkPipeline                    pipeline);
 
+    void recordStall(
+      const DxvkComputePipelineStateInfo& state,
+            dxvk::high_resolution_clock::time_point startTime) const;
+
     void writePipelineStateToCache(
       const DxvkComputePipelineStateInfo& state) const;
     
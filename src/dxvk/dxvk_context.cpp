@@ -73,6 +73,8 @@ namespace dxvk {
     this->spillRenderPass(true);
     this->flushSharedImages();
 
+    m_queryManager.resolveQueries(m_cmd);
+
     m_sdmaBarriers.recordCommands(m_cmd);
     m_initBarriers.recordCommands(m_cmd);
     m_execBarriers.recordCommands(m_cmd);
@@ -152,10 +154,22 @@ namespace dxvk {
     const DxvkBufferSlice&      buffer) {
     bool needsUpdate = !m_rc[slot].bufferSlice.matchesBuffer(buffer);
 
-    if (likely(needsUpdate))
+    if (likely(needsUpdate)) {
       m_rcTracked.clr(slot);
-    else
+
+      // Small uniform buffers may share the same Vulkan buffer, in
+      // which case dynamic descriptors only differ in their offset.
+      // Track the new buffer here since descriptors are not updated.
+      if (m_rc[slot].bufferSlice.defined() && buffer.defined()
+       && m_rc[slot].bufferSlice.length() == buffer.length()
+       && m_rc[slot].bufferSlice.getSliceHandle().handle == buffer.getSliceHandle().handle) {
+        m_cmd->trackResource<DxvkAccess::Read>(buffer.buffer());
+        m_rcTracked.set(slot);
+        needsUpdate = false;
+      }
+    } else {
       needsUpdate = m_rc[slot].bufferSlice.length() != buffer.length();
+    }
 
     if (likely(needsUpdate)) {
       m_flags.set(
@@ -2125,6 +2139,17 @@ namespace dxvk {
     bool replaceBuffer = this->tryInvalidateDeviceLocalBuffer(buffer, size);
     auto bufferSlice = buffer->getSliceHandle(offset, size);
 
+    // If the buffer is not used by any command list, including the
+    // one currently being recorded, nothing that was recorded prior
+    // to this can access it, so we can hoist the update out of the
+    // current render pass and execute it in the init command buffer.
+    if (!replaceBuffer && !buffer->isInUse()) {
+      replaceBuffer = true;
+
+      if (m_flags.test(DxvkContextFlag::GpRenderPassBound))
+        m_cmd->addStatCtr(DxvkStatCounter::CmdRenderPassSplitsSaved, 1);
+    }
+
     if (!replaceBuffer) {
       this->spillRenderPass(true);
     
@@ -2198,19 +2223,28 @@ namespace dxvk {
   void DxvkContext::uploadBuffer(
     const Rc<DxvkBuffer>&           buffer,
     const void*                     data) {
-    auto bufferSlice = buffer->getSliceHandle();
+    VkDeviceSize length = buffer->getSliceHandle().length;
 
-    auto stagingSlice = m_staging.alloc(CACHE_LINE_SIZE, bufferSlice.length);
-    auto stagingHandle = stagingSlice.getSliceHandle();
-    std::memcpy(stagingHandle.mapPtr, data, bufferSlice.length);
+    auto stagingSlice = m_staging.alloc(CACHE_LINE_SIZE, length);
+    std::memcpy(stagingSlice.mapPtr(0), data, length);
+
+    this->uploadBuffer(buffer, stagingSlice);
+  }
+
+
+  void DxvkContext::uploadBuffer(
+    const Rc<DxvkBuffer>&           buffer,
+    const DxvkBufferSlice&          source) {
+    auto bufferSlice = buffer->getSliceHandle();
+    auto sourceSlice = source.getSliceHandle(0, bufferSlice.length);
 
     VkBufferCopy region;
-    region.srcOffset = stagingHandle.offset;
+    region.srcOffset = sourceSlice.offset;
     region.dstOffset = bufferSlice.offset;
     region.size      = bufferSlice.length;
 
     m_cmd->cmdCopyBuffer(DxvkCmdBuffer::SdmaBuffer,
-      stagingHandle.handle, bufferSlice.handle, 1, &region);
+      sourceSlice.handle, bufferSlice.handle, 1, &region);
 
     m_sdmaBarriers.releaseBuffer(
       m_initBarriers, bufferSlice,
@@ -2221,7 +2255,7 @@ namespace dxvk {
       buffer->info().stages,
       buffer->info().access);
     
-    m_cmd->trackResource<DxvkAccess::Read>(stagingSlice.buffer());
+    m_cmd->trackResource<DxvkAccess::Read>(source.buffer());
     m_cmd->trackResource<DxvkAccess::Write>(buffer);
   }
 
@@ -2235,52 +2269,33 @@ namespace dxvk {
     VkOffset3D imageOffset = { 0, 0, 0 };
     VkExtent3D imageExtent = image->mipLevelExtent(subresources.mipLevel);
 
-    DxvkCmdBuffer cmdBuffer = DxvkCmdBuffer::SdmaBuffer;
-    DxvkBarrierSet* barriers = &m_sdmaAcquires;
-    
-    if (subresources.aspectMask & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
-      cmdBuffer = DxvkCmdBuffer::InitBuffer;
-      barriers = &m_initBarriers;
-    }
-
-    // Discard previous subresource contents
-    barriers->accessImage(image,
-      vk::makeSubresourceRange(subresources),
-      VK_IMAGE_LAYOUT_UNDEFINED, 0, 0,
-      image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
-      VK_PIPELINE_STAGE_TRANSFER_BIT,
-      VK_ACCESS_TRANSFER_WRITE_BIT);
-
-    barriers->recordCommands(m_cmd);
+    DxvkCmdBuffer cmdBuffer = this->beginImageUpload(image, subresources);
 
     this->copyImageHostData(cmdBuffer,
       image, subresources, imageOffset, imageExtent,
       data, pitchPerRow, pitchPerLayer);
 
-    // Transfer ownership to graphics queue
-    if (cmdBuffer == DxvkCmdBuffer::SdmaBuffer) {
-      m_sdmaBarriers.releaseImage(m_initBarriers,
-        image, vk::makeSubresourceRange(subresources),
-        m_device->queues().transfer.queueFamily,
-        image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_ACCESS_TRANSFER_WRITE_BIT,
-        m_device->queues().graphics.queueFamily,
-        image->info().layout,
-        image->info().stages,
-        image->info().access);
-    } else {
-      barriers->accessImage(image,
-        vk::makeSubresourceRange(subresources),
-        image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_ACCESS_TRANSFER_WRITE_BIT,
-        image->info().layout,
-        image->info().stages,
-        image->info().access);
-    }
-    
-    m_cmd->trackResource<DxvkAccess::Write>(image);
+    this->endImageUpload(cmdBuffer, image, subresources);
+  }
+
+
+  void DxvkContext::uploadImage(
+    const Rc<DxvkImage>&            image,
+    const VkImageSubresourceLayers& subresources,
+    const DxvkBufferSlice&          source) {
+    VkOffset3D imageOffset = { 0, 0, 0 };
+    VkExtent3D imageExtent = image->mipLevelExtent(subresources.mipLevel);
+
+    DxvkCmdBuffer cmdBuffer = this->beginImageUpload(image, subresources);
+
+    this->copyImageBufferData<true>(cmdBuffer,
+      image, subresources, imageOffset, imageExtent,
+      image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
+      source.getSliceHandle(), 0, 0);
+
+    m_cmd->trackResource<DxvkAccess::Read>(source.buffer());
+
+    this->endImageUpload(cmdBuffer, image, subresources);
   }
 
 
@@ -2926,6 +2941,61 @@ namespace dxvk {
   }
 
 
+  DxvkCmdBuffer DxvkContext::beginImageUpload(
+    const Rc<DxvkImage>&        image,
+    const VkImageSubresourceLayers& subresources) {
+    DxvkCmdBuffer cmdBuffer = DxvkCmdBuffer::SdmaBuffer;
+    DxvkBarrierSet* barriers = &m_sdmaAcquires;
+    
+    if (subresources.aspectMask & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
+      cmdBuffer = DxvkCmdBuffer::InitBuffer;
+      barriers = &m_initBarriers;
+    }
+
+    // Discard previous subresource contents
+    barriers->accessImage(image,
+      vk::makeSubresourceRange(subresources),
+      VK_IMAGE_LAYOUT_UNDEFINED, 0, 0,
+      image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT);
+
+    barriers->recordCommands(m_cmd);
+    return cmdBuffer;
+  }
+
+
+  void DxvkContext::endImageUpload(
+          DxvkCmdBuffer         cmd,
+    const Rc<DxvkImage>&        image,
+    const VkImageSubresourceLayers& subresources) {
+    // Transfer ownership to graphics queue
+    if (cmd == DxvkCmdBuffer::SdmaBuffer) {
+      m_sdmaBarriers.releaseImage(m_initBarriers,
+        image, vk::makeSubresourceRange(subresources),
+        m_device->queues().transfer.queueFamily,
+        image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        m_device->queues().graphics.queueFamily,
+        image->info().layout,
+        image->info().stages,
+        image->info().access);
+    } else {
+      m_initBarriers.accessImage(image,
+        vk::makeSubresourceRange(subresources),
+        image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        image->info().layout,
+        image->info().stages,
+        image->info().access);
+    }
+    
+    m_cmd->trackResource<DxvkAccess::Write>(image);
+  }
+
+
   void DxvkContext::copyImageHostData(
           DxvkCmdBuffer         cmd,
     const Rc<DxvkImage>&        image,
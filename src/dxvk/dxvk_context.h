@@ -812,6 +812,20 @@ namespace dxvk {
       const Rc<DxvkBuffer>&           buffer,
       const void*                     data);
     
+    /**
+     * \brief Uses transfer queue to initialize buffer
+     * 
+     * Only safe to use if the buffer is not in use by the GPU.
+     * Takes data from a host-visible staging buffer that was
+     * filled by the caller, so that no memory copy needs to
+     * happen while recording the command.
+     * \param [in] buffer The buffer to initialize
+     * \param [in] source Staging buffer slice
+     */
+    void uploadBuffer(
+      const Rc<DxvkBuffer>&           buffer,
+      const DxvkBufferSlice&          source);
+    
     /**
      * \brief Uses transfer queue to initialize image
      * 
@@ -829,6 +843,21 @@ namespace dxvk {
             VkDeviceSize              pitchPerRow,
             VkDeviceSize              pitchPerLayer);
     
+    /**
+     * \brief Uses transfer queue to initialize image
+     * 
+     * Only safe to use if the image is not in use by the GPU.
+     * The staging buffer must contain tightly packed data for
+     * each layer and aspect, as written by \c packImageData.
+     * \param [in] image The image to initialize
+     * \param [in] subresources Subresources to initialize
+     * \param [in] source Staging buffer slice
+     */
+    void uploadImage(
+      const Rc<DxvkImage>&            image,
+      const VkImageSubresourceLayers& subresources,
+      const DxvkBufferSlice&          source);
+    
     /**
      * \brief Sets viewports
      * 
@@ -1144,6 +1173,15 @@ namespace dxvk {
             VkDeviceSize          bufferRowAlignment,
             VkDeviceSize          bufferSliceAlignment);
 
+    DxvkCmdBuffer beginImageUpload(
+      const Rc<DxvkImage>&        image,
+      const VkImageSubresourceLayers& subresources);
+
+    void endImageUpload(
+            DxvkCmdBuffer         cmd,
+      const Rc<DxvkImage>&        image,
+      const VkImageSubresourceLayers& subresources);
+
     void copyImageHostData(
             DxvkCmdBuffer         cmd,
       const Rc<DxvkImage>&        image,
@@ -136,6 +136,8 @@ namespace dxvk {
       if (seq == SynchronizeAll)
         seq = m_chunksDispatched.load();
 
+      DxvkTraceScope trace(m_device->tracer(), "CsSync", "sync");
+
       auto t0 = dxvk::high_resolution_clock::now();
       m_condOnSync.wait(lock, [this, seq] {
         return m_chunksExecuted.load() >= seq;
@@ -178,6 +180,8 @@ namespace dxvk {
         }
         
         if (chunk) {
+          DxvkTraceScope trace(m_device->tracer(), "CsChunk", "cs");
+
           m_context->addStatCtr(DxvkStatCounter::CsChunkCount, 1);
           chunk->executeAll(m_context.ptr());
         }
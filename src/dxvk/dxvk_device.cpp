@@ -10,6 +10,7 @@ namespace dxvk {
     const DxvkDeviceExtensions&     extensions,
     const DxvkDeviceFeatures&       features)
   : m_options           (instance->options()),
+    m_tracer            (DxvkTraceRecorder::createRecorder(m_options)),
     m_instance          (instance),
     m_adapter           (adapter),
     m_vkd               (vkd),
@@ -22,6 +23,8 @@ namespace dxvk {
     auto queueFamilies = m_adapter->findQueueFamilies();
     m_queues.graphics = getQueue(queueFamilies.graphics, 0);
     m_queues.transfer = getQueue(queueFamilies.transfer, 0);
+
+    m_metrics = DxvkMetricsExporter::createExporter(this);
   }
   
   
@@ -134,7 +137,8 @@ namespace dxvk {
   Rc<DxvkBuffer> DxvkDevice::createBuffer(
     const DxvkBufferCreateInfo& createInfo,
           VkMemoryPropertyFlags memoryType) {
-    return new DxvkBuffer(this, createInfo, m_objects.memoryManager(), memoryType);
+    return new DxvkBuffer(this, createInfo,
+      m_objects.memoryManager(), m_objects.bufferArenas(), memoryType);
   }
   
   
@@ -191,6 +195,11 @@ namespace dxvk {
   }
 
 
+  std::vector<DxvkPipelineStall> DxvkDevice::getPipelineStalls() {
+    return m_objects.pipelineManager().getPipelineStalls();
+  }
+
+
   uint32_t DxvkDevice::getCurrentFrameId() const {
     return m_statCounters.getCtr(DxvkStatCounter::QueuePresentCount);
   }
@@ -204,6 +213,11 @@ namespace dxvk {
   void DxvkDevice::registerShader(const Rc<DxvkShader>& shader) {
     m_objects.pipelineManager().registerShader(shader);
   }
+
+
+  bool DxvkDevice::hasStateCache() {
+    return m_objects.pipelineManager().hasStateCache();
+  }
   
   
   void DxvkDevice::presentImage(
@@ -215,8 +229,12 @@ namespace dxvk {
     presentInfo.presenter = presenter;
     m_submissionQueue.present(presentInfo, status);
     
-    std::lock_guard<sync::Spinlock> statLock(m_statLock);
-    m_statCounters.addCtr(DxvkStatCounter::QueuePresentCount, 1);
+    { std::lock_guard<sync::Spinlock> statLock(m_statLock);
+      m_statCounters.addCtr(DxvkStatCounter::QueuePresentCount, 1);
+    }
+
+    if (unlikely(m_metrics != nullptr))
+      m_metrics->captureFrame();
   }
 
 
@@ -250,6 +268,8 @@ namespace dxvk {
 
   void DxvkDevice::waitForResource(const Rc<DxvkResource>& resource, DxvkAccess access) {
     if (resource->isInUse(access)) {
+      DxvkTraceScope trace(m_tracer.ptr(), "WaitForResource", "sync");
+
       auto t0 = dxvk::high_resolution_clock::now();
 
       m_submissionQueue.synchronizeUntil([resource, access] {
@@ -12,6 +12,7 @@
 #include "dxvk_instance.h"
 #include "dxvk_memory.h"
 #include "dxvk_meta_clear.h"
+#include "dxvk_metrics.h"
 #include "dxvk_objects.h"
 #include "dxvk_options.h"
 #include "dxvk_pipecache.h"
@@ -22,6 +23,7 @@
 #include "dxvk_sampler.h"
 #include "dxvk_shader.h"
 #include "dxvk_stats.h"
+#include "dxvk_trace.h"
 #include "dxvk_unbound.h"
 
 #include "../vulkan/vulkan_presenter.h"
@@ -113,6 +115,16 @@ namespace dxvk {
       return m_options;
     }
     
+    /**
+     * \brief Trace recorder
+     *
+     * Used to record scoped events from DXVK's threads.
+     * \returns Trace recorder, or \c nullptr if disabled
+     */
+    DxvkTraceRecorder* tracer() const {
+      return m_tracer.ptr();
+    }
+
     /**
      * \brief Queue handles
      * 
@@ -367,6 +379,15 @@ namespace dxvk {
      */
     DxvkMemoryStats getMemoryStats(uint32_t heap);
 
+    /**
+     * \brief Retrieves worst pipeline compile stalls
+     *
+     * Pipelines that had to be compiled synchronously
+     * during command recording, sorted by duration.
+     * \returns Longest stalls seen so far
+     */
+    std::vector<DxvkPipelineStall> getPipelineStalls();
+
     /**
      * \brief Retreves current frame ID
      * \returns Current frame ID
@@ -389,6 +410,15 @@ namespace dxvk {
     void registerShader(
       const Rc<DxvkShader>&         shader);
     
+    /**
+     * \brief Checks whether the state cache is enabled
+     *
+     * Frontends that cache their own shader data on
+     * disk should only do so if this returns \c true.
+     * \returns \c true if pipelines are cached on disk
+     */
+    bool hasStateCache();
+
     /**
      * \brief Presents a swap chain image
      * 
@@ -489,6 +519,7 @@ namespace dxvk {
   private:
     
     DxvkOptions                 m_options;
+    Rc<DxvkTraceRecorder>       m_tracer;
 
     Rc<DxvkInstance>            m_instance;
     Rc<DxvkAdapter>             m_adapter;
@@ -511,6 +542,8 @@ namespace dxvk {
     
     DxvkSubmissionQueue m_submissionQueue;
 
+    Rc<DxvkMetricsExporter> m_metrics;
+
     DxvkDevicePerfHints getPerfHints();
     
     void recycleCommandList(
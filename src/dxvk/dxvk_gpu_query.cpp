@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstring>
 
 #include "dxvk_cmdlist.h"
 #include "dxvk_device.h"
@@ -41,22 +42,19 @@ namespace dxvk {
     if (!m_handle.queryPool)
       return DxvkGpuQueryStatus::Available;
     
+    // Results get copied to mapped memory by the command
+    // lists that end the query, so they are valid as soon
+    // as the GPU has finished executing all of them.
+    if (isInUse())
+      return DxvkGpuQueryStatus::Pending;
+
     // Get query data from all associated handles
-    DxvkGpuQueryStatus status = getDataForHandle(queryData, m_handle);
+    getDataForHandle(queryData, m_handle);
 
-    for (size_t i = 0; i < m_handles.size()
-        && status == DxvkGpuQueryStatus::Available; i++)
-      status = getDataForHandle(queryData, m_handles[i]);
-    
-    // Treat non-precise occlusion queries as available
-    // if we already know the result will be non-zero
-    if ((status == DxvkGpuQueryStatus::Pending)
-     && (m_type == VK_QUERY_TYPE_OCCLUSION)
-     && !(m_flags & VK_QUERY_CONTROL_PRECISE_BIT)
-     && (queryData.occlusion.samplesPassed))
-      status = DxvkGpuQueryStatus::Available;
+    for (size_t i = 0; i < m_handles.size(); i++)
+      getDataForHandle(queryData, m_handles[i]);
     
-    return status;
+    return DxvkGpuQueryStatus::Available;
   }
 
 
@@ -85,21 +83,11 @@ namespace dxvk {
   }
 
 
-  DxvkGpuQueryStatus DxvkGpuQuery::getDataForHandle(
+  void DxvkGpuQuery::getDataForHandle(
           DxvkQueryData&      queryData,
     const DxvkGpuQueryHandle& handle) const {
     DxvkQueryData tmpData;
-
-    // Try to copy query data to temporary structure
-    VkResult result = m_vkd->vkGetQueryPoolResults(m_vkd->device(),
-      handle.queryPool, handle.queryId, 1,
-      sizeof(DxvkQueryData), &tmpData,
-      sizeof(DxvkQueryData), VK_QUERY_RESULT_64_BIT);
-    
-    if (result == VK_NOT_READY)
-      return DxvkGpuQueryStatus::Pending;
-    else if (result != VK_SUCCESS)
-      return DxvkGpuQueryStatus::Failed;
+    std::memcpy(&tmpData, handle.dataPtr, handle.allocator->dataStride());
     
     // Add numbers to the destination structure
     switch (m_type) {
@@ -132,10 +120,7 @@ namespace dxvk {
       
       default:
         Logger::err(str::format("DXVK: Unhandled query type: ", m_type));
-        return DxvkGpuQueryStatus::Invalid;
     }
-    
-    return DxvkGpuQueryStatus::Available;
   }
   
   
@@ -148,8 +133,24 @@ namespace dxvk {
   : m_device        (device),
     m_vkd           (device->vkd()),
     m_queryType     (queryType),
-    m_queryPoolSize (queryPoolSize) {
-
+    m_queryPoolSize (queryPoolSize),
+    m_dataStride    (0) {
+    switch (queryType) {
+      case VK_QUERY_TYPE_OCCLUSION:
+        m_dataStride = sizeof(DxvkQueryOcclusionData);
+        break;
+      case VK_QUERY_TYPE_PIPELINE_STATISTICS:
+        m_dataStride = sizeof(DxvkQueryStatisticData);
+        break;
+      case VK_QUERY_TYPE_TIMESTAMP:
+        m_dataStride = sizeof(DxvkQueryTimestampData);
+        break;
+      case VK_QUERY_TYPE_TRANSFORM_FEEDBACK_STREAM_EXT:
+        m_dataStride = sizeof(DxvkQueryXfbStreamData);
+        break;
+      default:
+        Logger::err(str::format("DXVK: Unhandled query type: ", queryType));
+    }
   }
 
   
@@ -213,10 +214,27 @@ namespace dxvk {
       return;
     }
 
+    // Create buffer that query results get copied to
+    DxvkBufferCreateInfo bufferInfo;
+    bufferInfo.size   = m_dataStride * m_queryPoolSize;
+    bufferInfo.usage  = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.stages = VK_PIPELINE_STAGE_TRANSFER_BIT
+                      | VK_PIPELINE_STAGE_HOST_BIT;
+    bufferInfo.access = VK_ACCESS_TRANSFER_WRITE_BIT
+                      | VK_ACCESS_HOST_READ_BIT;
+
+    Rc<DxvkBuffer> buffer = m_device->createBuffer(bufferInfo,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+      VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
     m_pools.push_back(queryPool);
+    m_buffers.push_back(buffer);
+
+    VkBuffer bufferHandle = buffer->getSliceHandle().handle;
 
     for (uint32_t i = 0; i < m_queryPoolSize; i++)
-      m_handles.push_back({ this, queryPool, i });
+      m_handles.push_back({ this, queryPool, i, bufferHandle, buffer->mapPtr(m_dataStride * i) });
   }
 
 
@@ -314,7 +332,10 @@ namespace dxvk {
       handle.queryPool,
       handle.queryId);
     
-    cmd->trackResource<DxvkAccess::None>(query);
+    if (handle.queryPool)
+      m_endedQueries.push_back(handle);
+
+    cmd->trackResource<DxvkAccess::Read>(query);
   }
 
 
@@ -342,6 +363,52 @@ namespace dxvk {
   }
 
 
+  void DxvkGpuQueryManager::resolveQueries(
+    const Rc<DxvkCommandList>&  cmd) {
+    if (m_endedQueries.empty())
+      return;
+
+    std::sort(m_endedQueries.begin(), m_endedQueries.end(),
+      [] (const DxvkGpuQueryHandle& a, const DxvkGpuQueryHandle& b) {
+        if (a.queryPool != b.queryPool)
+          return a.queryPool < b.queryPool;
+        return a.queryId < b.queryId;
+      });
+
+    for (size_t i = 0; i < m_endedQueries.size(); ) {
+      const DxvkGpuQueryHandle& first = m_endedQueries[i];
+      uint32_t count = 1;
+
+      while (i + count < m_endedQueries.size()
+          && m_endedQueries[i + count].queryPool == first.queryPool
+          && m_endedQueries[i + count].queryId   == first.queryId + count)
+        count += 1;
+
+      VkDeviceSize stride = first.allocator->dataStride();
+
+      cmd->cmdCopyQueryPoolResults(
+        first.queryPool, first.queryId, count,
+        first.dataBuffer, first.queryId * stride, stride,
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+
+      i += count;
+    }
+
+    VkMemoryBarrier barrier;
+    barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.pNext         = nullptr;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+    cmd->cmdPipelineBarrier(DxvkCmdBuffer::ExecBuffer,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    m_endedQueries.clear();
+  }
+
+
   void DxvkGpuQueryManager::beginSingleQuery(
     const Rc<DxvkCommandList>&  cmd,
     const Rc<DxvkGpuQuery>&     query) {
@@ -384,7 +451,10 @@ namespace dxvk {
         handle.queryId);
     }
 
-    cmd->trackResource<DxvkAccess::None>(query);
+    if (handle.queryPool)
+      m_endedQueries.push_back(handle);
+
+    cmd->trackResource<DxvkAccess::Read>(query);
   }
   
   
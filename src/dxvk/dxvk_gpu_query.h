@@ -7,6 +7,7 @@
 
 namespace dxvk {
 
+  class DxvkBuffer;
   class DxvkCommandList;
 
   class DxvkGpuQueryPool;
@@ -99,11 +100,18 @@ namespace dxvk {
    * the actual pool and query index. Since
    * query pools have to be reset on the GPU,
    * this also comes with a reset event.
+   *
+   * Query results are copied to a mapped buffer
+   * at the end of the command list that ends the
+   * query. The data pointer points to the results
+   * of this query within that buffer.
    */
   struct DxvkGpuQueryHandle {
     DxvkGpuQueryAllocator* allocator  = nullptr;
     VkQueryPool            queryPool  = VK_NULL_HANDLE;
     uint32_t               queryId    = 0;
+    VkBuffer               dataBuffer = VK_NULL_HANDLE;
+    const void*            dataPtr    = nullptr;
   };
 
 
@@ -177,7 +185,9 @@ namespace dxvk {
      * return \c DxvkGpuQueryStatus::Signaled, and
      * the destination structure will be filled
      * with the data retrieved from all associated
-     * query handles.
+     * query handles. Data is read from mapped
+     * memory once all command lists using the
+     * query have finished executing.
      * \param [out] queryData Query data
      * \returns Current query status
      */
@@ -228,7 +238,7 @@ namespace dxvk {
     
     std::vector<DxvkGpuQueryHandle> m_handles;
     
-    DxvkGpuQueryStatus getDataForHandle(
+    void getDataForHandle(
             DxvkQueryData&      queryData,
       const DxvkGpuQueryHandle& handle) const;
 
@@ -272,16 +282,26 @@ namespace dxvk {
      */
     void freeQuery(DxvkGpuQueryHandle handle);
 
+    /**
+     * \brief Size of the results of a single query
+     * \returns Result data stride, in bytes
+     */
+    VkDeviceSize dataStride() const {
+      return m_dataStride;
+    }
+
   private:
 
     DxvkDevice*       m_device;
     Rc<vk::DeviceFn>  m_vkd;
     VkQueryType       m_queryType;
     uint32_t          m_queryPoolSize;
+    VkDeviceSize      m_dataStride;
     
     dxvk::mutex                     m_mutex;
     std::vector<DxvkGpuQueryHandle> m_handles;
     std::vector<VkQueryPool>        m_pools;
+    std::vector<Rc<DxvkBuffer>>     m_buffers;
 
     void createQueryPool();
 
@@ -393,11 +413,25 @@ namespace dxvk {
       const Rc<DxvkCommandList>&  cmd,
             VkQueryType           type);
 
+    /**
+     * \brief Copies query results to mapped memory
+     * 
+     * Records copy commands for all queries ended since
+     * the last call, merging consecutive queries of the
+     * same pool into one copy. Must be called outside
+     * of a render pass before submitting the command
+     * list, after all active queries have been ended.
+     * \param [in] cmd Command list
+     */
+    void resolveQueries(
+      const Rc<DxvkCommandList>&  cmd);
+
   private:
 
-    DxvkGpuQueryPool*             m_pool;
-    uint32_t                      m_activeTypes;
-    std::vector<Rc<DxvkGpuQuery>> m_activeQueries;
+    DxvkGpuQueryPool*               m_pool;
+    uint32_t                        m_activeTypes;
+    std::vector<Rc<DxvkGpuQuery>>   m_activeQueries;
+    std::vector<DxvkGpuQueryHandle> m_endedQueries;
 
     void beginSingleQuery(
       const Rc<DxvkCommandList>&  cmd,
@@ -81,8 +81,10 @@ namespace dxvk {
         if (async && m_pipeMgr->m_compiler != nullptr)
           m_pipeMgr->m_compiler->queueCompilation(this, state, renderPass);
         else {
+          auto t0 = dxvk::high_resolution_clock::now();
           instance = this->createInstance(state, renderPass);
           this->writePipelineStateToCache(state, renderPass->format());
+          this->recordStall(state, t0);
         }
       }
     }
@@ -113,6 +115,10 @@ namespace dxvk {
   DxvkGraphicsPipelineInstance* DxvkGraphicsPipeline::createInstance(
     const DxvkGraphicsPipelineStateInfo& state,
     const DxvkRenderPass*                renderPass) {
+    DxvkTraceRecorder* tracer = m_pipeMgr->m_device->tracer();
+    DxvkTraceScope trace(tracer, "CompileGraphicsPipeline", "pipeline",
+      tracer ? getDebugName() : std::string());
+
     VkPipeline pipeline = this->createPipeline(state, renderPass);
 
     std::lock_guard<dxvk::mutex> lock(m_mutex2);
@@ -490,6 +496,22 @@ namespace dxvk {
     }
 
     info.undefinedInputs = (providedInputs & consumedInputs) ^ consumedInputs;
+
+    // Remove outputs that the next stage does not read. Hull shader
+    // outputs are not handled for the same reason as above, and
+    // transform feedback may capture any output.
+    if (shaderInfo.stage != VK_SHADER_STAGE_FRAGMENT_BIT
+     && shaderInfo.stage != VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT
+     && !shader->flags().test(DxvkShaderFlag::HasTransformFeedback)) {
+      auto nextStage = getNextStageShader(shaderInfo.stage);
+
+      uint32_t consumedOutputs = nextStage != nullptr
+        ? nextStage->info().inputMask : 0u;
+
+      if (nextStage == nullptr || nextStage->info().stage != VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT)
+        info.unusedOutputs = shaderInfo.outputMask & ~consumedOutputs;
+    }
+
     return shader->createShaderModule(m_vkd, m_slotMapping, info);
   }
 
@@ -519,6 +541,23 @@ namespace dxvk {
   }
 
 
+  Rc<DxvkShader> DxvkGraphicsPipeline::getNextStageShader(VkShaderStageFlagBits stage) const {
+    if (stage == VK_SHADER_STAGE_FRAGMENT_BIT)
+      return nullptr;
+
+    if (stage == VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT)
+      return m_shaders.tes;
+
+    if (stage == VK_SHADER_STAGE_VERTEX_BIT && m_shaders.tcs != nullptr)
+      return m_shaders.tcs;
+
+    if (stage != VK_SHADER_STAGE_GEOMETRY_BIT && m_shaders.gs != nullptr)
+      return m_shaders.gs;
+
+    return m_shaders.fs;
+  }
+
+
   bool DxvkGraphicsPipeline::validatePipelineState(
     const DxvkGraphicsPipelineStateInfo&  state,
           bool                            trusted) const {
@@ -623,6 +662,41 @@ namespace dxvk {
   }
   
   
+  void DxvkGraphicsPipeline::recordStall(
+    const DxvkGraphicsPipelineStateInfo& state,
+          dxvk::high_resolution_clock::time_point startTime) const {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      dxvk::high_resolution_clock::now() - startTime).count();
+
+    m_pipeMgr->m_device->addStatCtr(DxvkStatCounter::PipeStallCount, 1);
+    m_pipeMgr->m_device->addStatCtr(DxvkStatCounter::PipeStallTicks, duration);
+
+    if (!m_pipeMgr->m_stallTracker.isWorstStall(duration))
+      return;
+
+    DxvkPipelineStall stall;
+    stall.duration = duration;
+    stall.state    = Sha1Hash::compute(state);
+
+    for (const auto& shader : { m_shaders.vs, m_shaders.tcs, m_shaders.tes, m_shaders.gs, m_shaders.fs }) {
+      if (shader != nullptr)
+        stall.shaders.push_back(shader->getShaderKey());
+    }
+
+    m_pipeMgr->m_stallTracker.addStall(std::move(stall));
+  }
+
+
+  std::string DxvkGraphicsPipeline::getDebugName() const {
+    std::string name = m_shaders.vs != nullptr ? m_shaders.vs->debugName() : "";
+
+    if (m_shaders.fs != nullptr)
+      name += " " + m_shaders.fs->debugName();
+
+    return name;
+  }
+
+
   void DxvkGraphicsPipeline::logPipelineState(
           LogLevel                       level,
     const DxvkGraphicsPipelineStateInfo& state) const {
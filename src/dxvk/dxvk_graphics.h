@@ -3,6 +3,7 @@
 #include <mutex>
 
 #include "../util/sync/sync_list.h"
+#include "../util/util_time.h"
 
 #include "dxvk_bind_mask.h"
 #include "dxvk_constant_state.h"
@@ -269,10 +270,19 @@ namespace dxvk {
     Rc<DxvkShader> getPrevStageShader(
             VkShaderStageFlagBits          stage) const;
 
+    Rc<DxvkShader> getNextStageShader(
+            VkShaderStageFlagBits          stage) const;
+
     bool validatePipelineState(
       const DxvkGraphicsPipelineStateInfo& state,
             bool                           trusted) const;
     
+    void recordStall(
+      const DxvkGraphicsPipelineStateInfo& state,
+            dxvk::high_resolution_clock::time_point startTime) const;
+
+    std::string getDebugName() const;
+
     void logPipelineState(
             LogLevel                       level,
       const DxvkGraphicsPipelineStateInfo& state) const;
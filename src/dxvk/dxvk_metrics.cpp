@@ -0,0 +1,248 @@
+#include <utility>
+
+#include "dxvk_device.h"
+#include "dxvk_metrics.h"
+
+namespace dxvk {
+
+  struct DxvkMetricsColumn {
+    const char*       name;
+    DxvkStatCounter   counter;
+    bool              perFrame;
+  };
+
+  /**
+   * Column order is part of the file format. Avoid
+   * reordering or renaming existing columns.
+   */
+  static const std::array<DxvkMetricsColumn, 32> g_counterColumns = {{
+    { "draw_calls",         DxvkStatCounter::CmdDrawCalls,             true  },
+    { "dispatch_calls",     DxvkStatCounter::CmdDispatchCalls,         true  },
+    { "render_passes",      DxvkStatCounter::CmdRenderPassCount,       true  },
+    { "barriers",           DxvkStatCounter::CmdBarrierCount,          true  },
+    { "graphics_pipelines", DxvkStatCounter::PipeCountGraphics,        false },
+    { "compute_pipelines",  DxvkStatCounter::PipeCountCompute,         false },
+    { "compiler_busy",      DxvkStatCounter::PipeCompilerBusy,         false },
+    { "queue_submits",      DxvkStatCounter::QueueSubmitCount,         true  },
+    { "gpu_syncs",          DxvkStatCounter::GpuSyncCount,             true  },
+    { "gpu_sync_us",        DxvkStatCounter::GpuSyncTicks,             true  },
+    { "gpu_idle_us",        DxvkStatCounter::GpuIdleTicks,             true  },
+    { "cs_syncs",           DxvkStatCounter::CsSyncCount,              true  },
+    { "cs_sync_us",         DxvkStatCounter::CsSyncTicks,              true  },
+    { "cs_chunks",          DxvkStatCounter::CsChunkCount,             true  },
+    { "api_draw_us",        DxvkStatCounter::ApiDrawTicks,             true  },
+    { "api_prepare_us",     DxvkStatCounter::ApiPrepareDrawTicks,      true  },
+    { "api_constants_us",   DxvkStatCounter::ApiConstantTicks,         true  },
+    { "api_shaders_us",     DxvkStatCounter::ApiShaderTicks,           true  },
+    { "api_state_us",       DxvkStatCounter::ApiStateTicks,            true  },
+    { "api_resources_us",   DxvkStatCounter::ApiResourceTicks,         true  },
+    { "api_submit_us",      DxvkStatCounter::ApiSubmitTicks,           true  },
+    { "api_present_us",     DxvkStatCounter::ApiPresentTicks,          true  },
+    { "pipeline_stalls",    DxvkStatCounter::PipeStallCount,           true  },
+    { "pipeline_stall_us",  DxvkStatCounter::PipeStallTicks,           true  },
+    { "hud_draws",          DxvkStatCounter::HudDrawCalls,             true  },
+    { "hud_upload_bytes",   DxvkStatCounter::HudUploadSize,            true  },
+    { "hud_us",             DxvkStatCounter::HudRenderTicks,           true  },
+    { "const_upload_bytes", DxvkStatCounter::ApiConstantUploadSize,    true  },
+    { "const_saved_bytes",  DxvkStatCounter::ApiConstantSavedSize,     true  },
+    { "tex_upload_bytes",   DxvkStatCounter::ApiTextureUploadSize,     true  },
+    { "redundant_binds",    DxvkStatCounter::ApiRedundantBindings,     true  },
+    { "rp_splits_saved",    DxvkStatCounter::CmdRenderPassSplitsSaved, true  },
+  }};
+
+  static const std::array<const char*, 4> g_memoryColumns = {{
+    "vidmem_allocated", "vidmem_used",
+    "sysmem_allocated", "sysmem_used",
+  }};
+
+
+  DxvkMetricsExporter::DxvkMetricsExporter(
+          DxvkDevice*           device,
+    const std::string&          fileName,
+          DxvkMetricsFormat     format)
+  : m_device    (device),
+    m_format    (format),
+    m_memory    (device->adapter()->memoryProperties()),
+    m_startTime (dxvk::high_resolution_clock::now()),
+    m_file      (str::topath(fileName.c_str()).c_str(), std::ios_base::trunc) {
+    if (!m_file) {
+      Logger::err(str::format("DXVK: Failed to open metrics file ", fileName));
+      return;
+    }
+
+    Logger::info(str::format("DXVK: Writing metrics to ", fileName));
+    writeHeader();
+
+    m_thread = dxvk::thread([this] { runWriter(); });
+  }
+
+
+  DxvkMetricsExporter::~DxvkMetricsExporter() {
+    if (!m_thread.joinable())
+      return;
+
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+      m_stopped = true;
+    }
+
+    m_cond.notify_one();
+    m_thread.join();
+  }
+
+
+  void DxvkMetricsExporter::captureFrame() {
+    DxvkMetricsFrame frame;
+    frame.time = std::chrono::duration_cast<std::chrono::microseconds>(
+      dxvk::high_resolution_clock::now() - m_startTime).count();
+    frame.counters = m_device->getStatCounters();
+
+    for (uint32_t i = 0; i < m_memory.memoryHeapCount; i++) {
+      DxvkMemoryStats stats = m_device->getMemoryStats(i);
+
+      DxvkMemoryStats& dst = (m_memory.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        ? frame.vidmem : frame.sysmem;
+
+      dst.memoryAllocated += stats.memoryAllocated;
+      dst.memoryUsed      += stats.memoryUsed;
+    }
+
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+      m_frames.push_back(frame);
+    }
+
+    m_cond.notify_one();
+  }
+
+
+  Rc<DxvkMetricsExporter> DxvkMetricsExporter::createExporter(
+          DxvkDevice*           device) {
+    static std::atomic<uint32_t> s_fileId = { 0u };
+
+    const DxvkOptions& options = device->config();
+
+    std::string path = env::getEnvVar("DXVK_METRICS_PATH");
+
+    if (path.empty())
+      path = options.metricsPath;
+
+    if (path.empty())
+      return nullptr;
+
+    DxvkMetricsFormat format = DxvkMetricsFormat::Csv;
+
+    if (options.metricsFormat == "json")
+      format = DxvkMetricsFormat::Json;
+    else if (options.metricsFormat != "csv")
+      Logger::warn(str::format("DXVK: Unknown metrics format: ", options.metricsFormat));
+
+    if (*path.rbegin() != '/')
+      path += '/';
+
+    uint32_t fileId = s_fileId++;
+    std::string extension = format == DxvkMetricsFormat::Json
+      ? ".metrics.jsonl" : ".metrics.csv";
+
+    path += env::getExeBaseName();
+    path += fileId ? str::format("_", fileId, extension) : extension;
+
+    Rc<DxvkMetricsExporter> exporter = new DxvkMetricsExporter(device, path, format);
+
+    if (!exporter->m_thread.joinable())
+      return nullptr;
+
+    return exporter;
+  }
+
+
+  void DxvkMetricsExporter::writeHeader() {
+    if (m_format != DxvkMetricsFormat::Csv)
+      return;
+
+    m_file << "frame,time_us,frame_time_us";
+
+    for (const auto& column : g_counterColumns)
+      m_file << "," << column.name;
+
+    for (const char* name : g_memoryColumns)
+      m_file << "," << name;
+
+    m_file << "\n";
+  }
+
+
+  void DxvkMetricsExporter::writeFrame(
+    const DxvkMetricsFrame&     frame) {
+    std::array<uint64_t, g_counterColumns.size()> counters;
+    std::array<uint64_t, g_memoryColumns.size()> memory = {{
+      frame.vidmem.memoryAllocated, frame.vidmem.memoryUsed,
+      frame.sysmem.memoryAllocated, frame.sysmem.memoryUsed,
+    }};
+
+    for (size_t i = 0; i < g_counterColumns.size(); i++) {
+      const auto& column = g_counterColumns[i];
+      counters[i] = frame.counters.getCtr(column.counter);
+
+      if (column.perFrame)
+        counters[i] -= m_prevFrame.counters.getCtr(column.counter);
+    }
+
+    uint64_t frameId   = frame.counters.getCtr(DxvkStatCounter::QueuePresentCount);
+    uint64_t frameTime = frame.time - m_prevFrame.time;
+
+    if (m_format == DxvkMetricsFormat::Csv) {
+      m_file << frameId << "," << frame.time << "," << frameTime;
+
+      for (uint64_t value : counters)
+        m_file << "," << value;
+
+      for (uint64_t value : memory)
+        m_file << "," << value;
+    } else {
+      m_file << "{\"frame\":" << frameId
+             << ",\"time_us\":" << frame.time
+             << ",\"frame_time_us\":" << frameTime;
+
+      for (size_t i = 0; i < counters.size(); i++)
+        m_file << ",\"" << g_counterColumns[i].name << "\":" << counters[i];
+
+      for (size_t i = 0; i < memory.size(); i++)
+        m_file << ",\"" << g_memoryColumns[i] << "\":" << memory[i];
+
+      m_file << "}";
+    }
+
+    m_file << "\n";
+    m_prevFrame = frame;
+  }
+
+
+  void DxvkMetricsExporter::runWriter() {
+    env::setThreadName("dxvk-metrics");
+
+    std::vector<DxvkMetricsFrame> frames;
+
+    while (true) {
+      bool stopped;
+
+      { std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+        m_cond.wait(lock, [this] {
+          return m_stopped || !m_frames.empty();
+        });
+
+        stopped = m_stopped;
+        std::swap(frames, m_frames);
+      }
+
+      for (const auto& frame : frames)
+        writeFrame(frame);
+
+      frames.clear();
+      m_file.flush();
+
+      if (stopped)
+        break;
+    }
+  }
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <fstream>
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_time.h"
+
+#include "dxvk_include.h"
+#include "dxvk_memory.h"
+#include "dxvk_options.h"
+#include "dxvk_stats.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+
+  /**
+   * \brief Metrics file format
+   */
+  enum class DxvkMetricsFormat : uint32_t {
+    Csv,                      ///< Comma-separated values with header row
+    Json,                     ///< One JSON object per line
+  };
+
+
+  /**
+   * \brief Metrics frame snapshot
+   *
+   * Raw counter values captured at present time.
+   * Per-frame deltas are computed by the writer.
+   */
+  struct DxvkMetricsFrame {
+    uint64_t                  time;
+    DxvkStatCounters          counters;
+    DxvkMemoryStats           vidmem;
+    DxvkMemoryStats           sysmem;
+  };
+
+
+  /**
+   * \brief Metrics exporter
+   *
+   * Snapshots the device's stat counters and memory
+   * statistics once per presented frame, and writes
+   * them to a file on a background thread. Columns
+   * are written in a fixed order so that files from
+   * different runs can be compared directly.
+   */
+  class DxvkMetricsExporter : public RcObject {
+
+  public:
+
+    DxvkMetricsExporter(
+            DxvkDevice*           device,
+      const std::string&          fileName,
+            DxvkMetricsFormat     format);
+
+    ~DxvkMetricsExporter();
+
+    /**
+     * \brief Captures counters for the current frame
+     *
+     * Called by the device whenever an image gets
+     * presented. The actual file write is deferred
+     * to the exporter's writer thread.
+     */
+    void captureFrame();
+
+    /**
+     * \brief Creates a metrics exporter if enabled
+     *
+     * Export is enabled by setting \c DXVK_METRICS_PATH
+     * or the \c dxvk.metricsPath option to a directory.
+     * \param [in] device The device to export metrics for
+     * \returns Metrics exporter, or \c nullptr
+     */
+    static Rc<DxvkMetricsExporter> createExporter(
+            DxvkDevice*           device);
+
+  private:
+
+    DxvkDevice*                   m_device;
+    DxvkMetricsFormat             m_format;
+
+    VkPhysicalDeviceMemoryProperties m_memory;
+
+    const dxvk::high_resolution_clock::time_point m_startTime;
+
+    dxvk::mutex                   m_mutex;
+    dxvk::condition_variable      m_cond;
+    bool                          m_stopped = false;
+
+    std::vector<DxvkMetricsFrame> m_frames;
+
+    std::ofstream                 m_file;
+    DxvkMetricsFrame              m_prevFrame = { };
+
+    dxvk::thread                  m_thread;
+
+    void writeHeader();
+
+    void writeFrame(
+      const DxvkMetricsFrame&     frame);
+
+    void runWriter();
+
+  };
+
+}
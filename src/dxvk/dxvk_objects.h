@@ -24,6 +24,7 @@ namespace dxvk {
     DxvkObjects(DxvkDevice* device)
     : m_device          (device),
       m_memoryManager   (device),
+      m_bufferArenas    (device, m_memoryManager),
       m_renderPassPool  (device),
       m_pipelineManager (device, &m_renderPassPool),
       m_eventPool       (device),
@@ -36,6 +37,10 @@ namespace dxvk {
       return m_memoryManager;
     }
 
+    DxvkBufferArenaPool& bufferArenas() {
+      return m_bufferArenas;
+    }
+
     DxvkRenderPassPool& renderPassPool() {
       return m_renderPassPool;
     }
@@ -81,6 +86,7 @@ namespace dxvk {
     DxvkDevice*                   m_device;
 
     DxvkMemoryAllocator           m_memoryManager;
+    DxvkBufferArenaPool           m_bufferArenas;
     DxvkRenderPassPool            m_renderPassPool;
     DxvkPipelineManager           m_pipelineManager;
 
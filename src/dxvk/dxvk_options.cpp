@@ -9,6 +9,9 @@ namespace dxvk {
     useRawSsbo            = config.getOption<Tristate>("dxvk.useRawSsbo",             Tristate::Auto);
     shrinkNvidiaHvvHeap   = config.getOption<Tristate>("dxvk.shrinkNvidiaHvvHeap",    Tristate::Auto);
     hud                   = config.getOption<std::string>("dxvk.hud", "");
+    tracePath             = config.getOption<std::string>("dxvk.tracePath", "");
+    metricsPath           = config.getOption<std::string>("dxvk.metricsPath", "");
+    metricsFormat         = config.getOption<std::string>("dxvk.metricsFormat", "csv");
     enableAsync           = config.getOption<bool>    ("dxvk.enableAsync",            false);
     numAsyncThreads       = config.getOption<int32_t> ("dxvk.numAsyncThreads",        0);
   }
@@ -33,6 +33,15 @@ namespace dxvk {
 
     /// HUD elements
     std::string hud;
+
+    /// Directory to write trace files to
+    std::string tracePath;
+
+    /// Directory to write per-frame metrics to
+    std::string metricsPath;
+
+    /// Metrics file format, csv or json
+    std::string metricsFormat;
   };
 
 }
@@ -84,6 +84,11 @@ namespace dxvk {
   }
 
 
+  std::vector<DxvkPipelineStall> DxvkPipelineManager::getPipelineStalls() const {
+    return m_stallTracker.getStalls();
+  }
+
+
   void DxvkPipelineManager::stopWorkerThreads() const {
     if (m_stateCache != nullptr)
       m_stateCache->stopWorkerThreads();
@@ -7,6 +7,7 @@
 #include "dxvk_compute.h"
 #include "dxvk_graphics.h"
 #include "dxvk_pipecompiler.h"
+#include "dxvk_pipestall.h"
 
 namespace dxvk {
 
@@ -79,6 +80,14 @@ namespace dxvk {
     void registerShader(
       const Rc<DxvkShader>&         shader);
     
+    /**
+     * \brief Checks whether the state cache is enabled
+     * \returns \c true if pipelines are cached on disk
+     */
+    bool hasStateCache() const {
+      return m_stateCache != nullptr;
+    }
+
     /**
      * \brief Retrieves total pipeline count
      * \returns Number of compute/graphics pipelines
@@ -91,6 +100,12 @@ namespace dxvk {
      */
     bool isCompilingShaders() const;
 
+    /**
+     * \brief Retrieves worst pipeline compile stalls
+     * \returns Longest stalls seen so far
+     */
+    std::vector<DxvkPipelineStall> getPipelineStalls() const;
+
     /**
      * \brief Stops async compiler threads
      */
@@ -105,6 +120,8 @@ namespace dxvk {
 
     std::atomic<uint32_t>     m_numComputePipelines  = { 0 };
     std::atomic<uint32_t>     m_numGraphicsPipelines = { 0 };
+
+    DxvkPipelineStallTracker  m_stallTracker;
     
     dxvk::mutex m_mutex;
     
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <iomanip>
+
+#include "dxvk_pipestall.h"
+
+namespace dxvk {
+
+  DxvkPipelineStallTracker::DxvkPipelineStallTracker() {
+
+  }
+
+
+  DxvkPipelineStallTracker::~DxvkPipelineStallTracker() {
+    if (!m_stalls.empty())
+      logStalls();
+  }
+
+
+  bool DxvkPipelineStallTracker::isWorstStall(uint64_t duration) const {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    return m_stalls.size() < MaxStallCount
+        || m_stalls.back().duration < duration;
+  }
+
+
+  void DxvkPipelineStallTracker::addStall(DxvkPipelineStall&& stall) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    auto entry = std::upper_bound(m_stalls.begin(), m_stalls.end(), stall,
+      [] (const DxvkPipelineStall& a, const DxvkPipelineStall& b) {
+        return a.duration > b.duration;
+      });
+
+    m_stalls.insert(entry, std::move(stall));
+
+    if (m_stalls.size() > MaxStallCount)
+      m_stalls.pop_back();
+  }
+
+
+  std::vector<DxvkPipelineStall> DxvkPipelineStallTracker::getStalls() const {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    return m_stalls;
+  }
+
+
+  void DxvkPipelineStallTracker::logStalls() const {
+    Logger::info("DXVK: Longest pipeline compile stalls:");
+
+    for (const auto& stall : m_stalls) {
+      std::string shaders;
+
+      for (const auto& key : stall.shaders)
+        shaders += str::format(" ", key.toString());
+
+      Logger::info(str::format("  ", stall.duration / 1000, ".",
+        std::setfill('0'), std::setw(3), stall.duration % 1000, " ms:",
+        shaders, " state ", stall.state.toString()));
+    }
+  }
+
+}
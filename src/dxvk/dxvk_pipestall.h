@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include "../util/sha1/sha1_util.h"
+
+#include "../util/thread.h"
+
+#include "dxvk_include.h"
+#include "dxvk_shader_key.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Pipeline compilation stall
+   *
+   * Describes a pipeline that had to be compiled
+   * synchronously while recording commands.
+   */
+  struct DxvkPipelineStall {
+    uint64_t                    duration;   ///< Stall duration, in microseconds
+    std::vector<DxvkShaderKey>  shaders;    ///< Keys of all active shader stages
+    Sha1Hash                    state;      ///< Hash of the pipeline state vector
+  };
+
+
+  /**
+   * \brief Pipeline stall tracker
+   *
+   * Keeps a list of the longest pipeline compile
+   * stalls seen during the session. Since these are
+   * pipelines that were missing from the state cache,
+   * the list is written to the log on destruction.
+   */
+  class DxvkPipelineStallTracker {
+    constexpr static size_t MaxStallCount = 32;
+  public:
+
+    DxvkPipelineStallTracker();
+
+    ~DxvkPipelineStallTracker();
+
+    /**
+     * \brief Checks whether a stall would be recorded
+     *
+     * Used to avoid building stall info for stalls
+     * that are shorter than all recorded stalls.
+     * \param [in] duration Stall duration
+     * \returns \c true if the stall should be added
+     */
+    bool isWorstStall(uint64_t duration) const;
+
+    /**
+     * \brief Adds a stall to the list
+     * \param [in] stall Stall info
+     */
+    void addStall(DxvkPipelineStall&& stall);
+
+    /**
+     * \brief Retrieves recorded stalls
+     * \returns Stalls, sorted by duration
+     */
+    std::vector<DxvkPipelineStall> getStalls() const;
+
+  private:
+
+    mutable dxvk::mutex             m_mutex;
+    std::vector<DxvkPipelineStall>  m_stalls;
+
+    void logStalls() const;
+
+  };
+
+}
@@ -104,10 +104,14 @@ namespace dxvk {
         std::lock_guard<dxvk::mutex> lock(m_mutexQueue);
 
         if (entry.submit.cmdList != nullptr) {
+          DxvkTraceScope trace(m_device->tracer(), "vkQueueSubmit", "queue");
+
           status = entry.submit.cmdList->submit(
             entry.submit.waitSync,
             entry.submit.wakeSync);
         } else if (entry.present.presenter != nullptr) {
+          DxvkTraceScope trace(m_device->tracer(), "vkQueuePresentKHR", "queue");
+
           status = entry.present.presenter->presentImage();
         }
       } else {
@@ -162,8 +166,10 @@ namespace dxvk {
       
       VkResult status = m_lastError.load();
       
-      if (status != VK_ERROR_DEVICE_LOST)
+      if (status != VK_ERROR_DEVICE_LOST) {
+        DxvkTraceScope trace(m_device->tracer(), "WaitForFence", "queue");
         status = entry.submit.cmdList->synchronize();
+      }
       
       if (status != VK_SUCCESS) {
         Logger::err(str::format("DxvkSubmissionQueue: Failed to sync fence: ", status));
@@ -159,7 +159,13 @@ namespace dxvk {
     
     // Replace undefined input variables with zero
     for (uint32_t u : bit::BitMask(info.undefinedInputs))
-      eliminateInput(spirvCode, u);
+      eliminateVariable(spirvCode, spv::StorageClassInput, u);
+
+    // Turn outputs that are not consumed by the next stage into
+    // private variables so that the driver can remove any code
+    // that only exists to compute them
+    for (uint32_t u : bit::BitMask(info.unusedOutputs))
+      eliminateVariable(spirvCode, spv::StorageClassOutput, u);
 
     return DxvkShaderModule(vkd, this, spirvCode);
   }
@@ -170,7 +176,10 @@ namespace dxvk {
   }
 
 
-  void DxvkShader::eliminateInput(SpirvCodeBuffer& code, uint32_t location) {
+  void DxvkShader::eliminateVariable(
+          SpirvCodeBuffer&          code,
+          spv::StorageClass         storageClass,
+          uint32_t                  location) {
     struct SpirvTypeInfo {
       spv::Op           op            = spv::OpNop;
       uint32_t          baseTypeId    = 0;
@@ -182,10 +191,10 @@ namespace dxvk {
     std::unordered_map<uint32_t, uint32_t>      constants;
     std::unordered_set<uint32_t>                candidates;
 
-    // Find the input variable in question
-    size_t   inputVarOffset = 0;
-    uint32_t inputVarTypeId = 0;
-    uint32_t inputVarId     = 0;
+    // Find the input or output variable in question
+    size_t   varOffset = 0;
+    uint32_t varTypeId = 0;
+    uint32_t varId     = 0;
 
     for (auto ins : code) {
       if (ins.opCode() == spv::OpDecorate) {
@@ -213,25 +222,26 @@ namespace dxvk {
       if (ins.opCode() == spv::OpTypePointer)
         types.insert({ ins.arg(1), { ins.opCode(), ins.arg(3), 0, spv::StorageClass(ins.arg(2)) }});
 
-      if (ins.opCode() == spv::OpVariable && spv::StorageClass(ins.arg(3)) == spv::StorageClassInput) {
+      if (ins.opCode() == spv::OpVariable && spv::StorageClass(ins.arg(3)) == storageClass) {
         if (candidates.find(ins.arg(2)) != candidates.end()) {
-          inputVarOffset = ins.offset();
-          inputVarTypeId = ins.arg(1);
-          inputVarId     = ins.arg(2);
+          varOffset = ins.offset();
+          varTypeId = ins.arg(1);
+          varId     = ins.arg(2);
           break;
         }
       }
     }
 
-    if (!inputVarId)
+    if (!varId)
       return;
 
     // Declare private pointer types
-    auto pointerType = types.find(inputVarTypeId);
-    if (pointerType == types.end())
+    auto pointerType = types.find(varTypeId);
+    if (pointerType == types.end()
+     || types.find(pointerType->second.baseTypeId) == types.end())
       return;
 
-    code.beginInsertion(inputVarOffset);
+    code.beginInsertion(varOffset);
     std::vector<std::pair<uint32_t, SpirvTypeInfo>> privateTypes;
 
     for (auto p  = types.find(pointerType->second.baseTypeId);
@@ -261,40 +271,45 @@ namespace dxvk {
       privateTypes.push_back(info);
     }
 
-    // Define zero constants
+    // Define zero constants. Outputs do not need to be
+    // initialized since the value is never consumed.
     uint32_t constantId = 0;
 
-    for (auto i = privateTypes.rbegin(); i != privateTypes.rend(); i++) {
-      if (constantId) {
-        uint32_t compositeSize = i->second.compositeSize;
-        uint32_t compositeId   = code.allocId();
+    if (storageClass == spv::StorageClassInput) {
+      for (auto i = privateTypes.rbegin(); i != privateTypes.rend(); i++) {
+        if (constantId) {
+          uint32_t compositeSize = i->second.compositeSize;
+          uint32_t compositeId   = code.allocId();
 
-        code.putIns(spv::OpConstantComposite, 3 + compositeSize);
-        code.putWord(i->second.baseTypeId);
-        code.putWord(compositeId);
+          code.putIns(spv::OpConstantComposite, 3 + compositeSize);
+          code.putWord(i->second.baseTypeId);
+          code.putWord(compositeId);
 
-        for (uint32_t i = 0; i < compositeSize; i++)
-          code.putWord(constantId);
+          for (uint32_t i = 0; i < compositeSize; i++)
+            code.putWord(constantId);
 
-        constantId = compositeId;
-      } else {
-        constantId = code.allocId();
+          constantId = compositeId;
+        } else {
+          constantId = code.allocId();
 
-        code.putIns(spv::OpConstant, 4);
-        code.putWord(i->second.baseTypeId);
-        code.putWord(constantId);
-        code.putWord(0);
+          code.putIns(spv::OpConstant, 4);
+          code.putWord(i->second.baseTypeId);
+          code.putWord(constantId);
+          code.putWord(0);
+        }
       }
     }
 
     // Erase and re-declare variable
     code.erase(4);
 
-    code.putIns(spv::OpVariable, 5);
+    code.putIns(spv::OpVariable, constantId ? 5 : 4);
     code.putWord(privateTypes[0].first);
-    code.putWord(inputVarId);
+    code.putWord(varId);
     code.putWord(spv::StorageClassPrivate);
-    code.putWord(constantId);
+
+    if (constantId)
+      code.putWord(constantId);
 
     code.endInsertion();
 
@@ -304,7 +319,7 @@ namespace dxvk {
         uint32_t argIdx = 2 + code.strLen(ins.chr(2));
 
         while (argIdx < ins.length()) {
-          if (ins.arg(argIdx) == inputVarId) {
+          if (ins.arg(argIdx) == varId) {
             ins.setArg(0, spv::OpEntryPoint | ((ins.length() - 1) << spv::WordCountShift));
 
             code.beginInsertion(ins.offset() + argIdx);
@@ -322,11 +337,13 @@ namespace dxvk {
     for (auto iter = code.begin(); iter != code.end(); ) {
       auto ins = *(iter++);
 
-      if (ins.opCode() == spv::OpDecorate && ins.arg(1) == inputVarId) {
+      if (ins.opCode() == spv::OpDecorate && ins.arg(1) == varId) {
         uint32_t numWords;
 
         switch (ins.arg(2)) {
           case spv::DecorationLocation:
+          case spv::DecorationComponent:
+          case spv::DecorationInvariant:
           case spv::DecorationFlat:
           case spv::DecorationNoPerspective:
           case spv::DecorationCentroid:
@@ -359,7 +376,7 @@ namespace dxvk {
        || ins.opCode() == spv::OpInBoundsAccessChain) {
         uint32_t depth = ins.length() - 4;
 
-        if (ins.arg(3) == inputVarId) {
+        if (ins.arg(3) == varId) {
           // Access chains accessing the variable directly
           ins.setArg(1, privateTypes.at(depth).first);
           accessChainIds.insert({ ins.arg(2), depth });
@@ -80,6 +80,7 @@ namespace dxvk {
   struct DxvkShaderModuleCreateInfo {
     bool      fsDualSrcBlend  = false;
     uint32_t  undefinedInputs = 0;
+    uint32_t  unusedOutputs   = 0;
   };
   
   
@@ -214,7 +215,10 @@ namespace dxvk {
     std::vector<char>             m_uniformData;
     std::vector<size_t>           m_idOffsets;
 
-    static void eliminateInput(SpirvCodeBuffer& code, uint32_t location);
+    static void eliminateVariable(
+            SpirvCodeBuffer&          code,
+            spv::StorageClass         storageClass,
+            uint32_t                  location);
 
   };
   
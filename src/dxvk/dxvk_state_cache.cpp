@@ -461,6 +461,8 @@ namespace dxvk {
   }
 
   bool DxvkStateCache::readCacheFile() {
+    DxvkTraceScope trace(m_device->tracer(), "StateCacheRead", "state-cache");
+
     realReadCacheFile(getBaseCacheFileName());
     return realReadCacheFile(getCacheFileName());
   }
@@ -940,6 +942,7 @@ namespace dxvk {
         m_workerQueue.pop();
       }
 
+      DxvkTraceScope trace(m_device->tracer(), "StateCacheCompile", "state-cache");
       compilePipelines(item);
     }
   }
@@ -973,6 +976,7 @@ namespace dxvk {
           std::ios_base::app);
       }
 
+      DxvkTraceScope trace(m_device->tracer(), "StateCacheWrite", "state-cache");
       writeCacheEntry(file, entry);
     }
   }
@@ -1032,7 +1036,7 @@ namespace dxvk {
   }
 
 
-  std::string DxvkStateCache::getCacheDir() const {
+  std::string DxvkStateCache::getCacheDir() {
     return env::getEnvVar("DXVK_STATE_CACHE_PATH");
   }
 
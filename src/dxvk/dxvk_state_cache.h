@@ -84,6 +84,15 @@ namespace dxvk {
       return m_workerBusy.load() > 0;
     }
 
+    /**
+     * \brief Retrieves the cache directory
+     *
+     * Other caches that live next to the state
+     * cache file should use this as well.
+     * \returns Cache directory, may be empty
+     */
+    static std::string getCacheDir();
+
   private:
 
     using WriterItem = DxvkStateCacheEntry;
@@ -193,8 +202,6 @@ namespace dxvk {
 
     std::wstring getBaseCacheFileName() const;
 
-    std::string getCacheDir() const;
-
     static uint8_t packImageLayout(
             VkImageLayout             layout);
 
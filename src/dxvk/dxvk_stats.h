@@ -14,6 +14,7 @@ namespace dxvk {
     CmdDrawCalls,             ///< Number of draw calls
     CmdDispatchCalls,         ///< Number of compute calls
     CmdRenderPassCount,       ///< Number of render passes
+    CmdRenderPassSplitsSaved, ///< Buffer updates hoisted out of a render pass
     CmdBarrierCount,          ///< Number of pipeline barriers
     PipeCountGraphics,        ///< Number of graphics pipelines
     PipeCountCompute,         ///< Number of compute pipelines
@@ -26,6 +27,23 @@ namespace dxvk {
     CsSyncCount,              ///< CS thread synchronizations
     CsSyncTicks,              ///< Time spent waiting on CS
     CsChunkCount,             ///< Submitted CS chunks
+    ApiDrawTicks,             ///< API thread time in draw calls
+    ApiPrepareDrawTicks,      ///< API thread time in draw state validation
+    ApiConstantTicks,         ///< API thread time in constant updates
+    ApiShaderTicks,           ///< API thread time in shader binding
+    ApiStateTicks,            ///< API thread time in other state setters
+    ApiResourceTicks,         ///< API thread time in resource updates
+    ApiSubmitTicks,           ///< API thread time in submissions
+    ApiPresentTicks,          ///< API thread time in present
+    PipeStallCount,           ///< Synchronous pipeline compilations
+    PipeStallTicks,           ///< Time spent compiling pipelines synchronously
+    HudDrawCalls,             ///< Draw calls issued by the HUD
+    HudUploadSize,            ///< Bytes uploaded by the HUD
+    HudRenderTicks,           ///< CPU time spent updating and rendering the HUD
+    ApiConstantUploadSize,    ///< Bytes of shader constants uploaded
+    ApiConstantSavedSize,     ///< Bytes of constant uploads skipped as redundant
+    ApiTextureUploadSize,     ///< Bytes of managed texture data uploaded
+    ApiRedundantBindings,     ///< Number of redundant resource bindings skipped
     NumCounters,              ///< Number of counters available
   };
   
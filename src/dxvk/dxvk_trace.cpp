@@ -0,0 +1,258 @@
+#include <array>
+#include <cstring>
+#include <iomanip>
+#include <utility>
+
+#include "dxvk_trace.h"
+
+namespace dxvk {
+
+  static std::atomic<uint64_t> g_recorderId = { 0ull };
+  static std::atomic<uint32_t> g_traceThreadId = { 0u };
+
+  struct DxvkTraceBufferSlot {
+    uint64_t          recorderId;
+    DxvkTraceBuffer*  buffer;
+  };
+
+  // Small per-thread cache of rings, so that threads which record
+  // into more than one device do not have to take the lock
+  static thread_local std::array<DxvkTraceBufferSlot, 4> t_slots = { };
+  static thread_local uint32_t t_nextSlot = 0;
+  static thread_local uint32_t t_threadId = 0;
+
+
+  DxvkTraceBuffer::DxvkTraceBuffer(
+          uint32_t              threadId,
+          std::string           threadName)
+  : m_threadId(threadId), m_threadName(std::move(threadName)),
+    m_events(Capacity) {
+
+  }
+
+
+  DxvkTraceBuffer::~DxvkTraceBuffer() {
+
+  }
+
+
+  void DxvkTraceBuffer::push(const DxvkTraceEvent& event) {
+    uint64_t w = m_writeIndex.load(std::memory_order_relaxed);
+    uint64_t r = m_readIndex.load(std::memory_order_acquire);
+
+    if (unlikely(w - r >= Capacity)) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    m_events[w % Capacity] = event;
+    m_writeIndex.store(w + 1, std::memory_order_release);
+  }
+
+
+  DxvkTraceRecorder::DxvkTraceRecorder(
+    const std::string&          fileName)
+  : m_id        (++g_recorderId),
+    m_startTime (dxvk::high_resolution_clock::now()),
+    m_file      (str::topath(fileName.c_str()).c_str(), std::ios_base::trunc) {
+    if (!m_file) {
+      Logger::err(str::format("DXVK: Failed to open trace file ", fileName));
+      return;
+    }
+
+    Logger::info(str::format("DXVK: Writing trace to ", fileName));
+    m_file << "[";
+
+    m_thread = dxvk::thread([this] { runWriter(); });
+  }
+
+
+  DxvkTraceRecorder::~DxvkTraceRecorder() {
+    if (!m_thread.joinable())
+      return;
+
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+      m_stopped = true;
+    }
+
+    m_cond.notify_one();
+    m_thread.join();
+
+    writeEvents();
+
+    for (auto buffer : m_writerBuffers) {
+      if (buffer->droppedEvents()) {
+        Logger::warn(str::format("DXVK: Trace dropped ", buffer->droppedEvents(),
+          " events on thread ", buffer->threadName()));
+      }
+    }
+
+    m_file << "\n]\n";
+  }
+
+
+  void DxvkTraceRecorder::record(
+    const char*                 name,
+    const char*                 category,
+          uint64_t              start,
+    const char*                 detail) {
+    DxvkTraceEvent event;
+    event.name      = name;
+    event.category  = category;
+    event.start     = start;
+    event.duration  = now() - start;
+    str::strlcpy(event.detail, detail ? detail : "", sizeof(event.detail));
+
+    getThreadBuffer()->push(event);
+  }
+
+
+  Rc<DxvkTraceRecorder> DxvkTraceRecorder::createRecorder(
+    const DxvkOptions&          options) {
+    static std::atomic<uint32_t> s_fileId = { 0u };
+
+    std::string path = env::getEnvVar("DXVK_TRACE_PATH");
+
+    if (path.empty())
+      path = options.tracePath;
+
+    if (path.empty())
+      return nullptr;
+
+    if (*path.rbegin() != '/')
+      path += '/';
+
+    uint32_t fileId = s_fileId++;
+
+    path += env::getExeBaseName();
+    path += fileId ? str::format("_", fileId, ".trace.json") : ".trace.json";
+
+    Rc<DxvkTraceRecorder> recorder = new DxvkTraceRecorder(path);
+
+    if (!recorder->m_thread.joinable())
+      return nullptr;
+
+    return recorder;
+  }
+
+
+  DxvkTraceBuffer* DxvkTraceRecorder::getThreadBuffer() {
+    for (const auto& slot : t_slots) {
+      if (likely(slot.recorderId == m_id))
+        return slot.buffer;
+    }
+
+    if (!t_threadId)
+      t_threadId = ++g_traceThreadId;
+
+    // The ring may have been evicted from the cache, only
+    // create a new one on the first event on this thread
+    DxvkTraceBuffer* buffer = nullptr;
+
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      for (const auto& b : m_buffers) {
+        if (b->threadId() == t_threadId) {
+          buffer = b.get();
+          break;
+        }
+      }
+
+      if (!buffer) {
+        std::string threadName = env::getThreadName();
+
+        if (threadName.empty())
+          threadName = str::format("thread-", t_threadId);
+
+        m_buffers.push_back(std::make_unique<DxvkTraceBuffer>(t_threadId, threadName));
+        buffer = m_buffers.back().get();
+      }
+    }
+
+    t_slots[t_nextSlot++ % t_slots.size()] = { m_id, buffer };
+    return buffer;
+  }
+
+
+  void DxvkTraceRecorder::writeEvents() {
+    // Rings are never removed while the recorder is alive, so only
+    // the list itself needs to be protected. Formatting and file
+    // I/O happen without holding the lock.
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      for (size_t i = m_writerBuffers.size(); i < m_buffers.size(); i++)
+        m_writerBuffers.push_back(m_buffers[i].get());
+    }
+
+    // Emit thread names for rings that were added since the last write
+    for (uint32_t i = m_threadsNamed; i < m_writerBuffers.size(); i++) {
+      writeEntry(str::format(
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":", m_writerBuffers[i]->threadId(),
+        ",\"args\":{\"name\":\"", escape(m_writerBuffers[i]->threadName().c_str()), "\"}}"));
+    }
+
+    m_threadsNamed = m_writerBuffers.size();
+
+    for (auto buffer : m_writerBuffers) {
+      uint32_t tid = buffer->threadId();
+
+      buffer->drain([this, tid] (const DxvkTraceEvent& e) {
+        std::stringstream entry;
+        entry << std::fixed << std::setprecision(3)
+              << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category
+              << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+              << ",\"ts\":" << (double(e.start) / 1000.0)
+              << ",\"dur\":" << (double(e.duration) / 1000.0);
+
+        if (e.detail[0])
+          entry << ",\"args\":{\"detail\":\"" << escape(e.detail) << "\"}";
+
+        entry << "}";
+        writeEntry(entry.str());
+      });
+    }
+
+    m_file.flush();
+  }
+
+
+  void DxvkTraceRecorder::writeEntry(
+    const std::string&          entry) {
+    m_file << (std::exchange(m_firstEntry, false) ? "\n" : ",\n") << entry;
+  }
+
+
+  void DxvkTraceRecorder::runWriter() {
+    env::setThreadName("dxvk-trace");
+
+    while (true) {
+      { std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+        m_cond.wait_for(lock, std::chrono::milliseconds(50),
+          [this] { return m_stopped; });
+
+        if (m_stopped)
+          break;
+      }
+
+      writeEvents();
+    }
+  }
+
+
+  std::string DxvkTraceRecorder::escape(
+    const char*                 str) {
+    std::string result;
+
+    for (const char* c = str; *c; c++) {
+      if (*c == '"' || *c == '\\')
+        result += '\\';
+
+      if (uint8_t(*c) >= 0x20)
+        result += *c;
+    }
+
+    return result;
+  }
+
+}
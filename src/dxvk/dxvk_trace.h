@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_time.h"
+
+#include "dxvk_include.h"
+#include "dxvk_options.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Trace event
+   *
+   * A single completed scope. Names and categories
+   * must be string literals, since only the pointer
+   * is stored. The optional detail string is copied.
+   */
+  struct DxvkTraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t    start;
+    uint64_t    duration;
+    char        detail[96];
+  };
+
+
+  /**
+   * \brief Per-thread trace event ring
+   *
+   * Lock-free single-producer, single-consumer ring
+   * buffer. Only the owning thread writes events, and
+   * only the recorder's writer thread consumes them.
+   * Events are dropped if the ring is full.
+   */
+  class DxvkTraceBuffer {
+    constexpr static uint32_t Capacity = 4096;
+  public:
+
+    DxvkTraceBuffer(
+            uint32_t              threadId,
+            std::string           threadName);
+
+    ~DxvkTraceBuffer();
+
+    uint32_t threadId() const {
+      return m_threadId;
+    }
+
+    const std::string& threadName() const {
+      return m_threadName;
+    }
+
+    /**
+     * \brief Number of dropped events
+     * \returns Events lost due to a full ring
+     */
+    uint64_t droppedEvents() const {
+      return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Records an event
+     *
+     * Must only be called from the owning thread.
+     * \param [in] event The event to record
+     */
+    void push(const DxvkTraceEvent& event);
+
+    /**
+     * \brief Retrieves recorded events
+     *
+     * Must only be called from the consumer thread.
+     * \param [in] proc Function to call for each event
+     */
+    template<typename Proc>
+    void drain(const Proc& proc) {
+      uint64_t r = m_readIndex.load(std::memory_order_relaxed);
+      uint64_t w = m_writeIndex.load(std::memory_order_acquire);
+
+      for (uint64_t i = r; i < w; i++)
+        proc(m_events[i % Capacity]);
+
+      m_readIndex.store(w, std::memory_order_release);
+    }
+
+  private:
+
+    uint32_t                      m_threadId;
+    std::string                   m_threadName;
+
+    alignas(CACHE_LINE_SIZE)
+    std::atomic<uint64_t>         m_writeIndex = { 0ull };
+    alignas(CACHE_LINE_SIZE)
+    std::atomic<uint64_t>         m_readIndex  = { 0ull };
+    std::atomic<uint64_t>         m_dropped    = { 0ull };
+
+    std::vector<DxvkTraceEvent>   m_events;
+
+  };
+
+
+  /**
+   * \brief Trace recorder
+   *
+   * Collects scoped events from all threads that use
+   * the device and periodically writes them to a file
+   * in the Chrome trace event format, which can be
+   * loaded in chrome://tracing or Perfetto.
+   */
+  class DxvkTraceRecorder : public RcObject {
+
+  public:
+
+    DxvkTraceRecorder(
+      const std::string&          fileName);
+
+    ~DxvkTraceRecorder();
+
+    /**
+     * \brief Current time stamp
+     * \returns Nanoseconds since the recorder was created
+     */
+    uint64_t now() const {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        dxvk::high_resolution_clock::now() - m_startTime).count();
+    }
+
+    /**
+     * \brief Records an event for the calling thread
+     *
+     * \param [in] name Event name, must be a literal
+     * \param [in] category Event category, must be a literal
+     * \param [in] start Start time stamp
+     * \param [in] detail Optional detail string
+     */
+    void record(
+      const char*                 name,
+      const char*                 category,
+            uint64_t              start,
+      const char*                 detail);
+
+    /**
+     * \brief Creates a trace recorder if enabled
+     *
+     * Tracing is enabled by setting \c DXVK_TRACE_PATH
+     * or the \c dxvk.tracePath option to a directory.
+     * \param [in] options DXVK options
+     * \returns Trace recorder, or \c nullptr
+     */
+    static Rc<DxvkTraceRecorder> createRecorder(
+      const DxvkOptions&          options);
+
+  private:
+
+    const uint64_t                m_id;
+    const dxvk::high_resolution_clock::time_point m_startTime;
+
+    dxvk::mutex                   m_mutex;
+    dxvk::condition_variable      m_cond;
+    bool                          m_stopped = false;
+
+    std::vector<std::unique_ptr<DxvkTraceBuffer>> m_buffers;
+
+    // Only accessed by the writer
+    std::vector<DxvkTraceBuffer*> m_writerBuffers;
+    std::ofstream                 m_file;
+    bool                          m_firstEntry = true;
+    uint32_t                      m_threadsNamed = 0;
+
+    dxvk::thread                  m_thread;
+
+    DxvkTraceBuffer* getThreadBuffer();
+
+    void writeEvents();
+
+    void writeEntry(
+      const std::string&          entry);
+
+    void runWriter();
+
+    static std::string escape(
+      const char*                 str);
+
+  };
+
+
+  /**
+   * \brief Scoped trace event
+   *
+   * Records the time between construction and destruction
+   * as a single event. Does nothing if tracing is disabled.
+   */
+  class DxvkTraceScope {
+
+  public:
+
+    DxvkTraceScope(
+            DxvkTraceRecorder*    recorder,
+      const char*                 name,
+      const char*                 category)
+    : m_recorder(recorder), m_name(name), m_category(category) {
+      if (unlikely(m_recorder != nullptr))
+        m_start = m_recorder->now();
+    }
+
+    DxvkTraceScope(
+            DxvkTraceRecorder*    recorder,
+      const char*                 name,
+      const char*                 category,
+      const std::string&          detail)
+    : DxvkTraceScope(recorder, name, category) {
+      if (unlikely(m_recorder != nullptr))
+        m_detail = detail;
+    }
+
+    ~DxvkTraceScope() {
+      if (unlikely(m_recorder != nullptr))
+        m_recorder->record(m_name, m_category, m_start, m_detail.c_str());
+    }
+
+    DxvkTraceScope             (const DxvkTraceScope&) = delete;
+    DxvkTraceScope& operator = (const DxvkTraceScope&) = delete;
+
+  private:
+
+    DxvkTraceRecorder*  m_recorder;
+    const char*         m_name;
+    const char*         m_category;
+    uint64_t            m_start = 0;
+    std::string         m_detail;
+
+  };
+
+}
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <utility>
 
 #include "dxvk_hud.h"
 
@@ -46,6 +47,11 @@ namespace dxvk::hud {
     addItem<HudCsThreadItem>("cs", -1, device);
     addItem<HudGpuLoadItem>("gpuload", -1, device);
     addItem<HudCompilerActivityItem>("compiler", -1, device);
+    addItem<HudPipelineStallItem>("stalls", -1, device);
+    addItem<HudTextureUploadItem>("uploads", -1, device);
+#ifdef DXVK_API_TIMERS
+    addItem<HudApiTimeItem>("apitime", -1, device);
+#endif
   }
   
   
@@ -55,7 +61,11 @@ namespace dxvk::hud {
   
   
   void Hud::update() {
+    auto t0 = dxvk::high_resolution_clock::now();
     m_hudItems.update();
+    auto t1 = dxvk::high_resolution_clock::now();
+
+    m_updateTicks += std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
   }
   
   
@@ -63,9 +73,24 @@ namespace dxvk::hud {
     const Rc<DxvkContext>&  ctx,
           VkSurfaceFormatKHR surfaceFormat,
           VkExtent2D        surfaceSize) {
+    auto t0 = dxvk::high_resolution_clock::now();
+
     this->setupRendererState(ctx, surfaceFormat, surfaceSize);
     this->renderHudElements(ctx);
     this->resetRendererState(ctx);
+
+    auto t1 = dxvk::high_resolution_clock::now();
+
+    // Report the HUD's own overhead so that it can be
+    // separated from the numbers the HUD is showing
+    HudRendererStats stats = m_renderer.stats();
+
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+    ticks += std::exchange(m_updateTicks, 0);
+
+    m_device->addStatCtr(DxvkStatCounter::HudDrawCalls,   stats.drawCalls);
+    m_device->addStatCtr(DxvkStatCounter::HudUploadSize,  stats.dataSize);
+    m_device->addStatCtr(DxvkStatCounter::HudRenderTicks, ticks);
   }
   
   
@@ -108,6 +133,7 @@ namespace dxvk::hud {
 
   void Hud::renderHudElements(const Rc<DxvkContext>& ctx) {
     m_hudItems.render(m_renderer);
+    m_renderer.endFrame();
   }
   
 }
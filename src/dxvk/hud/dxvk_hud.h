@@ -85,6 +85,8 @@ namespace dxvk::hud {
 
     float                 m_scale;
 
+    uint64_t              m_updateTicks = 0;
+
     void setupRendererState(
       const Rc<DxvkContext>&  ctx,
             VkSurfaceFormatKHR surfaceFormat,
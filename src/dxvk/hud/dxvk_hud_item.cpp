@@ -679,6 +679,245 @@ namespace dxvk::hud {
   }
 
 
+  HudPipelineStallItem::HudPipelineStallItem(const Rc<DxvkDevice>& device)
+  : m_device(device) {
+
+  }
+
+
+  HudPipelineStallItem::~HudPipelineStallItem() {
+
+  }
+
+
+  void HudPipelineStallItem::update(dxvk::high_resolution_clock::time_point time) {
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate).count();
+
+    if (ticks < UpdateInterval)
+      return;
+
+    DxvkStatCounters counters = m_device->getStatCounters();
+
+    m_totalString = str::format(
+      counters.getCtr(DxvkStatCounter::PipeStallCount), " (",
+      formatDuration(counters.getCtr(DxvkStatCounter::PipeStallTicks)), ")");
+
+    std::vector<DxvkPipelineStall> stalls = m_device->getPipelineStalls();
+    m_stallStrings.clear();
+
+    for (size_t i = 0; i < stalls.size() && i < MaxStallCount; i++) {
+      std::string shaders;
+
+      // Full shader hashes do not fit, the log has those
+      for (const auto& key : stalls[i].shaders) {
+        std::string name = key.toString();
+        shaders += str::format(shaders.empty() ? "" : " ", name.substr(0, name.find('_') + 9));
+      }
+
+      m_stallStrings.push_back({ formatDuration(stalls[i].duration), shaders });
+    }
+
+    m_lastUpdate = time;
+  }
+
+
+  HudPos HudPipelineStallItem::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    position.y += 16.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 1.0f, 0.5f, 0.25f, 1.0f },
+      "Pipe stalls:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_totalString);
+
+    for (const auto& stall : m_stallStrings) {
+      position.y += 20.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 0.5f, 0.25f, 1.0f },
+        stall.first);
+
+      renderer.drawText(16.0f,
+        { position.x + 132.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        stall.second);
+    }
+
+    position.y += 8.0f;
+    return position;
+  }
+
+
+  std::string HudPipelineStallItem::formatDuration(
+          uint64_t          us) {
+    uint64_t ms = us / 100;
+    return str::format(ms / 10, ".", ms % 10, " ms");
+  }
+
+
+  HudApiTimeItem::HudApiTimeItem(const Rc<DxvkDevice>& device)
+  : m_device(device) {
+
+  }
+
+
+  HudApiTimeItem::~HudApiTimeItem() {
+
+  }
+
+
+  void HudApiTimeItem::update(dxvk::high_resolution_clock::time_point time) {
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate).count();
+
+    DxvkStatCounters counters = m_device->getStatCounters();
+    uint64_t frameTotal = 0;
+
+    for (uint32_t i = 0; i < NumTimers; i++) {
+      uint64_t currTicks = counters.getCtr(DxvkStatCounter(
+        uint32_t(DxvkStatCounter::ApiDrawTicks) + i));
+
+      uint64_t frameTicks = currTicks - m_prevTicks[i];
+      m_prevTicks[i] = currTicks;
+
+      m_sumTicks[i] += frameTicks;
+      m_maxTicks[i] = std::max(m_maxTicks[i], frameTicks);
+
+      frameTotal += frameTicks;
+    }
+
+    m_sumTotal += frameTotal;
+    m_maxTotal = std::max(m_maxTotal, frameTotal);
+
+    m_updateCount++;
+
+    if (ticks >= UpdateInterval) {
+      for (uint32_t i = 0; i < NumTimers; i++) {
+        m_timerStrings[i] = str::format(m_sumTicks[i] / m_updateCount, " us (", m_maxTicks[i], " us)");
+
+        m_sumTicks[i] = 0;
+        m_maxTicks[i] = 0;
+      }
+
+      m_totalString = str::format(m_sumTotal / m_updateCount, " us (", m_maxTotal, " us)");
+
+      m_sumTotal = 0;
+      m_maxTotal = 0;
+
+      m_updateCount = 0;
+      m_lastUpdate = time;
+    }
+  }
+
+
+  HudPos HudApiTimeItem::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    static const std::array<const char*, NumTimers> s_labels = {{
+      "Draw:", "Prepare:", "Constants:", "Shaders:",
+      "State:", "Resources:", "Submit:", "Present:",
+    }};
+
+    for (uint32_t i = 0; i < NumTimers; i++) {
+      position.y += i ? 20.0f : 16.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 0.25f, 0.5f, 1.0f, 1.0f },
+        s_labels[i]);
+
+      renderer.drawText(16.0f,
+        { position.x + 132.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        m_timerStrings[i]);
+    }
+
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 1.0f, 1.0f },
+      "API total:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_totalString);
+
+    position.y += 8.0f;
+    return position;
+  }
+
+
+  HudTextureUploadItem::HudTextureUploadItem(const Rc<DxvkDevice>& device)
+  : m_device(device) {
+
+  }
+
+
+  HudTextureUploadItem::~HudTextureUploadItem() {
+
+  }
+
+
+  void HudTextureUploadItem::update(dxvk::high_resolution_clock::time_point time) {
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate).count();
+
+    DxvkStatCounters counters = m_device->getStatCounters();
+    uint64_t currSize = counters.getCtr(DxvkStatCounter::ApiTextureUploadSize);
+
+    uint64_t frameSize = currSize - m_prevSize;
+    m_prevSize = currSize;
+
+    m_sumSize += frameSize;
+    m_maxSize = std::max(m_maxSize, frameSize);
+
+    m_updateCount++;
+
+    if (ticks >= UpdateInterval) {
+      m_uploadString = str::format(formatSize(m_sumSize / m_updateCount),
+        " (", formatSize(m_maxSize), ")");
+
+      m_sumSize = 0;
+      m_maxSize = 0;
+
+      m_updateCount = 0;
+      m_lastUpdate = time;
+    }
+  }
+
+
+  HudPos HudTextureUploadItem::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    position.y += 16.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 1.0f, 1.0f },
+      "Texture uploads:");
+
+    renderer.drawText(16.0f,
+      { position.x + 204.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_uploadString);
+
+    position.y += 8.0f;
+    return position;
+  }
+
+
+  std::string HudTextureUploadItem::formatSize(
+          uint64_t          bytes) {
+    uint64_t kb = bytes >> 10;
+
+    return kb >= 10240
+      ? str::format(kb >> 10, " MB")
+      : str::format(kb, " kB");
+  }
+
+
   HudCompilerActivityItem::HudCompilerActivityItem(const Rc<DxvkDevice>& device)
   : m_device(device) {
 
@@ -7,6 +7,8 @@
 
 #include "../../util/util_time.h"
 
+#include "../dxvk_api_timers.h"
+
 #include "dxvk_hud_renderer.h"
 
 namespace dxvk::hud {
@@ -433,6 +435,129 @@ namespace dxvk::hud {
   };
 
 
+  /**
+   * \brief HUD item to display pipeline compile stalls
+   *
+   * Shows the number of pipelines that had to be compiled
+   * synchronously, as well as the longest stalls seen so
+   * far along with the shaders involved.
+   */
+  class HudPipelineStallItem : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+    constexpr static size_t  MaxStallCount  = 5;
+  public:
+
+    HudPipelineStallItem(const Rc<DxvkDevice>& device);
+
+    ~HudPipelineStallItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    Rc<DxvkDevice> m_device;
+
+    std::string m_totalString;
+
+    std::vector<std::pair<std::string, std::string>> m_stallStrings;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    static std::string formatDuration(
+            uint64_t          us);
+
+  };
+
+
+  /**
+   * \brief HUD item to display API thread CPU time
+   *
+   * Shows the average and peak time per frame spent in
+   * each category of instrumented API calls. Only useful
+   * in builds with \c DXVK_API_TIMERS enabled.
+   */
+  class HudApiTimeItem : public HudItem {
+    constexpr static int64_t  UpdateInterval = 500'000;
+    constexpr static uint32_t NumTimers = uint32_t(DxvkApiTimer::NumTimers);
+  public:
+
+    HudApiTimeItem(const Rc<DxvkDevice>& device);
+
+    ~HudApiTimeItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    Rc<DxvkDevice> m_device;
+
+    std::array<uint64_t, NumTimers> m_prevTicks = { };
+    std::array<uint64_t, NumTimers> m_sumTicks  = { };
+    std::array<uint64_t, NumTimers> m_maxTicks  = { };
+
+    uint64_t m_sumTotal     = 0;
+    uint64_t m_maxTotal     = 0;
+    uint64_t m_updateCount  = 0;
+
+    std::array<std::string, NumTimers> m_timerStrings;
+    std::string m_totalString;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+  };
+
+
+  /**
+   * \brief HUD item to display texture upload sizes
+   *
+   * Shows the average and peak amount of managed
+   * texture data uploaded per frame. Currently only
+   * reported by the D3D9 frontend.
+   */
+  class HudTextureUploadItem : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudTextureUploadItem(const Rc<DxvkDevice>& device);
+
+    ~HudTextureUploadItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    Rc<DxvkDevice> m_device;
+
+    uint64_t m_prevSize     = 0;
+    uint64_t m_sumSize      = 0;
+    uint64_t m_maxSize      = 0;
+    uint64_t m_updateCount  = 0;
+
+    std::string m_uploadString;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    static std::string formatSize(
+            uint64_t          bytes);
+
+  };
+
+
   /**
    * \brief HUD item to display pipeline compiler activity
    */
@@ -9,8 +9,7 @@
 namespace dxvk::hud {
   
   HudRenderer::HudRenderer(const Rc<DxvkDevice>& device)
-  : m_mode          (Mode::RenderNone),
-    m_scale         (1.0f),
+  : m_scale         (1.0f),
     m_surfaceSize   { 0, 0 },
     m_device        (device),
     m_textShaders   (createTextShaders()),
@@ -35,10 +34,18 @@ namespace dxvk::hud {
     if (!m_initialized)
       this->initFontTexture(context);
 
-    m_mode        = Mode::RenderNone;
     m_scale       = scale;
     m_surfaceSize = surfaceSize;
     m_context     = context;
+    m_frameStats  = HudRendererStats();
+  }
+
+
+  void HudRenderer::endFrame() {
+    flushDraws();
+
+    m_stats = m_frameStats;
+    m_context = nullptr;
   }
   
   
@@ -50,29 +57,17 @@ namespace dxvk::hud {
     if (text.empty())
       return;
 
-    beginTextRendering();
+    VkDeviceSize offset = allocDataBuffer(text.size(), 1, 0);
+    std::memcpy(m_dataBuffer->mapPtr(offset), text.data(), text.size());
 
-    // Copy string into string buffer, but extend it to cover a full cache
-    // line to avoid potential CPU performance issues with the upload.
-    std::string textCopy = text;
-    textCopy.resize(align(text.size(), CACHE_LINE_SIZE), ' ');
+    HudTextDrawInfo& draw = m_textDraws.emplace_back();
+    draw.color = color;
+    draw.pos = pos;
+    draw.offset = offset;
+    draw.count = text.size();
+    draw.size = size;
 
-    VkDeviceSize offset = allocDataBuffer(textCopy.size());
-    std::memcpy(m_dataBuffer->mapPtr(offset), textCopy.data(), textCopy.size());
-
-    // Fill in push constants for the next draw
-    HudTextPushConstants pushData;
-    pushData.color = color;
-    pushData.pos = pos;
-    pushData.offset = offset;
-    pushData.size = size;
-    pushData.scale.x = m_scale / std::max(float(m_surfaceSize.width),  1.0f);
-    pushData.scale.y = m_scale / std::max(float(m_surfaceSize.height), 1.0f);
-
-    m_context->pushConstants(0, sizeof(pushData), &pushData);
-
-    // Draw with orignal vertex count
-    m_context->draw(6 * text.size(), 1, 0, 0);
+    m_maxTextLength = std::max(m_maxTextLength, draw.count);
   }
   
   
@@ -81,74 +76,128 @@ namespace dxvk::hud {
           HudPos            size,
           size_t            pointCount,
     const HudGraphPoint*    pointData) {
-    beginGraphRendering();
+    if (!pointCount)
+      return;
 
     VkDeviceSize dataSize = pointCount * sizeof(*pointData);
-    VkDeviceSize offset = allocDataBuffer(dataSize);
+    VkDeviceSize offset = allocDataBuffer(dataSize, 0, 1);
     std::memcpy(m_dataBuffer->mapPtr(offset), pointData, dataSize);
 
-    HudGraphPushConstants pushData;
-    pushData.offset = offset / sizeof(*pointData);
-    pushData.count = pointCount;
-    pushData.pos = pos;
-    pushData.size = size;
+    HudGraphDrawInfo& draw = m_graphDraws.emplace_back();
+    draw.pos = pos;
+    draw.size = size;
+    draw.offset = offset / sizeof(*pointData);
+    draw.count = pointCount;
+  }
+
+
+  void HudRenderer::flushDraws() {
+    if (m_textDraws.empty() && m_graphDraws.empty())
+      return;
+
+    HudPushConstants pushData;
     pushData.scale.x = m_scale / std::max(float(m_surfaceSize.width),  1.0f);
     pushData.scale.y = m_scale / std::max(float(m_surfaceSize.height), 1.0f);
 
     m_context->pushConstants(0, sizeof(pushData), &pushData);
-    m_context->draw(4, 1, 0, 0);
+    m_context->setInputLayout(0, nullptr, 0, nullptr);
+
+    // Graphs are drawn first so that text
+    // can never be covered by a graph
+    flushGraphDraws();
+    flushTextDraws();
   }
-  
-  
-  void HudRenderer::beginTextRendering() {
-    if (m_mode != Mode::RenderText) {
-      m_mode = Mode::RenderText;
-
-      m_context->bindShader(VK_SHADER_STAGE_VERTEX_BIT,   m_textShaders.vert);
-      m_context->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, m_textShaders.frag);
-      
-      m_context->bindResourceBuffer (0, DxvkBufferSlice(m_fontBuffer));
-      m_context->bindResourceView   (1, nullptr, m_dataView);
-      m_context->bindResourceSampler(2, m_fontSampler);
-      m_context->bindResourceView   (2, m_fontView, nullptr);
-      
-      static const DxvkInputAssemblyState iaState = {
-        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
-        VK_FALSE, 0 };
-      
-      m_context->setInputAssemblyState(iaState);
-      m_context->setInputLayout(0, nullptr, 0, nullptr);
-    }
+
+
+  void HudRenderer::flushTextDraws() {
+    if (m_textDraws.empty())
+      return;
+
+    VkDeviceSize drawSize = m_textDraws.size() * sizeof(HudTextDrawInfo);
+    VkDeviceSize drawOffset = allocDrawInfo(drawSize);
+    std::memcpy(m_dataBuffer->mapPtr(drawOffset), m_textDraws.data(), drawSize);
+
+    m_context->bindShader(VK_SHADER_STAGE_VERTEX_BIT,   m_textShaders.vert);
+    m_context->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, m_textShaders.frag);
+
+    m_context->bindResourceBuffer (0, DxvkBufferSlice(m_fontBuffer));
+    m_context->bindResourceView   (1, nullptr, m_dataView);
+    m_context->bindResourceSampler(2, m_fontSampler);
+    m_context->bindResourceView   (2, m_fontView, nullptr);
+    m_context->bindResourceBuffer (3, DxvkBufferSlice(m_dataBuffer, drawOffset, drawSize));
+
+    static const DxvkInputAssemblyState iaState = {
+      VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+      VK_FALSE, 0 };
+
+    m_context->setInputAssemblyState(iaState);
+
+    // Each instance renders one string, vertices past
+    // the end of the string are culled by the shader
+    m_context->draw(6 * m_maxTextLength, m_textDraws.size(), 0, 0);
+
+    m_textDraws.clear();
+    m_maxTextLength = 0;
+    m_frameStats.drawCalls += 1;
   }
 
-  
-  void HudRenderer::beginGraphRendering() {
-    if (m_mode != Mode::RenderGraph) {
-      m_mode = Mode::RenderGraph;
 
-      m_context->bindShader(VK_SHADER_STAGE_VERTEX_BIT,   m_graphShaders.vert);
-      m_context->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, m_graphShaders.frag);
-      
-      m_context->bindResourceBuffer(0, DxvkBufferSlice(m_dataBuffer));
+  void HudRenderer::flushGraphDraws() {
+    if (m_graphDraws.empty())
+      return;
 
-      static const DxvkInputAssemblyState iaState = {
-        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
-        VK_FALSE, 0 };
+    VkDeviceSize drawSize = m_graphDraws.size() * sizeof(HudGraphDrawInfo);
+    VkDeviceSize drawOffset = allocDrawInfo(drawSize);
+    std::memcpy(m_dataBuffer->mapPtr(drawOffset), m_graphDraws.data(), drawSize);
 
-      m_context->setInputAssemblyState(iaState);
-      m_context->setInputLayout(0, nullptr, 0, nullptr);
-    }
+    m_context->bindShader(VK_SHADER_STAGE_VERTEX_BIT,   m_graphShaders.vert);
+    m_context->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, m_graphShaders.frag);
+
+    m_context->bindResourceBuffer(0, DxvkBufferSlice(m_dataBuffer));
+    m_context->bindResourceBuffer(1, DxvkBufferSlice(m_dataBuffer, drawOffset, drawSize));
+
+    static const DxvkInputAssemblyState iaState = {
+      VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
+      VK_FALSE, 0 };
+
+    m_context->setInputAssemblyState(iaState);
+    m_context->draw(4, m_graphDraws.size(), 0, 0);
+
+    m_graphDraws.clear();
+    m_frameStats.drawCalls += 1;
   }
 
 
-  VkDeviceSize HudRenderer::allocDataBuffer(VkDeviceSize size) {
-    if (m_dataOffset + size > m_dataBuffer->info().size) {
+  VkDeviceSize HudRenderer::allocDataBuffer(
+          VkDeviceSize      size,
+          size_t            textDraws,
+          size_t            graphDraws) {
+    // Make sure that the draw parameters of all pending
+    // draws still fit into the buffer after this allocation
+    VkDeviceSize textSize  = (m_textDraws.size()  + textDraws)  * sizeof(HudTextDrawInfo);
+    VkDeviceSize graphSize = (m_graphDraws.size() + graphDraws) * sizeof(HudGraphDrawInfo);
+
+    VkDeviceSize required = align(m_dataOffset + size, DrawInfoAlignment)
+      + align(textSize, DrawInfoAlignment) + align(graphSize, DrawInfoAlignment);
+
+    if (required > m_dataBuffer->info().size) {
+      flushDraws();
+
       m_context->invalidateBuffer(m_dataBuffer, m_dataBuffer->allocSlice());
       m_dataOffset = 0;
     }
     
     VkDeviceSize offset = m_dataOffset;
-    m_dataOffset = align(offset + size, 64);
+    m_dataOffset = align(offset + size, sizeof(HudGraphPoint));
+    m_frameStats.dataSize += size;
+    return offset;
+  }
+
+
+  VkDeviceSize HudRenderer::allocDrawInfo(VkDeviceSize size) {
+    VkDeviceSize offset = align(m_dataOffset, DrawInfoAlignment);
+    m_dataOffset = offset + size;
+    m_frameStats.dataSize += size;
     return offset;
   }
   
@@ -159,9 +208,10 @@ namespace dxvk::hud {
     SpirvCodeBuffer vsCode(hud_text_vert);
     SpirvCodeBuffer fsCode(hud_text_frag);
     
-    const std::array<DxvkResourceSlot, 2> vsResources = {{
+    const std::array<DxvkResourceSlot, 3> vsResources = {{
       { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,       VK_IMAGE_VIEW_TYPE_MAX_ENUM },
       { 1, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, VK_IMAGE_VIEW_TYPE_MAX_ENUM },
+      { 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,       VK_IMAGE_VIEW_TYPE_MAX_ENUM },
     }};
     
     const std::array<DxvkResourceSlot, 1> fsResources = {{
@@ -173,7 +223,7 @@ namespace dxvk::hud {
     vsInfo.resourceSlotCount = vsResources.size();
     vsInfo.resourceSlots = vsResources.data();
     vsInfo.outputMask = 0x3;
-    vsInfo.pushConstSize = sizeof(HudTextPushConstants);
+    vsInfo.pushConstSize = sizeof(HudPushConstants);
     result.vert = new DxvkShader(vsInfo, std::move(vsCode));
 
     DxvkShaderCreateInfo fsInfo;
@@ -194,23 +244,28 @@ namespace dxvk::hud {
     SpirvCodeBuffer vsCode(hud_graph_vert);
     SpirvCodeBuffer fsCode(hud_graph_frag);
     
+    const std::array<DxvkResourceSlot, 1> vsResources = {{
+      { 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_IMAGE_VIEW_TYPE_MAX_ENUM },
+    }};
+
     const std::array<DxvkResourceSlot, 1> fsResources = {{
       { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_IMAGE_VIEW_TYPE_MAX_ENUM },
     }};
 
     DxvkShaderCreateInfo vsInfo;
     vsInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vsInfo.outputMask = 0x1;
-    vsInfo.pushConstSize = sizeof(HudGraphPushConstants);
+    vsInfo.resourceSlotCount = vsResources.size();
+    vsInfo.resourceSlots = vsResources.data();
+    vsInfo.outputMask = 0x3;
+    vsInfo.pushConstSize = sizeof(HudPushConstants);
     result.vert = new DxvkShader(vsInfo, std::move(vsCode));
     
     DxvkShaderCreateInfo fsInfo;
     fsInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
     fsInfo.resourceSlotCount = fsResources.size();
     fsInfo.resourceSlots = fsResources.data();
-    fsInfo.inputMask = 0x1;
+    fsInfo.inputMask = 0x3;
     fsInfo.outputMask = 0x1;
-    fsInfo.pushConstSize = sizeof(HudGraphPushConstants);
     result.frag = new DxvkShader(fsInfo, std::move(fsCode));
     
     return result;
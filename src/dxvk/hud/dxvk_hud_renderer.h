@@ -53,20 +53,45 @@ namespace dxvk::hud {
   /**
    * \brief HUD push constant data
    */
-  struct HudTextPushConstants {
+  struct HudPushConstants {
+    HudPos scale;
+  };
+
+  /**
+   * \brief Text draw parameters
+   *
+   * One entry per string. Text is drawn with one
+   * instance per string, so that all text in a
+   * frame can be rendered with a single draw.
+   */
+  struct HudTextDrawInfo {
     HudColor color;
     HudPos pos;
     uint32_t offset;
+    uint32_t count;
     float size;
-    HudPos scale;
+    uint32_t padding[3];
   };
 
-  struct HudGraphPushConstants {
-    uint32_t offset;
-    uint32_t count;
+  /**
+   * \brief Graph draw parameters
+   *
+   * One entry per graph, indexed by
+   * instance index in the shader.
+   */
+  struct HudGraphDrawInfo {
     HudPos pos;
     HudPos size;
-    HudPos scale;
+    uint32_t offset;
+    uint32_t count;
+  };
+
+  /**
+   * \brief HUD renderer statistics
+   */
+  struct HudRendererStats {
+    uint32_t drawCalls;
+    uint32_t dataSize;
   };
 
   /**
@@ -93,9 +118,12 @@ namespace dxvk::hud {
    * 
    * Can be used by the presentation backend to
    * display performance and driver information.
+   * Text and graphs are batched and drawn with one
+   * instanced draw each at the end of the frame.
    */
   class HudRenderer {
-    constexpr static VkDeviceSize DataBufferSize = 16384;
+    constexpr static VkDeviceSize DataBufferSize    = 65536;
+    constexpr static VkDeviceSize DrawInfoAlignment = 256;
   public:
     
     HudRenderer(
@@ -107,6 +135,14 @@ namespace dxvk::hud {
       const Rc<DxvkContext>&  context,
             VkExtent2D        surfaceSize,
             float             scale);
+
+    /**
+     * \brief Submits all batched draws
+     *
+     * Must be called after all HUD items
+     * for the current frame are rendered.
+     */
+    void endFrame();
     
     void drawText(
             float             size,
@@ -127,21 +163,22 @@ namespace dxvk::hud {
     float scale() const {
       return m_scale;
     }
+
+    /**
+     * \brief Queries statistics for the last frame
+     * \returns Draw count and uploaded data size
+     */
+    HudRendererStats stats() const {
+      return m_stats;
+    }
     
   private:
     
-    enum class Mode {
-      RenderNone,
-      RenderText,
-      RenderGraph,
-    };
-
     struct ShaderPair {
       Rc<DxvkShader> vert;
       Rc<DxvkShader> frag;
     };
     
-    Mode                m_mode;
     float               m_scale;
     VkExtent2D          m_surfaceSize;
 
@@ -160,13 +197,27 @@ namespace dxvk::hud {
     Rc<DxvkImageView>   m_fontView;
     Rc<DxvkSampler>     m_fontSampler;
 
+    std::vector<HudTextDrawInfo>  m_textDraws;
+    std::vector<HudGraphDrawInfo> m_graphDraws;
+    uint32_t                      m_maxTextLength = 0;
+
+    HudRendererStats    m_stats       = { };
+    HudRendererStats    m_frameStats  = { };
+
     bool                m_initialized = false;
 
-    void beginTextRendering();
-    
-    void beginGraphRendering();
+    void flushDraws();
+
+    void flushTextDraws();
+
+    void flushGraphDraws();
+
+    VkDeviceSize allocDataBuffer(
+            VkDeviceSize      size,
+            size_t            textDraws,
+            size_t            graphDraws);
 
-    VkDeviceSize allocDataBuffer(VkDeviceSize size);
+    VkDeviceSize allocDrawInfo(VkDeviceSize size);
 
     ShaderPair createTextShaders();
     ShaderPair createGraphShaders();
@@ -3,6 +3,7 @@
 layout(constant_id = 1225) const bool srgbSwapchain = false;
 
 layout(location = 0) in  vec2 v_coord;
+layout(location = 1) flat in uvec2 v_range;
 layout(location = 0) out vec4 o_color;
 
 struct line_point_t {
@@ -15,15 +16,6 @@ readonly buffer line_data_t {
   line_point_t points[];
 };
 
-layout(push_constant)
-uniform push_data_t {
-  uint offset;
-  uint count;
-  vec2 pos;
-  vec2 size;
-  vec2 scale;
-};
-
 vec3 linearToSrgb(vec3 color) {
   bvec3 isLo = lessThanEqual(color, vec3(0.0031308f));
 
@@ -33,6 +25,9 @@ vec3 linearToSrgb(vec3 color) {
 }
 
 void main() {
+  uint offset = v_range.x;
+  uint count  = v_range.y;
+
   float cx = v_coord.x * float(count);
   float fx = fract(cx);
 
@@ -1,23 +1,35 @@
 #version 450
 
-layout(location = 0) out vec2 o_coord;
+struct graph_draw_t {
+  vec2 pos;
+  vec2 size;
+  uint offset;
+  uint count;
+};
+
+layout(binding = 1, std430)
+readonly buffer graph_draw_buffer_t {
+  graph_draw_t draws[];
+};
 
 layout(push_constant)
 uniform push_data_t {
-  uint offset;
-  uint count;
-  vec2 pos;
-  vec2 size;
   vec2 scale;
 };
 
+layout(location = 0) out vec2 o_coord;
+layout(location = 1) flat out uvec2 o_range;
+
 void main() {
+  graph_draw_t draw = draws[gl_InstanceIndex];
+
   vec2 coord = vec2(
     float(gl_VertexIndex  & 1),
     float(gl_VertexIndex >> 1));
   o_coord = coord;
+  o_range = uvec2(draw.offset, draw.count);
 
-  vec2 pixel_pos = pos + size * coord;
+  vec2 pixel_pos = draw.pos + draw.size * coord;
   vec2 scaled_pos = 2.0f * scale * pixel_pos - 1.0f;
   gl_Position = vec4(scaled_pos, 0.0f, 1.0f);
 }
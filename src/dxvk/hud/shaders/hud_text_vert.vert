@@ -18,14 +18,23 @@ readonly buffer font_buffer_t {
   glyph_info_t glyph_data[];
 };
 
+struct text_draw_t {
+  vec4 color;
+  vec2 pos;
+  uint offset;
+  uint count;
+  float size;
+};
+
 layout(binding = 1) uniform usamplerBuffer text_buffer;
 
+layout(binding = 3, std430)
+readonly buffer text_draw_buffer_t {
+  text_draw_t draws[];
+};
+
 layout(push_constant)
 uniform push_data_t {
-  vec4 text_color;
-  vec2 text_pos;
-  uint text_offset;
-  float text_size;
   vec2 hud_scale;
 };
 
@@ -42,15 +51,25 @@ vec2 unpack_u16(uint v) {
 }
 
 void main() {
-  o_color = text_color;
+  // Each instance renders one string
+  text_draw_t draw = draws[gl_InstanceIndex];
+  o_color = draw.color;
 
   // Compute character index and vertex index for the current
   // character. We'll render two triangles per character.
   uint chr_idx = gl_VertexIndex / 6;
   uint vtx_idx = gl_VertexIndex - 6 * chr_idx;
 
+  // The draw covers the longest string in the batch, emit
+  // degenerate triangles for characters past the end.
+  if (chr_idx >= draw.count) {
+    o_texcoord = vec2(0.0f);
+    gl_Position = vec4(-2.0f, -2.0f, 0.0f, 1.0f);
+    return;
+  }
+
   // Load glyph info based on vertex index
-  uint glyph_idx = texelFetch(text_buffer, int(text_offset + chr_idx)).x;
+  uint glyph_idx = texelFetch(text_buffer, int(draw.offset + chr_idx)).x;
   glyph_info_t glyph_info = glyph_data[glyph_idx];
 
   // Compute texture coordinate from glyph data
@@ -64,11 +83,11 @@ void main() {
   // Compute vertex position. We can easily do this here since our
   // font is a monospace font, otherwise we'd need to preprocess
   // the strings to render in a compute shader.
-  float size_factor = text_size / font_data.size;
+  float size_factor = draw.size / font_data.size;
 
   vec2 local_pos = tex_wh * coord - unpack_u16(glyph_info.packed_origin)
     + vec2(font_data.advance * float(chr_idx), 0.0f);
-  vec2 pixel_pos = text_pos + size_factor * local_pos;
+  vec2 pixel_pos = draw.pos + size_factor * local_pos;
   vec2 scaled_pos = 2.0f * hud_scale * pixel_pos - 1.0f;
 
   gl_Position = vec4(scaled_pos, 0.0f, 1.0f);
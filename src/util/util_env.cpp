@@ -16,6 +16,8 @@
 namespace dxvk::env
 {
 
+  static thread_local std::string g_threadName;
+
   std::string getEnvVar(const char *name)
   {
 #ifdef _WIN32
@@ -115,6 +117,8 @@ namespace dxvk::env
 
   void setThreadName(const std::string &name)
   {
+    g_threadName = name;
+
 #ifdef _WIN32
     using SetThreadDescriptionProc = HRESULT(WINAPI *)(HANDLE, PCWSTR);
 
@@ -137,6 +141,11 @@ namespace dxvk::env
 #endif
   }
 
+  std::string getThreadName()
+  {
+    return g_threadName;
+  }
+
   bool createDirectory(const std::string &path)
   {
 #ifdef _WIN32
@@ -78,6 +78,15 @@ namespace dxvk::env {
    */
   void setThreadName(const std::string& name);
 
+  /**
+   * \brief Gets name of the calling thread
+   *
+   * Returns the name previously set via \ref setThreadName,
+   * or an empty string if the thread was not named by us.
+   * \returns Thread name
+   */
+  std::string getThreadName();
+
   /**
    * \brief Creates a directory
    * 
@@ -0,0 +1,165 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <d3d11.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+// Number of distinct descriptions per state object type. Each
+// thread walks over all of them in its own order, so the loop
+// mostly measures lookups of already existing objects.
+constexpr uint32_t DescCount      = 256;
+constexpr uint32_t IterationCount = 64;
+
+const std::array<uint32_t, 5> g_threadCounts = {{ 1, 2, 4, 8, 16 }};
+
+Com<ID3D11Device> g_d3d11Device;
+
+
+D3D11_SAMPLER_DESC getSamplerDesc(uint32_t index) {
+  D3D11_SAMPLER_DESC desc = { };
+  desc.Filter         = (index & 1) ? D3D11_FILTER_MIN_MAG_MIP_LINEAR : D3D11_FILTER_MIN_MAG_MIP_POINT;
+  desc.AddressU       = D3D11_TEXTURE_ADDRESS_WRAP;
+  desc.AddressV       = D3D11_TEXTURE_ADDRESS_CLAMP;
+  desc.AddressW       = D3D11_TEXTURE_ADDRESS_CLAMP;
+  desc.MipLODBias     = float(index >> 1) / 16.0f;
+  desc.MaxAnisotropy  = 1;
+  desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+  desc.MinLOD         = 0.0f;
+  desc.MaxLOD         = D3D11_FLOAT32_MAX;
+  return desc;
+}
+
+
+D3D11_RASTERIZER_DESC getRasterizerDesc(uint32_t index) {
+  D3D11_RASTERIZER_DESC desc = { };
+  desc.FillMode              = D3D11_FILL_SOLID;
+  desc.CullMode              = D3D11_CULL_MODE(D3D11_CULL_NONE + (index % 3));
+  desc.FrontCounterClockwise = (index >> 2) & 1;
+  desc.DepthBias             = INT(index >> 3);
+  desc.DepthClipEnable       = TRUE;
+  return desc;
+}
+
+
+D3D11_DEPTH_STENCIL_DESC getDepthStencilDesc(uint32_t index) {
+  D3D11_DEPTH_STENCIL_DESC desc = { };
+  desc.DepthEnable      = TRUE;
+  desc.DepthWriteMask   = D3D11_DEPTH_WRITE_MASK(index & 1);
+  desc.DepthFunc        = D3D11_COMPARISON_FUNC(D3D11_COMPARISON_NEVER + ((index >> 1) & 7));
+  desc.StencilEnable    = TRUE;
+  desc.StencilReadMask  = UINT8(index >> 4);
+  desc.StencilWriteMask = 0xff;
+  desc.FrontFace = { D3D11_STENCIL_OP_KEEP, D3D11_STENCIL_OP_KEEP, D3D11_STENCIL_OP_REPLACE, D3D11_COMPARISON_ALWAYS };
+  desc.BackFace  = desc.FrontFace;
+  return desc;
+}
+
+
+D3D11_BLEND_DESC getBlendDesc(uint32_t index) {
+  D3D11_BLEND_DESC desc = { };
+  desc.RenderTarget[0].BlendEnable           = TRUE;
+  desc.RenderTarget[0].SrcBlend              = D3D11_BLEND(D3D11_BLEND_ZERO + (index % 8));
+  desc.RenderTarget[0].DestBlend             = D3D11_BLEND(D3D11_BLEND_ZERO + ((index >> 3) % 8));
+  desc.RenderTarget[0].BlendOp               = D3D11_BLEND_OP_ADD;
+  desc.RenderTarget[0].SrcBlendAlpha         = D3D11_BLEND_ONE;
+  desc.RenderTarget[0].DestBlendAlpha        = D3D11_BLEND_ZERO;
+  desc.RenderTarget[0].BlendOpAlpha          = D3D11_BLEND_OP_ADD;
+  desc.RenderTarget[0].RenderTargetWriteMask = UINT8(0xf >> (index >> 6));
+  return desc;
+}
+
+
+bool createStateObjects(uint32_t thread) {
+  for (uint32_t i = 0; i < DescCount; i++) {
+    uint32_t index = (i * 7 + thread * 31) % DescCount;
+
+    D3D11_SAMPLER_DESC       samplerDesc = getSamplerDesc(index);
+    D3D11_RASTERIZER_DESC    rsDesc      = getRasterizerDesc(index);
+    D3D11_DEPTH_STENCIL_DESC dsDesc      = getDepthStencilDesc(index);
+    D3D11_BLEND_DESC         blendDesc   = getBlendDesc(index);
+
+    Com<ID3D11SamplerState>      samplerState;
+    Com<ID3D11RasterizerState>   rsState;
+    Com<ID3D11DepthStencilState> dsState;
+    Com<ID3D11BlendState>        blendState;
+
+    if (FAILED(g_d3d11Device->CreateSamplerState(&samplerDesc, &samplerState))
+     || FAILED(g_d3d11Device->CreateRasterizerState(&rsDesc, &rsState))
+     || FAILED(g_d3d11Device->CreateDepthStencilState(&dsDesc, &dsState))
+     || FAILED(g_d3d11Device->CreateBlendState(&blendDesc, &blendState)))
+      return false;
+  }
+
+  return true;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  if (FAILED(D3D11CreateDevice(
+        nullptr, D3D_DRIVER_TYPE_HARDWARE,
+        nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+        &g_d3d11Device, nullptr, nullptr))) {
+    std::cerr << "Failed to create D3D11 device" << std::endl;
+    return 1;
+  }
+
+  // Create every object once up front so that all
+  // measured runs take the same lookup path.
+  if (!createStateObjects(0)) {
+    std::cerr << "Failed to create state objects" << std::endl;
+    return 1;
+  }
+
+  for (uint32_t threadCount : g_threadCounts) {
+    std::atomic<bool>     start  = { false };
+    std::atomic<uint32_t> failed = { 0u };
+
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < threadCount; t++) {
+      threads.emplace_back([&start, &failed, t] {
+        while (!start.load())
+          std::this_thread::yield();
+
+        for (uint32_t i = 0; i < IterationCount; i++) {
+          if (!createStateObjects(t))
+            failed += 1;
+        }
+      });
+    }
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    start.store(true);
+
+    for (auto& thread : threads)
+      thread.join();
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    if (failed.load()) {
+      std::cerr << "Failed to create state objects" << std::endl;
+      return 1;
+    }
+
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    double calls = double(threadCount) * IterationCount * DescCount * 4;
+
+    std::cout << threadCount << " threads: " << us << " us, "
+      << (calls / us) << " creates/us total, "
+      << (1000.0 * us / calls * threadCount) << " ns per create per thread" << std::endl;
+  }
+
+  return 0;
+}
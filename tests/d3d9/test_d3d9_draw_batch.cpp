@@ -0,0 +1,193 @@
+#include <array>
+#include <cstring>
+
+#include <d3d9.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+struct Vertex {
+  float    x, y, z, rhw;
+  D3DCOLOR color;
+};
+
+constexpr DWORD VertexFvf = D3DFVF_XYZRHW | D3DFVF_DIFFUSE;
+
+constexpr uint32_t TargetSize = 64;
+constexpr uint32_t CellSize   = 16;
+constexpr uint32_t CellCount  = (TargetSize / CellSize) * (TargetSize / CellSize);
+
+// Dynamic system memory buffers are copied to the same ring buffer
+// that batched indexed draws allocate their arguments from. The
+// sysmem draw uploads just under 1 MiB, the size of that ring, so
+// that the pending batch has to wrap the ring when it gets flushed.
+constexpr uint32_t SysmemVertexCount = ((1u << 20) - 12) / sizeof(Vertex);
+constexpr uint32_t IterationCount    = 64;
+
+const std::array<WORD, 6> g_indices = {{ 0, 1, 2, 2, 1, 3 }};
+
+
+D3DCOLOR getCellColor(uint32_t cell) {
+  return D3DCOLOR_XRGB(0x10 * cell, 0xff - 0x10 * cell, 0x80);
+}
+
+
+D3DCOLOR getSysmemColor(uint32_t iteration) {
+  return D3DCOLOR_XRGB(0xff, iteration * 3, 0x00);
+}
+
+
+void writeQuad(Vertex* pVertices, uint32_t cell, D3DCOLOR color) {
+  float x = float((cell % (TargetSize / CellSize)) * CellSize);
+  float y = float((cell / (TargetSize / CellSize)) * CellSize);
+  float s = float(CellSize);
+
+  pVertices[0] = { x,     y,     0.0f, 1.0f, color };
+  pVertices[1] = { x + s, y,     0.0f, 1.0f, color };
+  pVertices[2] = { x,     y + s, 0.0f, 1.0f, color };
+  pVertices[3] = { x + s, y + s, 0.0f, 1.0f, color };
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  HWND hWnd = CreateWindowExW(0, L"STATIC", L"d3d9-draw-batch",
+    WS_OVERLAPPEDWINDOW, 0, 0, TargetSize, TargetSize, nullptr, nullptr, hInstance, nullptr);
+
+  Com<IDirect3D9> d3d = Direct3DCreate9(D3D_SDK_VERSION);
+
+  if (d3d == nullptr) {
+    std::cerr << "Failed to create D3D9 object" << std::endl;
+    return 1;
+  }
+
+  D3DPRESENT_PARAMETERS params = { };
+  params.BackBufferWidth  = TargetSize;
+  params.BackBufferHeight = TargetSize;
+  params.BackBufferFormat = D3DFMT_X8R8G8B8;
+  params.BackBufferCount  = 1;
+  params.SwapEffect       = D3DSWAPEFFECT_DISCARD;
+  params.hDeviceWindow    = hWnd;
+  params.Windowed         = TRUE;
+
+  Com<IDirect3DDevice9> device;
+
+  if (FAILED(d3d->CreateDevice(D3DADAPTER_DEFAULT, D3DDEVTYPE_HAL, hWnd,
+      D3DCREATE_HARDWARE_VERTEXPROCESSING, &params, &device))) {
+    std::cerr << "Failed to create D3D9 device" << std::endl;
+    return 1;
+  }
+
+  Com<IDirect3DSurface9> target;
+  Com<IDirect3DSurface9> readback;
+
+  Com<IDirect3DVertexBuffer9> cellVertices;
+  Com<IDirect3DIndexBuffer9>  cellIndices;
+
+  Com<IDirect3DVertexBuffer9> sysmemVertices;
+  Com<IDirect3DIndexBuffer9>  sysmemIndices;
+
+  if (FAILED(device->CreateRenderTarget(TargetSize, TargetSize, D3DFMT_X8R8G8B8,
+        D3DMULTISAMPLE_NONE, 0, FALSE, &target, nullptr))
+   || FAILED(device->CreateOffscreenPlainSurface(TargetSize, TargetSize, D3DFMT_X8R8G8B8,
+        D3DPOOL_SYSTEMMEM, &readback, nullptr))
+   || FAILED(device->CreateVertexBuffer(CellCount * 4 * sizeof(Vertex), D3DUSAGE_WRITEONLY,
+        VertexFvf, D3DPOOL_DEFAULT, &cellVertices, nullptr))
+   || FAILED(device->CreateIndexBuffer(sizeof(g_indices), D3DUSAGE_WRITEONLY,
+        D3DFMT_INDEX16, D3DPOOL_DEFAULT, &cellIndices, nullptr))
+   || FAILED(device->CreateVertexBuffer(SysmemVertexCount * sizeof(Vertex), D3DUSAGE_DYNAMIC,
+        VertexFvf, D3DPOOL_SYSTEMMEM, &sysmemVertices, nullptr))
+   || FAILED(device->CreateIndexBuffer(sizeof(g_indices), D3DUSAGE_DYNAMIC,
+        D3DFMT_INDEX16, D3DPOOL_SYSTEMMEM, &sysmemIndices, nullptr))) {
+    std::cerr << "Failed to create resources" << std::endl;
+    return 1;
+  }
+
+  void* data = nullptr;
+
+  cellVertices->Lock(0, 0, &data, 0);
+
+  for (uint32_t i = 0; i < CellCount; i++)
+    writeQuad(reinterpret_cast<Vertex*>(data) + 4 * i, i, getCellColor(i));
+
+  cellVertices->Unlock();
+
+  cellIndices->Lock(0, 0, &data, 0);
+  std::memcpy(data, g_indices.data(), sizeof(g_indices));
+  cellIndices->Unlock();
+
+  sysmemIndices->Lock(0, 0, &data, 0);
+  std::memcpy(data, g_indices.data(), sizeof(g_indices));
+  sysmemIndices->Unlock();
+
+  device->SetRenderTarget(0, target.ptr());
+  device->SetFVF(VertexFvf);
+  device->SetRenderState(D3DRS_ZENABLE, FALSE);
+  device->SetRenderState(D3DRS_LIGHTING, FALSE);
+  device->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+
+  uint32_t failures = 0;
+
+  for (uint32_t it = 0; it < IterationCount; it++) {
+    // At least two batched draws must be pending so
+    // that flushing them allocates indirect arguments
+    uint32_t sysmemCell = 2 + it % (CellCount - 2);
+
+    sysmemVertices->Lock(0, 0, &data, 0);
+    writeQuad(reinterpret_cast<Vertex*>(data), sysmemCell, getSysmemColor(it));
+    sysmemVertices->Unlock();
+
+    device->Clear(0, nullptr, D3DCLEAR_TARGET, 0, 0.0f, 0);
+    device->BeginScene();
+
+    for (uint32_t cell = 0; cell < CellCount; cell++) {
+      if (cell == sysmemCell) {
+        // Vary the upload size slightly around the ring size
+        uint32_t vertexCount = SysmemVertexCount - (it % 4);
+
+        device->SetStreamSource(0, sysmemVertices.ptr(), 0, sizeof(Vertex));
+        device->SetIndices(sysmemIndices.ptr());
+        device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, vertexCount, 0, 2);
+      } else {
+        device->SetStreamSource(0, cellVertices.ptr(), 0, sizeof(Vertex));
+        device->SetIndices(cellIndices.ptr());
+        device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 4 * cell, 0, 4, 0, 2);
+      }
+    }
+
+    device->EndScene();
+    device->GetRenderTargetData(target.ptr(), readback.ptr());
+
+    D3DLOCKED_RECT rect;
+    readback->LockRect(&rect, nullptr, D3DLOCK_READONLY);
+
+    for (uint32_t cell = 0; cell < CellCount; cell++) {
+      uint32_t x = (cell % (TargetSize / CellSize)) * CellSize + CellSize / 2;
+      uint32_t y = (cell / (TargetSize / CellSize)) * CellSize + CellSize / 2;
+
+      D3DCOLOR actual = reinterpret_cast<const D3DCOLOR*>(
+        reinterpret_cast<const uint8_t*>(rect.pBits) + y * rect.Pitch)[x] & 0xffffff;
+      D3DCOLOR expected = (cell == sysmemCell ? getSysmemColor(it) : getCellColor(cell)) & 0xffffff;
+
+      if (actual != expected) {
+        std::cerr << "Iteration " << it << ", cell " << cell << ": got " << std::hex
+          << actual << ", expected " << expected << std::dec << std::endl;
+        failures += 1;
+      }
+    }
+
+    readback->UnlockRect();
+  }
+
+  std::cout << (failures ? "FAILED" : "OK") << ": " << IterationCount
+    << " iterations, " << failures << " mismatching cells" << std::endl;
+
+  DestroyWindow(hWnd);
+  return failures ? 1 : 0;
+}
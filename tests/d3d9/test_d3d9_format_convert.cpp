@@ -0,0 +1,323 @@
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <d3d9.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+// ps_2_0
+//   dcl t0.xy
+//   dcl_2d s0
+//   texld r0, t0, s0
+//   mov oC0, r0
+const std::array<DWORD, 16> g_psCode = {{
+  0xffff0200,
+  0x0200001f, 0x80000000, 0xb0030000,
+  0x0200001f, 0x90000000, 0xa00f0800,
+  0x03000042, 0x800f0000, 0xb0e40000, 0xa0e40800,
+  0x02000001, 0x800f0800, 0x80e40000,
+  0x0000ffff,
+}};
+
+struct Format {
+  D3DFORMAT   format;
+  const char* name;
+  uint32_t    rowsTimesTwo;
+};
+
+// Formats that may be converted on the CPU. Planar formats
+// store the chroma planes in half as many extra rows.
+const std::array<Format, 8> g_formats = {{
+  { D3DFMT_YUY2,                      "YUY2",        2 },
+  { D3DFMT_UYVY,                      "UYVY",        2 },
+  { D3DFORMAT(MAKEFOURCC('N','V','1','2')), "NV12",  3 },
+  { D3DFORMAT(MAKEFOURCC('Y','V','1','2')), "YV12",  3 },
+  { D3DFMT_L6V5U5,                    "L6V5U5",      2 },
+  { D3DFMT_X8L8V8U8,                  "X8L8V8U8",    2 },
+  { D3DFMT_A2W10V10U10,               "A2W10V10U10", 2 },
+  { D3DFORMAT(65),                    "W11V11U10",   2 },
+}};
+
+struct Vertex {
+  float x, y, z, rhw;
+  float u, v;
+};
+
+constexpr uint32_t CompareSize = 64;
+
+const std::array<uint32_t, 3> g_benchSizes     = {{ 64, 256, 1024 }};
+const std::array<uint32_t, 3> g_benchIterations = {{ 256, 64, 16 }};
+
+
+struct Source {
+  Com<IDirect3DTexture9> texture;
+  Com<IDirect3DSurface9> surface;
+  Format                 format;
+  uint32_t               height;
+};
+
+
+Com<IDirect3DDevice9> createDevice(HWND hWnd, int32_t cpuPixels) {
+  // The option is read when the D3D9 object is created, so
+  // write a config file and point DXVK to it beforehand.
+  std::ofstream("d3d9-format-convert.conf")
+    << "d3d9.cpuFormatConversionPixels = " << cpuPixels << std::endl;
+
+  SetEnvironmentVariableA("DXVK_CONFIG_FILE", "d3d9-format-convert.conf");
+
+  Com<IDirect3D9> d3d = Direct3DCreate9(D3D_SDK_VERSION);
+
+  if (d3d == nullptr)
+    return nullptr;
+
+  D3DPRESENT_PARAMETERS params = { };
+  params.BackBufferWidth  = CompareSize;
+  params.BackBufferHeight = CompareSize;
+  params.BackBufferFormat = D3DFMT_X8R8G8B8;
+  params.BackBufferCount  = 1;
+  params.SwapEffect       = D3DSWAPEFFECT_DISCARD;
+  params.hDeviceWindow    = hWnd;
+  params.Windowed         = TRUE;
+
+  Com<IDirect3DDevice9> device;
+
+  if (FAILED(d3d->CreateDevice(D3DADAPTER_DEFAULT, D3DDEVTYPE_HAL, hWnd,
+      D3DCREATE_HARDWARE_VERTEXPROCESSING, &params, &device)))
+    return nullptr;
+
+  Com<IDirect3DPixelShader9> shader;
+  device->CreatePixelShader(g_psCode.data(), &shader);
+  device->SetPixelShader(shader.ptr());
+  device->SetFVF(D3DFVF_XYZRHW | D3DFVF_TEX1);
+  device->SetRenderState(D3DRS_ZENABLE, FALSE);
+  device->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+  device->SetSamplerState(0, D3DSAMP_MINFILTER, D3DTEXF_POINT);
+  device->SetSamplerState(0, D3DSAMP_MAGFILTER, D3DTEXF_POINT);
+  device->SetSamplerState(0, D3DSAMP_MIPFILTER, D3DTEXF_NONE);
+  return device;
+}
+
+
+bool createSource(IDirect3DDevice9* device, const Format& format, uint32_t size, Source& source) {
+  source.format = format;
+  source.height = size;
+
+  // Formats that cannot be sampled are uploaded to
+  // an offscreen surface and blitted instead.
+  if (SUCCEEDED(device->CreateTexture(size, size, 1, 0,
+      format.format, D3DPOOL_MANAGED, &source.texture, nullptr)))
+    return true;
+
+  return SUCCEEDED(device->CreateOffscreenPlainSurface(size, size,
+    format.format, D3DPOOL_DEFAULT, &source.surface, nullptr));
+}
+
+
+void fillSource(Source& source, uint32_t seed) {
+  D3DLOCKED_RECT rect;
+
+  if (source.texture != nullptr)
+    source.texture->LockRect(0, &rect, nullptr, 0);
+  else
+    source.surface->LockRect(&rect, nullptr, 0);
+
+  size_t size = size_t(rect.Pitch) * source.height * source.format.rowsTimesTwo / 2;
+  auto data = reinterpret_cast<uint8_t*>(rect.pBits);
+
+  for (size_t i = 0; i < size; i++) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    data[i] = uint8_t(seed);
+  }
+
+  if (source.texture != nullptr)
+    source.texture->UnlockRect(0);
+  else
+    source.surface->UnlockRect();
+}
+
+
+void touchSource(Source& source) {
+  D3DLOCKED_RECT rect;
+
+  if (source.texture != nullptr) {
+    source.texture->LockRect(0, &rect, nullptr, 0);
+    source.texture->UnlockRect(0);
+  } else {
+    source.surface->LockRect(&rect, nullptr, 0);
+    source.surface->UnlockRect();
+  }
+}
+
+
+void resolveSource(IDirect3DDevice9* device, Source& source, IDirect3DSurface9* target) {
+  if (source.texture == nullptr) {
+    device->StretchRect(source.surface.ptr(), nullptr, target, nullptr, D3DTEXF_POINT);
+    return;
+  }
+
+  float size = float(CompareSize);
+
+  std::array<Vertex, 4> vertices = {{
+    { -0.5f,        -0.5f,        0.0f, 1.0f, 0.0f, 0.0f },
+    { size - 0.5f,  -0.5f,        0.0f, 1.0f, 1.0f, 0.0f },
+    { -0.5f,        size - 0.5f,  0.0f, 1.0f, 0.0f, 1.0f },
+    { size - 0.5f,  size - 0.5f,  0.0f, 1.0f, 1.0f, 1.0f },
+  }};
+
+  device->SetRenderTarget(0, target);
+  device->SetTexture(0, source.texture.ptr());
+  device->BeginScene();
+  device->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, vertices.data(), sizeof(Vertex));
+  device->EndScene();
+  device->SetTexture(0, nullptr);
+}
+
+
+std::vector<uint32_t> readTarget(IDirect3DDevice9* device, IDirect3DSurface9* target, IDirect3DSurface9* readback) {
+  std::vector<uint32_t> result(CompareSize * CompareSize * 4);
+
+  device->GetRenderTargetData(target, readback);
+
+  D3DLOCKED_RECT rect;
+  readback->LockRect(&rect, nullptr, D3DLOCK_READONLY);
+
+  for (uint32_t y = 0; y < CompareSize; y++) {
+    std::memcpy(&result[y * CompareSize * 4],
+      reinterpret_cast<const uint8_t*>(rect.pBits) + y * rect.Pitch,
+      CompareSize * 4 * sizeof(uint32_t));
+  }
+
+  readback->UnlockRect();
+  return result;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  HWND hWnd = CreateWindowExW(0, L"STATIC", L"d3d9-format-convert",
+    WS_OVERLAPPEDWINDOW, 0, 0, CompareSize, CompareSize, nullptr, nullptr, hInstance, nullptr);
+
+  // Mode 0 converts everything with the compute shader,
+  // mode 1 converts everything on the CPU.
+  const std::array<int32_t, 2>     modePixels = {{ 0, 1 << 30 }};
+  const std::array<const char*, 2> modeNames  = {{ "shader", "cpu" }};
+
+  std::array<std::array<std::vector<uint32_t>, g_formats.size()>, 2> results;
+  std::array<std::array<std::array<double, g_benchSizes.size()>, g_formats.size()>, 2> timings = { };
+
+  for (uint32_t mode = 0; mode < 2; mode++) {
+    Com<IDirect3DDevice9> device = createDevice(hWnd, modePixels[mode]);
+
+    if (device == nullptr) {
+      std::cerr << "Failed to create D3D9 device" << std::endl;
+      return 1;
+    }
+
+    Com<IDirect3DSurface9> target;
+    Com<IDirect3DSurface9> readback;
+
+    if (FAILED(device->CreateRenderTarget(CompareSize, CompareSize, D3DFMT_A32B32G32R32F,
+          D3DMULTISAMPLE_NONE, 0, FALSE, &target, nullptr))
+     || FAILED(device->CreateOffscreenPlainSurface(CompareSize, CompareSize, D3DFMT_A32B32G32R32F,
+          D3DPOOL_SYSTEMMEM, &readback, nullptr))) {
+      std::cerr << "Failed to create render target" << std::endl;
+      return 1;
+    }
+
+    for (uint32_t f = 0; f < g_formats.size(); f++) {
+      Source source;
+
+      if (!createSource(device.ptr(), g_formats[f], CompareSize, source)) {
+        std::cout << g_formats[f].name << ": not supported" << std::endl;
+        continue;
+      }
+
+      fillSource(source, 0x9e3779b9u + f);
+      resolveSource(device.ptr(), source, target.ptr());
+      results[mode][f] = readTarget(device.ptr(), target.ptr(), readback.ptr());
+
+      for (uint32_t s = 0; s < g_benchSizes.size(); s++) {
+        Source bench;
+
+        if (!createSource(device.ptr(), g_formats[f], g_benchSizes[s], bench))
+          continue;
+
+        fillSource(bench, 1u + f);
+        resolveSource(device.ptr(), bench, target.ptr());
+        readTarget(device.ptr(), target.ptr(), readback.ptr());
+
+        // Each iteration dirties the image, so every resolve
+        // has to upload and convert it again. The readback at
+        // the end waits for all of the work to complete.
+        auto t0 = std::chrono::high_resolution_clock::now();
+
+        for (uint32_t i = 0; i < g_benchIterations[s]; i++) {
+          touchSource(bench);
+          resolveSource(device.ptr(), bench, target.ptr());
+        }
+
+        readTarget(device.ptr(), target.ptr(), readback.ptr());
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        timings[mode][f][s] = std::chrono::duration<double, std::micro>(t1 - t0).count()
+                            / double(g_benchIterations[s]);
+      }
+    }
+  }
+
+  uint32_t failures = 0;
+
+  for (uint32_t f = 0; f < g_formats.size(); f++) {
+    const auto& a = results[0][f];
+    const auto& b = results[1][f];
+
+    if (a.empty() || b.empty())
+      continue;
+
+    uint32_t mismatches = 0;
+
+    for (size_t i = 0; i < a.size(); i++) {
+      if (a[i] != b[i]) {
+        if (!mismatches) {
+          float fa, fb;
+          std::memcpy(&fa, &a[i], sizeof(fa));
+          std::memcpy(&fb, &b[i], sizeof(fb));
+
+          std::cerr << g_formats[f].name << ": first mismatch at texel " << (i / 4)
+            << " component " << (i % 4) << ": shader " << fa << ", cpu " << fb << std::endl;
+        }
+
+        mismatches += 1;
+      }
+    }
+
+    std::cout << g_formats[f].name << ": " << mismatches << " mismatching components" << std::endl;
+
+    for (uint32_t s = 0; s < g_benchSizes.size(); s++) {
+      std::cout << "  " << g_benchSizes[s] << "x" << g_benchSizes[s] << ": ";
+
+      for (uint32_t mode = 0; mode < 2; mode++)
+        std::cout << modeNames[mode] << " " << timings[mode][f][s] << " us  ";
+
+      std::cout << std::endl;
+    }
+
+    failures += mismatches ? 1 : 0;
+  }
+
+  DestroyWindow(hWnd);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,257 @@
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include <d3d9.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+// vs_1_1
+//   dcl_position v0
+//   dcl_texcoord v1
+//   dp4 oPos.x, v0, c0
+//   dp4 oPos.y, v0, c1
+//   dp4 oPos.z, v0, c2
+//   dp4 oPos.w, v0, c3
+//   mad r0, v1, c4, c5
+//   lit r1, r0
+//   add oT0, r1, r0
+//   mov oD0, r0
+const std::array<DWORD, 44> g_vsCode = {{
+  0xfffe0101,
+  0x0000001f, 0x80000000, 0x900f0000,
+  0x0000001f, 0x80000005, 0x900f0001,
+  0x00000009, 0xc0010000, 0x90e40000, 0xa0e40000,
+  0x00000009, 0xc0020000, 0x90e40000, 0xa0e40001,
+  0x00000009, 0xc0040000, 0x90e40000, 0xa0e40002,
+  0x00000009, 0xc0080000, 0x90e40000, 0xa0e40003,
+  0x00000004, 0x800f0000, 0x90e40001, 0xa0e40004, 0xa0e40005,
+  0x00000010, 0x800f0001, 0x80e40000,
+  0x00000002, 0xe00f0000, 0x80e40001, 0x80e40000,
+  0x00000001, 0xd00f0000, 0x80e40000,
+  0x0000ffff,
+}};
+
+struct SrcVertex {
+  float pos[4];
+  float tex[4];
+};
+
+struct DstVertex {
+  float    pos[4];
+  D3DCOLOR color;
+  float    tex[4];
+};
+
+constexpr DWORD DstFvf = D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1 | D3DFVF_TEXCOORDSIZE4(0);
+
+const std::array<float, 24> g_constants = {{
+  0.5f, 0.0f, 0.0f, 0.25f,
+  0.0f,-0.5f, 0.0f, 0.00f,
+  0.0f, 0.0f, 0.5f, 0.50f,
+  0.0f, 0.0f, 0.0f, 1.00f,
+  1.0f, 1.0f, 1.0f, 1.00f,
+  0.0f, 0.0f, 0.0f, 0.00f,
+}};
+
+// The texture coordinates are fed into lit unchanged, so these
+// cover the cases where x or y are exactly zero, which must not
+// produce a specular term.
+const std::array<SrcVertex, 8> g_vertices = {{
+  {{ -1.0f, -1.0f, 0.0f, 1.0f }, {  0.0f,  0.5f,  0.0f,  2.0f }},
+  {{  1.0f, -1.0f, 0.5f, 1.0f }, {  0.5f,  0.0f,  0.0f,  2.0f }},
+  {{ -1.0f,  1.0f, 1.0f, 1.0f }, {  0.5f,  0.25f, 0.0f,  2.0f }},
+  {{  1.0f,  1.0f, 0.0f, 2.0f }, { -0.5f,  0.5f,  0.0f,  2.0f }},
+  {{  0.0f,  0.0f, 0.0f, 1.0f }, {  0.5f, -0.5f,  0.0f,  2.0f }},
+  {{  0.5f, -0.5f, 0.5f, 4.0f }, {  0.75f, 0.5f,  0.0f,  0.0f }},
+  {{ -0.5f,  0.5f, 0.5f, 1.0f }, {  0.25f, 0.5f,  0.0f, 200.0f }},
+  {{  2.0f,  2.0f, 2.0f, 1.0f }, {  1.5f,  2.0f, -1.0f,  1.0f }},
+}};
+
+
+void computeReference(
+  const SrcVertex&      src,
+  const D3DVIEWPORT9&   viewport,
+        float           (&pos)[4],
+        D3DCOLOR&       color,
+        float           (&tex)[4]) {
+  float clip[4];
+
+  for (uint32_t i = 0; i < 4; i++) {
+    clip[i] = 0.0f;
+
+    for (uint32_t j = 0; j < 4; j++)
+      clip[i] += src.pos[j] * g_constants[4 * i + j];
+  }
+
+  float r0[4];
+
+  for (uint32_t i = 0; i < 4; i++)
+    r0[i] = src.tex[i] * g_constants[16 + i] + g_constants[20 + i];
+
+  // lit only writes the diffuse and specular terms for positive inputs
+  float p = std::max(-127.9961f, std::min(127.9961f, r0[3]));
+
+  float r1[4] = {
+    1.0f,
+    r0[0] > 0.0f ? r0[0] : 0.0f,
+    r0[0] > 0.0f && r0[1] > 0.0f ? std::pow(r0[1], p) : 0.0f,
+    1.0f };
+
+  float rhw = clip[3] != 0.0f ? 1.0f / clip[3] : 1.0f;
+
+  pos[0] = float(viewport.X) + (1.0f + clip[0] * rhw) * float(viewport.Width)  * 0.5f;
+  pos[1] = float(viewport.Y) + (1.0f - clip[1] * rhw) * float(viewport.Height) * 0.5f;
+  pos[2] = viewport.MinZ + clip[2] * rhw * (viewport.MaxZ - viewport.MinZ);
+  pos[3] = rhw;
+
+  for (uint32_t i = 0; i < 4; i++)
+    tex[i] = r1[i] + r0[i];
+
+  auto unorm = [] (float value) {
+    return DWORD(std::lround(std::max(0.0f, std::min(1.0f, value)) * 255.0f));
+  };
+
+  color = D3DCOLOR_ARGB(unorm(r0[3]), unorm(r0[0]), unorm(r0[1]), unorm(r0[2]));
+}
+
+
+bool compareFloat(float a, float b) {
+  return std::abs(a - b) <= 1.0e-4f * std::max(1.0f, std::abs(b));
+}
+
+
+bool compareColor(D3DCOLOR a, D3DCOLOR b) {
+  for (uint32_t i = 0; i < 32; i += 8) {
+    int32_t ca = (a >> i) & 0xff;
+    int32_t cb = (b >> i) & 0xff;
+
+    if (std::abs(ca - cb) > 1)
+      return false;
+  }
+
+  return true;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  HWND hWnd = CreateWindowExW(0, L"STATIC", L"d3d9-process-vertices",
+    WS_OVERLAPPEDWINDOW, 0, 0, 640, 480, nullptr, nullptr, hInstance, nullptr);
+
+  Com<IDirect3D9> d3d = Direct3DCreate9(D3D_SDK_VERSION);
+
+  if (d3d == nullptr) {
+    std::cerr << "Failed to create D3D9 object" << std::endl;
+    return 1;
+  }
+
+  D3DPRESENT_PARAMETERS params = { };
+  params.BackBufferWidth  = 640;
+  params.BackBufferHeight = 480;
+  params.BackBufferFormat = D3DFMT_X8R8G8B8;
+  params.BackBufferCount  = 1;
+  params.SwapEffect       = D3DSWAPEFFECT_DISCARD;
+  params.hDeviceWindow    = hWnd;
+  params.Windowed         = TRUE;
+
+  Com<IDirect3DDevice9> device;
+
+  if (FAILED(d3d->CreateDevice(D3DADAPTER_DEFAULT, D3DDEVTYPE_HAL, hWnd,
+      D3DCREATE_SOFTWARE_VERTEXPROCESSING, &params, &device))) {
+    std::cerr << "Failed to create D3D9 device" << std::endl;
+    return 1;
+  }
+
+  Com<IDirect3DVertexShader9> shader;
+
+  if (FAILED(device->CreateVertexShader(g_vsCode.data(), &shader))) {
+    std::cerr << "Failed to create vertex shader" << std::endl;
+    return 1;
+  }
+
+  std::array<D3DVERTEXELEMENT9, 3> elements = {{
+    { 0,  0, D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0 },
+    { 0, 16, D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+    D3DDECL_END(),
+  }};
+
+  Com<IDirect3DVertexDeclaration9> decl;
+
+  if (FAILED(device->CreateVertexDeclaration(elements.data(), &decl))) {
+    std::cerr << "Failed to create vertex declaration" << std::endl;
+    return 1;
+  }
+
+  Com<IDirect3DVertexBuffer9> srcBuffer;
+  Com<IDirect3DVertexBuffer9> dstBuffer;
+
+  if (FAILED(device->CreateVertexBuffer(sizeof(g_vertices), D3DUSAGE_SOFTWAREPROCESSING,
+      0, D3DPOOL_SYSTEMMEM, &srcBuffer, nullptr))
+   || FAILED(device->CreateVertexBuffer(g_vertices.size() * sizeof(DstVertex), D3DUSAGE_SOFTWAREPROCESSING,
+      DstFvf, D3DPOOL_SYSTEMMEM, &dstBuffer, nullptr))) {
+    std::cerr << "Failed to create vertex buffers" << std::endl;
+    return 1;
+  }
+
+  void* data = nullptr;
+  srcBuffer->Lock(0, 0, &data, 0);
+  std::memcpy(data, g_vertices.data(), sizeof(g_vertices));
+  srcBuffer->Unlock();
+
+  D3DVIEWPORT9 viewport = { 0, 0, 640, 480, 0.0f, 1.0f };
+
+  device->SetViewport(&viewport);
+  device->SetVertexDeclaration(decl.ptr());
+  device->SetVertexShader(shader.ptr());
+  device->SetVertexShaderConstantF(0, g_constants.data(), g_constants.size() / 4);
+  device->SetStreamSource(0, srcBuffer.ptr(), 0, sizeof(SrcVertex));
+
+  if (FAILED(device->ProcessVertices(0, 0, g_vertices.size(), dstBuffer.ptr(), nullptr, D3DPV_DONOTCOPYDATA))) {
+    std::cerr << "ProcessVertices failed" << std::endl;
+    return 1;
+  }
+
+  dstBuffer->Lock(0, 0, &data, D3DLOCK_READONLY);
+
+  std::array<DstVertex, g_vertices.size()> results;
+  std::memcpy(results.data(), data, sizeof(results));
+  dstBuffer->Unlock();
+
+  uint32_t failures = 0;
+
+  for (uint32_t i = 0; i < g_vertices.size(); i++) {
+    DstVertex expected = { };
+    computeReference(g_vertices[i], viewport, expected.pos, expected.color, expected.tex);
+
+    bool match = compareColor(results[i].color, expected.color);
+
+    for (uint32_t j = 0; j < 4; j++) {
+      match &= compareFloat(results[i].pos[j], expected.pos[j]);
+      match &= compareFloat(results[i].tex[j], expected.tex[j]);
+    }
+
+    if (!match) {
+      std::cerr << "Vertex " << i << ": got pos ("
+        << results[i].pos[0] << ", " << results[i].pos[1] << ", " << results[i].pos[2] << ", " << results[i].pos[3]
+        << ") tex (" << results[i].tex[0] << ", " << results[i].tex[1] << ", " << results[i].tex[2] << ", " << results[i].tex[3]
+        << ") color " << std::hex << results[i].color << std::dec << ", expected pos ("
+        << expected.pos[0] << ", " << expected.pos[1] << ", " << expected.pos[2] << ", " << expected.pos[3]
+        << ") tex (" << expected.tex[0] << ", " << expected.tex[1] << ", " << expected.tex[2] << ", " << expected.tex[3]
+        << ") color " << std::hex << expected.color << std::dec << std::endl;
+      failures += 1;
+    }
+  }
+
+  std::cout << (g_vertices.size() - failures) << " / " << g_vertices.size() << " vertices match" << std::endl;
+
+  DestroyWindow(hWnd);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <limits>
+
+#include "../../src/dxbc/dxbc_chunk_shex.h"
+#include "../../src/dxbc/dxbc_header.h"
+#include "../../src/dxbc/dxbc_reader.h"
+
+#include "../../src/util/util_time.h"
+
+#include <shellapi.h>
+#include <windows.h>
+#include <windowsx.h>
+
+namespace dxvk {
+  Logger Logger::s_instance("dxbc-decoder.log");
+}
+
+using namespace dxvk;
+
+constexpr uint32_t IterationCount = 20;
+constexpr uint32_t RoundCount     = 5;
+
+Rc<DxbcShex> loadShexChunk(const std::vector<char>& dxbcCode) {
+  DxbcReader reader(dxbcCode.data(), dxbcCode.size());
+  DxbcHeader header(reader);
+
+  for (uint32_t i = 0; i < header.numChunks(); i++) {
+    auto chunkReader = reader.clone(header.chunkOffset(i));
+    auto tag         = chunkReader.readTag();
+    auto chunkLength = chunkReader.readu32();
+
+    chunkReader = chunkReader.clone(8);
+    chunkReader = chunkReader.resize(chunkLength);
+
+    if ((tag == "SHDR") || (tag == "SHEX"))
+      return new DxbcShex(chunkReader);
+  }
+
+  return nullptr;
+}
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  int     argc = 0;
+  LPWSTR* argv = CommandLineToArgvW(
+    GetCommandLineW(), &argc);
+
+  if (argc < 2) {
+    Logger::err("Usage: dxbc-decoder input.dxbc [input.dxbc ...]");
+    return 1;
+  }
+
+  std::vector<std::vector<char>> files;
+  std::vector<Rc<DxbcShex>>      chunks;
+
+  size_t totalSize = 0;
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::ifstream ifile(str::fromws(argv[i]), std::ios::binary);
+      std::vector<char> dxbcCode(
+        (std::istreambuf_iterator<char>(ifile)),
+        (std::istreambuf_iterator<char>()));
+
+      Rc<DxbcShex> shex = loadShexChunk(dxbcCode);
+
+      if (shex == nullptr) {
+        Logger::warn(str::format("No SHDR/SHEX chunk in ", str::fromws(argv[i])));
+        continue;
+      }
+
+      totalSize += dxbcCode.size();
+      files.push_back(std::move(dxbcCode));
+      chunks.push_back(std::move(shex));
+    }
+  } catch (const DxvkError& e) {
+    Logger::err(e.message());
+    return 1;
+  }
+
+  using namespace std::chrono;
+
+  // Timings are noisy, so alternate between both paths
+  // several times and report the fastest run of each.
+  int64_t legacyUs = std::numeric_limits<int64_t>::max();
+  int64_t streamUs = std::numeric_limits<int64_t>::max();
+
+  size_t legacyCount = 0;
+  size_t streamCount = 0;
+
+  for (uint32_t round = 0; round < RoundCount; round++) {
+    // Decode each shader twice with a fresh decode context,
+    // which is what compiling a shader used to require.
+    auto t0 = dxvk::high_resolution_clock::now();
+    legacyCount = 0;
+
+    for (uint32_t i = 0; i < IterationCount; i++) {
+      for (const auto& shex : chunks) {
+        for (uint32_t pass = 0; pass < 2; pass++) {
+          DxbcDecodeContext decoder;
+          DxbcCodeSlice slice = shex->slice();
+
+          while (!slice.atEnd()) {
+            decoder.decodeInstruction(slice);
+
+            if (decoder.getInstruction().op != DxbcOpcode::CustomData)
+              legacyCount += 1;
+          }
+        }
+      }
+    }
+
+    // Decode each shader once into an instruction stream
+    // and iterate over it twice, as the module does now.
+    auto t1 = dxvk::high_resolution_clock::now();
+    streamCount = 0;
+
+    for (uint32_t i = 0; i < IterationCount; i++) {
+      for (const auto& shex : chunks) {
+        DxbcInstructionStream instructions(shex->slice());
+
+        for (uint32_t pass = 0; pass < 2; pass++) {
+          for (const auto& ins : instructions) {
+            if (ins.op != DxbcOpcode::CustomData)
+              streamCount += 1;
+          }
+        }
+      }
+    }
+
+    auto t2 = dxvk::high_resolution_clock::now();
+
+    legacyUs = std::min<int64_t>(legacyUs, duration_cast<microseconds>(t1 - t0).count());
+    streamUs = std::min<int64_t>(streamUs, duration_cast<microseconds>(t2 - t1).count());
+  }
+
+  if (streamCount != legacyCount)
+    Logger::err("Instruction stream does not match decode context");
+
+  Logger::info(str::format(chunks.size(), " shaders, ", totalSize, " bytes, ",
+    legacyCount / (2 * IterationCount), " instructions"));
+  Logger::info(str::format("Decode context:     ", legacyUs, " us (",
+    legacyUs ? (double(totalSize) * IterationCount / double(legacyUs)) : 0.0, " MB/s)"));
+  Logger::info(str::format("Instruction stream: ", streamUs, " us (",
+    streamUs ? (double(totalSize) * IterationCount / double(streamUs)) : 0.0, " MB/s)"));
+  return 0;
+}